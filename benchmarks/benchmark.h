@@ -0,0 +1,90 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file benchmark.h
+ *  @brief Contains helpers for OCLAlgo benchmarks.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Each benchmark is a separate program. OpenCL platform and device part
+ *  names can be passed as the first and the second command line arguments.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef BENCHMARKS_BENCHMARK_H_
+#define BENCHMARKS_BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+
+namespace oclalgo {
+namespace benchmark {
+
+/** @brief Returns the best time (in seconds) of <i>repeats</i> runs of f. */
+template <typename F>
+double Measure(F f, int repeats = 5) {
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < repeats; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() -
+                                            start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+/** @brief Returns bandwidth in GB/s for <i>bytes</i> processed in time t. */
+inline double Bandwidth(size_t bytes, double t) {
+  return bytes / t * 1e-9;
+}
+
+/** @brief Returns platform part name from command line arguments. */
+inline std::string PlatformName(int argc, char** argv) {
+  return argc > 1 ? argv[1] : "NVIDIA";
+}
+
+/** @brief Returns device part name from command line arguments. */
+inline std::string DeviceName(int argc, char** argv) {
+  return argc > 2 ? argv[2] : "GeForce";
+}
+
+}  // namespace benchmark
+}  // namespace oclalgo
+
+#endif  // BENCHMARKS_BENCHMARK_H_
@@ -0,0 +1,133 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file compressed_transfer.cc
+ *  @brief Benchmark of oclalgo::CompressedTransfer class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Reports effective bandwidth (size of original data divided by transfer
+ *  time including encoding and decoding) of plain and compressed transfers,
+ *  and host encoding throughput.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/compressed_transfer.h"
+#include "inc/oclalgo/queue.h"
+
+using oclalgo::CodecScheme;
+using oclalgo::shared_array;
+namespace bench = oclalgo::benchmark;
+
+const char* SchemeName(CodecScheme scheme) {
+  switch (scheme) {
+    case CodecScheme::Raw:
+      return "raw";
+    case CodecScheme::ZeroBitmap:
+      return "zero-bitmap";
+    case CodecScheme::BitPack:
+      return "bit-pack";
+    default:
+      return "auto";
+  }
+}
+
+void Run(const oclalgo::Queue& queue, const std::string& name,
+         const shared_array<int>& data) {
+  oclalgo::CompressedTransfer transfer(&queue);
+  cl::Buffer buffer = queue.CreateBuffer<int>(data.size(), CL_MEM_READ_WRITE);
+  shared_array<int> result(data.size());
+
+  double plain_up = bench::Measure([&]() { queue.memcpy(buffer, data); });
+  double packed_up = bench::Measure([&]() {
+    transfer.Upload(cl::Buffer(buffer), data).wait();
+  });
+  CodecScheme up_scheme = transfer.last_scheme();
+  size_t up_bytes = transfer.last_bytes();
+  double encode = bench::Measure([&]() {
+    oclalgo::TransferCodec<int>::Encode(data.get_raw(), data.size(),
+                                        up_scheme == CodecScheme::Raw ?
+                                        CodecScheme::BitPack : up_scheme);
+  });
+  double plain_down = bench::Measure([&]() { queue.memcpy(result, buffer); });
+  double packed_down = bench::Measure([&]() {
+    transfer.Download(result, buffer);
+  });
+
+  std::printf("%-12s upload: plain %6.2f GB/s, %-11s %6.2f GB/s "
+              "(ratio %5.2f, host encode %6.2f GB/s)\n", name.c_str(),
+              bench::Bandwidth(data.memsize(), plain_up),
+              SchemeName(up_scheme),
+              bench::Bandwidth(data.memsize(), packed_up),
+              static_cast<double>(data.memsize()) / up_bytes,
+              bench::Bandwidth(data.memsize(), encode));
+  std::printf("%-12s download: plain %6.2f GB/s, %-11s %6.2f GB/s "
+              "(ratio %5.2f)\n", name.c_str(),
+              bench::Bandwidth(data.memsize(), plain_down),
+              SchemeName(transfer.last_scheme()),
+              bench::Bandwidth(data.memsize(), packed_down),
+              static_cast<double>(data.memsize()) / transfer.last_bytes());
+}
+
+int main(int argc, char** argv) {
+  try {
+    oclalgo::Queue queue(bench::PlatformName(argc, argv),
+                         bench::DeviceName(argc, argv));
+    std::cout << "Device: " << queue.DeviceName() << std::endl;
+    size_t size = 16 << 20;
+    shared_array<int> random(size), sparse(size), small(size);
+    std::srand(0);
+    for (size_t i = 0; i < size; ++i) {
+      random[i] = std::rand();
+      sparse[i] = std::rand() % 10 == 0 ? std::rand() : 0;
+      small[i] = std::rand() % 256;
+    }
+    Run(queue, "random", random);
+    Run(queue, "90% zeros", sparse);
+    Run(queue, "8-bit ints", small);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file dispatch.cc
+ *  @brief Benchmark of oclalgo::Dispatcher on products of growing size.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  For square products from 8 to 1024 (the largest size can be passed as
+ *  the third command line argument) measures host operator*, device
+ *  product of host matrices (with transfers) and Dispatcher::Multiply(),
+ *  and prints predicted times and chosen target, which shows the
+ *  crossover size.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/dispatcher.h"
+
+using oclalgo::DMatrix;
+using oclalgo::Matrix;
+using oclalgo::Target;
+namespace bench = oclalgo::benchmark;
+
+int main(int argc, char** argv) {
+  try {
+    int largest = argc > 3 ? std::atoi(argv[3]) : 1024;
+    oclalgo::Queue* queue = oclalgo::MatrixQueue::instance();
+    std::cout << "Device: " << queue->DeviceName() << std::endl;
+    oclalgo::Dispatcher* dispatcher = oclalgo::Dispatcher::instance();
+    oclalgo::DeviceProfile profile = dispatcher->model()->profile();
+    std::printf("upload %.2f GB/s, download %.2f GB/s, launch %.1f us\n",
+                profile.upload_bandwidth * 1e-9,
+                profile.download_bandwidth * 1e-9,
+                profile.launch_latency * 1e6);
+
+    std::printf("%6s %11s %11s %11s %11s %11s %7s\n", "n", "host, ms",
+                "device, ms", "auto, ms", "pred host", "pred dev", "target");
+    for (int n = 8; n <= largest; n *= 2) {
+      Matrix<float> a = oclalgo::internal::CalibrationMatrix(n, n);
+      int repeats = n < 256 ? 10 : 3;
+      double host = bench::Measure([&]() {
+        a * a;
+      }, n <= 512 ? repeats : 1);
+      double device = bench::Measure([&]() {
+        DMatrix<float> da(n, n);
+        da.UpdateData(a);
+        (da * da).get().ToHost();
+      }, repeats);
+      double dispatched = bench::Measure([&]() {
+        dispatcher->Multiply(a, a);
+      }, repeats);
+      oclalgo::OperationCost cost = {1.0 * n * n * n,
+                                     2 * sizeof(float) * n * n,
+                                     sizeof(float) * n * n};
+      oclalgo::CostModel* model = dispatcher->model();
+      Target target = model->Choose(oclalgo::Operation::Multiply, cost);
+      std::printf("%6d %11.3f %11.3f %11.3f %11.3f %11.3f %7s\n", n,
+                  host * 1e3, device * 1e3, dispatched * 1e3,
+                  model->Predict(Target::Host, oclalgo::Operation::Multiply,
+                                 cost) * 1e3,
+                  model->Predict(Target::Device,
+                                 oclalgo::Operation::Multiply, cost) * 1e3,
+                  target == Target::Host ? "host" : "device");
+    }
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
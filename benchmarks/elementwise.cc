@@ -0,0 +1,117 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file elementwise.cc
+ *  @brief Benchmark of elementwise oclalgo::DMatrix operations.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Reports memory bandwidth of 2D matrix_add kernel (one work-item per
+ *  element) and of vectorized grid-stride map_* kernels. OpenCL doesn't
+ *  report theoretical memory bandwidth of device, it can be passed as the
+ *  third command line argument (GB/s) to print percentage of the peak.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/dmatrix.h"
+
+using oclalgo::DMatrix;
+using oclalgo::Matrix;
+namespace bench = oclalgo::benchmark;
+
+namespace {
+
+double peak = 0.0;
+
+template <typename F>
+void Report(const char* name, size_t bytes, F f) {
+  f();  // the first call builds program
+  double gbs = bench::Bandwidth(bytes, bench::Measure(f));
+  if (peak > 0.0)
+    std::printf("  %-22s %7.1f GB/s (%5.1f%% of peak)\n", name, gbs,
+                gbs / peak * 100.0);
+  else
+    std::printf("  %-22s %7.1f GB/s\n", name, gbs);
+}
+
+void Run(int rows, int cols) {
+  Matrix<float> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = static_cast<float>((i + j) % 11);
+  DMatrix<float> a(m), b(m), c(m);
+  size_t bytes = static_cast<size_t>(rows) * cols * sizeof(float);
+  oclalgo::Queue* queue = oclalgo::MatrixQueue::instance();
+  cl::Buffer out = queue->CreateBuffer<float>(rows * cols, CL_MEM_READ_WRITE);
+
+  std::printf("%dx%d float matrices\n", rows, cols);
+  Report("matrix_add (2D)", 3 * bytes, [&]() {
+    oclalgo::Task task = queue->CreateTask("matrix.cl", "matrix_add",
+                                           "-D VAR_TYPE=float", a.buffer(),
+                                           b.buffer(), out);
+    queue->EnqueueTask(std::move(task),
+                       oclalgo::Grid(cl::NDRange(rows, cols))).wait();
+  });
+  Report("scale", 2 * bytes, [&]() { Scale(a, 2.0f).wait(); });
+  Report("add", 3 * bytes, [&]() { (a + b).wait(); });
+  Report("axpy", 3 * bytes, [&]() { Axpy(2.0f, a, b).wait(); });
+  Report("mul", 3 * bytes, [&]() { ElementwiseMul(a, b).wait(); });
+  Report("div", 3 * bytes, [&]() { ElementwiseDiv(a, b).wait(); });
+  Report("max", 3 * bytes, [&]() { ElementwiseMax(a, b).wait(); });
+  Report("muladd", 4 * bytes, [&]() { MulAdd(a, b, c).wait(); });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    peak = argc > 3 ? std::atof(argv[3]) : 0.0;
+    std::cout << "Device: "
+              << oclalgo::MatrixQueue::instance()->DeviceName() << std::endl;
+    Run(1024, 1024);
+    Run(4096, 4097);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
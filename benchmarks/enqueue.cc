@@ -0,0 +1,112 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file enqueue.cc
+ *  @brief Benchmark of task launch overhead of oclalgo::Queue.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Reports host time per launch of small vector_add_value kernel: creating
+ *  new task on every launch and reusing one task, with 0, 1 and 8
+ *  dependencies in wait list.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/queue.h"
+
+using oclalgo::shared_array;
+namespace bench = oclalgo::benchmark;
+
+const int kLaunches = 1000;
+
+template <typename F>
+void Report(const oclalgo::Queue& queue, const char* name, F launch) {
+  double t = bench::Measure([&]() {
+    for (int i = 0; i < kLaunches; ++i)
+      launch();
+    queue.queue().finish();
+  });
+  std::printf("%-28s %8.2f us/launch\n", name, t * 1e6 / kLaunches);
+}
+
+int main(int argc, char** argv) {
+  try {
+    oclalgo::Queue queue(bench::PlatformName(argc, argv),
+                         bench::DeviceName(argc, argv));
+    std::cout << "Device: " << queue.DeviceName() << std::endl;
+    size_t size = 1024;
+    shared_array<int> data(size);
+    for (size_t i = 0; i < size; ++i)
+      data[i] = static_cast<int>(i);
+    oclalgo::BufferArg in = queue.CreateKernelArg(data,
+                                                  oclalgo::ArgType::IN);
+    oclalgo::BufferArg out = queue.CreateKernelArg<int>(
+        size, oclalgo::ArgType::OUT);
+    oclalgo::Grid grid = oclalgo::Grid(cl::NDRange(size));
+    oclalgo::Task task = queue.CreateTask("vector.cl", "vector_add_value", "",
+                                          in, 1, out);
+
+    Report(queue, "create + enqueue", [&]() {
+      queue.EnqueueTask(queue.CreateTask("vector.cl", "vector_add_value", "",
+                                         in, 1, out), grid);
+    });
+    Report(queue, "reused task, 0 deps", [&]() {
+      queue.EnqueueTask(task, grid);
+    });
+    oclalgo::future<oclalgo::TaskResult> prev = queue.EnqueueTask(task, grid);
+    Report(queue, "reused task, 1 dep", [&]() {
+      prev = queue.EnqueueTask(task, grid, prev);
+    });
+    std::vector<oclalgo::future<oclalgo::TaskResult>> deps;
+    for (int i = 0; i < 8; ++i)
+      deps.push_back(queue.EnqueueTask(task, grid));
+    int next = 0;
+    Report(queue, "reused task, 8 deps", [&]() {
+      deps[next] = queue.EnqueueTask(task, grid, deps);
+      next = (next + 1) % 8;
+    });
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file file_loader.cc
+ *  @brief Benchmark of oclalgo::FileLoader class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Writes temporary file of 1 GB (size in MB can be passed as the third
+ *  command line argument) and loads it to DMatrix serially (read() into
+ *  host matrix, then upload) and by FileLoader. The file is mostly in page
+ *  cache after writing, so numbers show overlap of copies rather than disk
+ *  speed unless caches are dropped.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/dmatrix.h"
+#include "inc/oclalgo/file_loader.h"
+
+using oclalgo::DMatrix;
+using oclalgo::Matrix;
+namespace bench = oclalgo::benchmark;
+
+int main(int argc, char** argv) {
+  try {
+    size_t megabytes = argc > 3 ? std::atoi(argv[3]) : 1024;
+    int cols = 1 << 18;  // 1 MB rows
+    int rows = static_cast<int>(megabytes);
+    size_t bytes = static_cast<size_t>(rows) * cols * sizeof(float);
+    oclalgo::Queue* queue = oclalgo::MatrixQueue::instance();
+    std::cout << "Device: " << queue->DeviceName() << std::endl;
+
+    std::string path = "/tmp/oclalgo_file_loader.bin";
+    {
+      std::vector<float> row(cols, 1.0f);
+      FILE* file = std::fopen(path.c_str(), "wb");
+      for (int i = 0; i < rows; ++i)
+        std::fwrite(row.data(), sizeof(float), cols, file);
+      std::fclose(file);
+    }
+
+    DMatrix<float> m(rows, cols);
+    double serial = bench::Measure([&]() {
+      Matrix<float> host(rows, cols);
+      int fd = open(path.c_str(), O_RDONLY);
+      char* ptr = reinterpret_cast<char*>(host.data().get_raw());
+      for (size_t done = 0; done < bytes;) {
+        ssize_t n = read(fd, ptr + done, bytes - done);
+        if (n <= 0) break;
+        done += n;
+      }
+      close(fd);
+      m.UpdateData(host);
+    }, 3);
+
+    oclalgo::FileLoader loader(queue);
+    double loaded = bench::Measure([&]() {
+      loader.Load(path, m).done().wait();
+    }, 3);
+
+    std::printf("%zu MB file\n", megabytes);
+    std::printf("read + upload: %8.3f s (%6.2f GB/s)\n", serial,
+                bench::Bandwidth(bytes, serial));
+    std::printf("FileLoader:    %8.3f s (%6.2f GB/s)\n", loaded,
+                bench::Bandwidth(bytes, loaded));
+    std::remove(path.c_str());
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file fixed_matrix.cc
+ *  @brief Benchmark of small oclalgo::FixedMatrix operations compared with
+ *  oclalgo::Matrix.
+ *  @author Dmitry Senin <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/fixed_matrix.h"
+
+namespace bench = oclalgo::benchmark;
+
+namespace {
+
+template <int N>
+void Run(size_t count) {
+  using oclalgo::FixedMatrix;
+  using oclalgo::Matrix;
+  std::vector<FixedMatrix<float, N, N>> fixed(count), fixed_res(count);
+  std::vector<Matrix<float>> dynamic, dynamic_res(count);
+  for (size_t n = 0; n < count; ++n) {
+    for (int k = 0; k < N * N; ++k)
+      fixed[n].data()[k] = static_cast<float>((n + k) % 7);
+    dynamic.push_back(fixed[n].ToMatrix());
+  }
+
+  double t[4];
+  t[0] = bench::Measure([&]() {
+    for (size_t n = 0; n + 1 < count; ++n) {
+      dynamic_res[n] = dynamic[n] + dynamic[n + 1];
+    }
+  });
+  t[1] = bench::Measure([&]() {
+    for (size_t n = 0; n + 1 < count; ++n) {
+      fixed_res[n] = fixed[n] + fixed[n + 1];
+    }
+  });
+  t[2] = bench::Measure([&]() {
+    for (size_t n = 0; n + 1 < count; ++n) {
+      dynamic_res[n] = dynamic[n] * dynamic[n + 1];
+    }
+  });
+  t[3] = bench::Measure([&]() {
+    for (size_t n = 0; n + 1 < count; ++n) {
+      fixed_res[n] = fixed[n] * fixed[n + 1];
+    }
+  });
+  std::printf("%dx%d   add %7.1f ns %6.1f ns (%5.1fx)   "
+              "mul %7.1f ns %6.1f ns (%5.1fx)\n", N, N,
+              t[0] / count * 1e9, t[1] / count * 1e9, t[0] / t[1],
+              t[2] / count * 1e9, t[3] / count * 1e9, t[2] / t[3]);
+}
+
+}  // namespace
+
+int main() {
+  size_t count = 1 << 18;
+  std::printf("%zu operations, Matrix vs FixedMatrix per operation\n", count);
+  Run<3>(count);
+  Run<4>(count);
+  return 0;
+}
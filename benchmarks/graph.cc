@@ -0,0 +1,144 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file graph.cc
+ *  @brief Benchmark of BFS and PageRank on RMAT graphs.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Generates undirected RMAT graph (a = 0.57, b = c = 0.19) of 2^scale
+ *  vertices and 16 * 2^scale edges (scale 22 by default, can be passed as
+ *  the third command line argument). Reports BFS time and traversed
+ *  undirected edges per second for direction-optimizing and top-down-only
+ *  search and time per PageRank iteration.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/graph.h"
+
+namespace bench = oclalgo::benchmark;
+
+namespace {
+
+typedef std::vector<std::pair<int, int>> Edges;
+
+// RMAT edges: every bit of endpoints is chosen by recursive quadrant
+// probabilities a, b, c, d
+Edges Rmat(int scale, int edge_factor) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const double a = 0.57, b = 0.19, c = 0.19;
+  size_t count = static_cast<size_t>(edge_factor) << scale;
+  Edges edges;
+  edges.reserve(2 * count);
+  for (size_t e = 0; e < count; ++e) {
+    int from = 0, to = 0;
+    for (int bit = 0; bit < scale; ++bit) {
+      double r = uniform(rng);
+      int row = r >= a + b, col = (r >= a && r < a + b) || r >= a + b + c;
+      from |= row << bit;
+      to |= col << bit;
+    }
+    if (from == to) continue;
+    edges.emplace_back(from, to);
+    edges.emplace_back(to, from);
+  }
+  return edges;
+}
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() -
+                                          start;
+  return elapsed.count();
+}
+
+void Bfs(const oclalgo::CsrGraph& graph, oclalgo::BfsDirection direction,
+         const char* name) {
+  oclalgo::BfsOptions options;
+  options.direction = direction;
+  oclalgo::BfsResult result;
+  double t = bench::Measure([&]() {
+    result = oclalgo::BreadthFirstSearch(graph, 0, options);
+  });
+  std::printf("BFS %-9s: %8.3f s, %7.1f MTEPS, depth %d, reached %d "
+              "(%d top-down, %d bottom-up steps)\n", name, t,
+              graph.edges() / 2.0 / t * 1e-6, result.depth, result.reached,
+              result.top_down_steps, result.bottom_up_steps);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    int scale = argc > 3 ? std::atoi(argv[3]) : 22;
+    std::cout << "Device: "
+              << oclalgo::MatrixQueue::instance()->DeviceName() << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    Edges edges = Rmat(scale, 16);
+    oclalgo::CsrGraph graph = oclalgo::CsrGraph::FromEdges(1 << scale,
+                                                           edges);
+    std::printf("RMAT scale %d: %d vertices, %d edges (built in %.1f s)\n",
+                scale, graph.vertices(), graph.edges(), Seconds(start));
+
+    Bfs(graph, oclalgo::BfsDirection::Auto, "auto");
+    Bfs(graph, oclalgo::BfsDirection::TopDown, "top-down");
+
+    oclalgo::PageRankOptions options;
+    options.max_iterations = 20;
+    options.tolerance = 0.0;
+    oclalgo::PageRankResult<float> ranks;
+    double t = bench::Measure([&]() {
+      ranks = oclalgo::PageRank<float>(graph, options);
+    });
+    std::printf("PageRank iteration: %8.3f ms (%7.1f M edges/s)\n",
+                t / ranks.iterations * 1e3,
+                graph.edges() * ranks.iterations / t * 1e-6);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
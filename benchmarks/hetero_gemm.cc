@@ -0,0 +1,98 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file hetero_gemm.cc
+ *  @brief Benchmark of oclalgo::HeteroGemm class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Multiplies square host matrices of size 2048 (size can be passed as the
+ *  third command line argument) on host threads only, on device only (with
+ *  transfers) and by HeteroGemm, then prints how host share converges over
+ *  repeated calls.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/hetero_gemm.h"
+
+using oclalgo::DMatrix;
+using oclalgo::HeteroGemm;
+using oclalgo::Matrix;
+namespace bench = oclalgo::benchmark;
+
+int main(int argc, char** argv) {
+  try {
+    int n = argc > 3 ? std::atoi(argv[3]) : 2048;
+    oclalgo::Queue* queue = oclalgo::MatrixQueue::instance();
+    std::cout << "Device: " << queue->DeviceName() << ", host threads: "
+              << oclalgo::ThreadPool::instance()->size() << std::endl;
+    Matrix<float> a = oclalgo::internal::CalibrationMatrix(n, n);
+    Matrix<float> c(n, n);
+    double flops = 2.0 * n * n * n;
+
+    double host = bench::Measure([&]() {
+      oclalgo::internal::HostGemm(a.data().get_raw(), a.data().get_raw(),
+                                  c.data().get_raw(), n, n, n);
+    }, 3);
+    double device = bench::Measure([&]() {
+      HeteroGemm<float>(0.0).Multiply(a, a).get();
+    }, 3);
+    std::printf("host only:   %8.3f s (%7.1f GFLOPS)\n", host,
+                flops / host * 1e-9);
+    std::printf("device only: %8.3f s (%7.1f GFLOPS)\n", device,
+                flops / device * 1e-9);
+
+    HeteroGemm<float> gemm;
+    for (int i = 0; i < 8; ++i) {
+      double share = gemm.host_share();
+      double t = bench::Measure([&]() {
+        gemm.Multiply(a, a).get();
+      }, 1);
+      std::printf("call %d: host share %.3f, %8.3f s (%7.1f GFLOPS)\n", i,
+                  share, t, flops / t * 1e-9);
+    }
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
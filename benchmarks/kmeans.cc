@@ -0,0 +1,137 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file kmeans.cc
+ *  @brief Benchmark of oclalgo::KMeans clustering.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Clusters 10M x 128 float points (number of points can be passed as the
+ *  third command line argument) into k = 1024 clusters. Reports time of
+ *  k-means++ seeding on a sample and time per Lloyd's iteration with
+ *  GFLOP/s of the distance computation (2 * n * k * d per iteration).
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/kmeans.h"
+
+using oclalgo::DMatrix;
+
+namespace {
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() -
+                                          start;
+  return elapsed.count();
+}
+
+// uploads gaussian blobs around <clusters> random centers by chunks of rows
+void Generate(DMatrix<float>* x, int clusters) {
+  int n = x->rows(), d = x->cols();
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> center(-10.0f, 10.0f);
+  std::normal_distribution<float> noise(0.0f, 1.0f);
+  std::vector<float> centers(static_cast<size_t>(clusters) * d);
+  for (float& c : centers)
+    c = center(rng);
+  int chunk = 1 << 16;
+  std::vector<float> rows(static_cast<size_t>(chunk) * d);
+  cl::CommandQueue queue = oclalgo::MatrixQueue::instance()->queue();
+  for (int first = 0; first < n; first += chunk) {
+    int count = std::min(chunk, n - first);
+    for (int i = 0; i < count; ++i) {
+      const float* c = &centers[static_cast<size_t>(rng() % clusters) * d];
+      for (int j = 0; j < d; ++j)
+        rows[static_cast<size_t>(i) * d + j] = c[j] + noise(rng);
+    }
+    queue.enqueueWriteBuffer(x->buffer(), CL_TRUE,
+                             static_cast<size_t>(first) * d * sizeof(float),
+                             static_cast<size_t>(count) * d * sizeof(float),
+                             rows.data());
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  try {
+    int n = argc > 3 ? std::atoi(argv[3]) : 10000000;
+    int d = 128, k = 1024;
+    std::cout << "Device: "
+              << oclalgo::MatrixQueue::instance()->DeviceName() << std::endl;
+    DMatrix<float> x(n, d);
+    Generate(&x, k);
+
+    oclalgo::KMeansOptions options;
+    options.init_sample = 64 * k;
+    options.max_iterations = 0;
+    oclalgo::KMeans<float> seeding(k, options);
+    auto start = std::chrono::steady_clock::now();
+    seeding.Fit(x);
+    double init = Seconds(start);
+
+    options.max_iterations = 10;
+    options.tolerance = 0.0;
+    oclalgo::KMeans<float> kmeans(k, options);
+    start = std::chrono::steady_clock::now();
+    int iterations = kmeans.Fit(x);
+    double total = Seconds(start);
+    // both Fit() calls include seeding and the final assignment
+    double iteration = std::max(total - init, 0.0) / iterations;
+
+    std::printf("%d x %d points, k = %d\n", n, d, k);
+    std::printf("k-means++ on %d points + assignment: %8.3f s\n",
+                options.init_sample, init);
+    std::printf("Lloyd's iteration: %8.3f s (%7.1f GFLOP/s of distances)\n",
+                iteration, 2.0 * n * k * d / iteration * 1e-9);
+    std::printf("inertia after %d iterations: %g\n", iterations,
+                kmeans.inertia());
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file matrix_mul.cc
+ *  @brief Benchmark of small oclalgo::DMatrix multiplication latency.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Compares matrix_mul kernel with dimensions in parameter buffers (the
+ *  previous DMatrix::operator* approach) with matrix_mul_dims kernel with
+ *  scalar dimensions and with dimensions fixed at compile time. Every
+ *  multiplication is waited, so time is launch latency for small matrices.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <iostream>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/dmatrix.h"
+
+using oclalgo::DMatrix;
+using oclalgo::Matrix;
+namespace bench = oclalgo::benchmark;
+
+namespace {
+
+const int kMuls = 100;
+
+struct ParamBuffer {
+  int rows;
+  int cols;
+  int packing;
+};
+
+// multiplication with dimensions passed through parameter buffers
+void MulParamBuffers(const DMatrix<float>& m1, const DMatrix<float>& m2,
+                     const cl::Buffer& out) {
+  oclalgo::Queue* queue = oclalgo::MatrixQueue::instance();
+  ParamBuffer p1 = { m1.rows(), m1.cols(), oclalgo::ROW };
+  ParamBuffer p2 = { m2.rows(), m2.cols(), oclalgo::ROW };
+  cl::Buffer p1_buf(queue->context(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                    sizeof(p1), &p1);
+  cl::Buffer p2_buf(queue->context(), CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                    sizeof(p2), &p2);
+  int block = oclalgo::MatrixQueue::block_size;
+  char options[128] = {0};
+  std::snprintf(options, sizeof(options), "-D BLOCK_SIZE=%d -D VAR_TYPE=float",
+                block);
+  oclalgo::Task task = queue->CreateTask("matrix.cl", "matrix_mul", options,
+                                         m1.buffer(), p1_buf, m2.buffer(),
+                                         p2_buf, out);
+  int cols = (m2.cols() + block - 1) / block * block;
+  int rows = (m1.rows() + block - 1) / block * block;
+  queue->EnqueueTask(std::move(task), oclalgo::Grid(
+      cl::NDRange(cols, rows), cl::NDRange(block, block))).wait();
+}
+
+void Run(int n) {
+  Matrix<float> m(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      m(i, j) = static_cast<float>((i + j) % 5);
+  DMatrix<float> dm1(m), dm2(m);
+  cl::Buffer out = oclalgo::MatrixQueue::instance()->CreateBuffer<float>(
+      n * n, CL_MEM_READ_WRITE);
+
+  // the first calls build programs
+  MulParamBuffers(dm1, dm2, out);
+  (dm1 * dm2).wait();
+  Multiply(dm1, dm2, oclalgo::KernelShape::Fixed).wait();
+
+  double t[3];
+  t[0] = bench::Measure([&]() {
+    for (int k = 0; k < kMuls; ++k)
+      MulParamBuffers(dm1, dm2, out);
+  });
+  t[1] = bench::Measure([&]() {
+    for (int k = 0; k < kMuls; ++k)
+      (dm1 * dm2).wait();
+  });
+  t[2] = bench::Measure([&]() {
+    for (int k = 0; k < kMuls; ++k)
+      Multiply(dm1, dm2, oclalgo::KernelShape::Fixed).wait();
+  });
+  std::printf("%4dx%-4d  param buffers %8.1f us  scalars %8.1f us (%4.2fx)  "
+              "fixed %8.1f us (%4.2fx)\n", n, n,
+              t[0] / kMuls * 1e6, t[1] / kMuls * 1e6, t[0] / t[1],
+              t[2] / kMuls * 1e6, t[0] / t[2]);
+}
+
+}  // namespace
+
+int main() {
+  try {
+    std::cout << "Device: "
+              << oclalgo::MatrixQueue::instance()->DeviceName() << std::endl;
+    for (int n = 8; n <= 256; n *= 2)
+      Run(n);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file matrix_ops.cc
+ *  @brief Benchmark of host oclalgo::Matrix operations on the thread pool.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Reports time and speedup of elementwise addition, copying and
+ *  transposition from 1 to N threads (N is the number of hardware threads or
+ *  the first command line argument).
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/matrix.h"
+#include "inc/oclalgo/thread_pool.h"
+
+namespace bench = oclalgo::benchmark;
+
+int main(int argc, char** argv) {
+  using oclalgo::Matrix;
+  using oclalgo::ThreadPool;
+  size_t max_threads = argc > 1 ? std::atoi(argv[1]) :
+                                  std::thread::hardware_concurrency();
+  int size = 4096;
+  Matrix<float> m1(size, size), m2(size, size);
+  for (int i = 0; i < size; ++i) {
+    for (int j = 0; j < size; ++j) {
+      m1(i, j) = i + j;
+      m2(i, j) = i - j;
+    }
+  }
+
+  std::vector<size_t> threads;
+  for (size_t t = 1; t < max_threads; t *= 2)
+    threads.push_back(t);
+  threads.push_back(max_threads);
+
+  std::printf("%dx%d float matrices\n", size, size);
+  std::printf("threads      add (ms)      copy (ms)  transpose (ms)\n");
+  double base[3] = {0, 0, 0};
+  for (size_t t : threads) {
+    ThreadPool::instance()->resize(t);
+    double time[3];
+    time[0] = bench::Measure([&]() { Matrix<float> res = m1 + m2; });
+    time[1] = bench::Measure([&]() { Matrix<float> res(m1); });
+    time[2] = bench::Measure([&]() { m1.transpose(); });
+    if (t == 1)
+      for (int k = 0; k < 3; ++k) base[k] = time[k];
+    std::printf("%7zu", t);
+    for (int k = 0; k < 3; ++k)
+      std::printf(" %7.2f (%4.1fx)", time[k] * 1e3, base[k] / time[k]);
+    std::printf("\n");
+  }
+  return 0;
+}
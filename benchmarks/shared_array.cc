@@ -0,0 +1,134 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file shared_array.cc
+ *  @brief Benchmark of oclalgo::shared_array allocation, copying and
+ *  element loops.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Compares shared_array with storage of std::shared_ptr to separately
+ *  allocated data (the previous shared_array layout).
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/shared_array.h"
+
+namespace bench = oclalgo::benchmark;
+
+namespace {
+
+volatile float sink;
+
+// ns per operation
+double PerOp(double t, size_t ops) {
+  return t / ops * 1e9;
+}
+
+}  // namespace
+
+int main() {
+  using oclalgo::RefCount;
+  using oclalgo::shared_array;
+  const size_t ops = 1 << 20;
+  const size_t small = 16;
+
+  std::printf("allocate/free of %zu floats (ns)\n", small);
+  double t = bench::Measure([&]() {
+    for (size_t i = 0; i < ops; ++i) {
+      std::shared_ptr<float> sp(new float[small],
+                                std::default_delete<float[]>());
+      sink = sp.get()[0];
+    }
+  });
+  std::printf("  shared_ptr + new[]     %6.1f\n", PerOp(t, ops));
+  RefCount modes[] = { RefCount::Atomic, RefCount::NonAtomic };
+  const char* names[] = { "atomic", "non-atomic" };
+  for (int m = 0; m < 2; ++m) {
+    t = bench::Measure([&]() {
+      for (size_t i = 0; i < ops; ++i) {
+        shared_array<float> a(small, modes[m]);
+        sink = a[0];
+      }
+    });
+    std::printf("  shared_array %-10s %6.1f\n", names[m], PerOp(t, ops));
+  }
+
+  std::printf("copy of array (ns)\n");
+  std::shared_ptr<float> sp(new float[small], std::default_delete<float[]>());
+  t = bench::Measure([&]() {
+    for (size_t i = 0; i < ops; ++i) {
+      std::shared_ptr<float> copy(sp);
+      sink = copy.get()[0];
+    }
+  });
+  std::printf("  shared_ptr             %6.1f\n", PerOp(t, ops));
+  for (int m = 0; m < 2; ++m) {
+    shared_array<float> a(small, modes[m]);
+    t = bench::Measure([&]() {
+      for (size_t i = 0; i < ops; ++i) {
+        shared_array<float> copy(a);
+        sink = copy[0];
+      }
+    });
+    std::printf("  shared_array %-10s %6.1f\n", names[m], PerOp(t, ops));
+  }
+
+  const size_t size = 1 << 22;
+  std::printf("sum of %zu floats (GB/s)\n", size);
+  shared_array<float> a(size);
+  std::iota(a.begin(), a.end(), 0.0f);
+  t = bench::Measure([&]() {
+    std::shared_ptr<float> p = a.get();
+    float sum = 0;
+    for (size_t i = 0; i < size; ++i) sum += p.get()[i];
+    sink = sum;
+  });
+  std::printf("  get().get()[i]         %6.2f\n",
+              bench::Bandwidth(a.memsize(), t));
+  t = bench::Measure([&]() {
+    sink = std::accumulate(a.begin(), a.end(), 0.0f);
+  });
+  std::printf("  begin()/end()          %6.2f\n",
+              bench::Bandwidth(a.memsize(), t));
+  return 0;
+}
@@ -0,0 +1,125 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file text_codec.cc
+ *  @brief Benchmark of matrix text parsing and formatting.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Formats matrix of 4M floats (number of rows in thousands can be passed
+ *  as the third command line argument) by operator<< and by WriteText(),
+ *  then parses it by std::istream and by ParseText()/ReadText(). Speeds
+ *  are in MB/s of text.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "benchmarks/benchmark.h"
+#include "inc/oclalgo/text_codec.h"
+
+using oclalgo::Matrix;
+namespace bench = oclalgo::benchmark;
+
+namespace {
+
+void Report(const char* name, size_t bytes, double t) {
+  std::printf("%-24s %8.3f s (%8.1f MB/s)\n", name, t, bytes / t * 1e-6);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rows = (argc > 3 ? std::atoi(argv[3]) : 256) * 1000;
+  const int cols = 16;
+  Matrix<float> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = (i * 7919 + j * 104729) % 1000003 * 1e-3F - 500.0F;
+  std::string path = "/tmp/oclalgo_text_codec.csv";
+
+  double stream_write = bench::Measure([&]() {
+    std::ofstream out(path);
+    out << m;
+  }, 3);
+  std::ifstream in(path);
+  std::string stream_text((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+  Report("operator<<", stream_text.size(), stream_write);
+
+  double stream_read = bench::Measure([&]() {
+    std::istringstream text(stream_text);
+    Matrix<float> parsed(rows, cols);
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j)
+        text >> parsed(i, j);
+  }, 3);
+  Report("operator>>", stream_text.size(), stream_read);
+
+  std::string text;
+  double format = bench::Measure([&]() {
+    text = oclalgo::FormatText(m);
+  }, 3);
+  Report("FormatText", text.size(), format);
+
+  double write = bench::Measure([&]() {
+    int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    oclalgo::WriteText(fd, m);
+    close(fd);
+  }, 3);
+  Report("WriteText", text.size(), write);
+
+  double parse = bench::Measure([&]() {
+    oclalgo::ParseText<float>(text);
+  }, 3);
+  Report("ParseText", text.size(), parse);
+
+  double read = bench::Measure([&]() {
+    int fd = open(path.c_str(), O_RDONLY);
+    oclalgo::ReadText<float>(fd);
+    close(fd);
+  }, 3);
+  Report("ReadText", text.size(), read);
+  std::remove(path.c_str());
+  return 0;
+}
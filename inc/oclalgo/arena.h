@@ -0,0 +1,206 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file arena.h
+ *  @brief Contains oclalgo::ScopedArena class (host arena for temporaries).
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Arena is active in the thread which created it until its destruction.
+ *  Arrays allocated from arena must not outlive it: results of operators and
+ *  matrices transposed in arena scope should be copied (not moved) to
+ *  matrices which outlive the arena. Debug builds check it by assertion.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_ARENA_H_
+#define INC_OCLALGO_ARENA_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <oclalgo/shared_array.h>
+
+namespace oclalgo {
+
+/*!
+ * @brief Scoped bump allocator for short-lived host arrays.
+ *
+ * While arena exists, host matrix operators allocate results from it (see
+ * AllocateArray()). Both array data and shared pointer control blocks are
+ * placed in arena, so allocation is a pointer increment, and all memory is
+ * released at once by destructor. Arenas can be nested: the last created
+ * arena is active.
+ *
+ * <i>Code example:</i>
+ * @code{.cpp}
+ * Matrix<float> c;
+ * {
+ *   ScopedArena arena;
+ *   Matrix<float> tmp = a + b;  // allocated from arena
+ *   Matrix<float> res = tmp * d;
+ *   c = res;                    // copy assignment allocates on heap
+ * }                             // all temporaries are released here
+ * @endcode
+ */
+class ScopedArena {
+ public:
+  /** @brief Creates arena and makes it active in the calling thread. */
+  explicit ScopedArena(size_t block_size = 1 << 20);
+
+  ScopedArena(const ScopedArena&) = delete;
+  ScopedArena& operator=(const ScopedArena&) = delete;
+
+  /** @brief Releases all blocks and activates the previous arena. */
+  virtual ~ScopedArena();
+
+  /** @brief Returns active arena of the calling thread (or nullptr). */
+  static ScopedArena* active() noexcept;
+
+  /** @brief Allocates <i>bytes</i> aligned to <i>align</i> bytes. */
+  void* Allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+  /*!
+   * @brief Makes all memory available again without releasing blocks.
+   *
+   * Arrays allocated before must not be used after reset.
+   */
+  void Reset() noexcept;
+
+  /** @brief Creates shared array placed in arena. */
+  template <typename T>
+  shared_array<T> MakeArray(size_t size);
+
+  /** @brief Returns number of bytes allocated from arena. */
+  size_t used_bytes() const noexcept { return used_; }
+  /** @brief Returns number of bytes reserved by arena blocks. */
+  size_t reserved_bytes() const noexcept { return reserved_; }
+  /** @brief Returns number of arrays allocated from arena and still alive. */
+  size_t live_arrays() const noexcept { return live_; }
+
+  /*!
+   * @brief Allocator placing memory in arena.
+   *
+   * Deallocation doesn't free memory, it only counts live allocations for
+   * debug checks.
+   */
+  template <typename U>
+  struct Allocator {
+    typedef U value_type;
+
+    explicit Allocator(ScopedArena* arena) noexcept : arena(arena) {}
+    template <typename V>
+    Allocator(const Allocator<V>& a) noexcept : arena(a.arena) {}
+
+    U* allocate(size_t n) {
+      U* ptr = static_cast<U*>(arena->Allocate(n * sizeof(U), alignof(U)));
+      ++arena->live_;
+      return ptr;
+    }
+    void deallocate(U*, size_t) noexcept { --arena->live_; }
+
+    template <typename V>
+    bool operator==(const Allocator<V>& a) const noexcept {
+      return arena == a.arena;
+    }
+    template <typename V>
+    bool operator!=(const Allocator<V>& a) const noexcept {
+      return arena != a.arena;
+    }
+
+    ScopedArena* arena;
+  };
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+
+  void AddBlock(size_t min_size);
+
+  ScopedArena* previous_;
+  std::vector<Block> blocks_;
+  size_t block_size_;
+  size_t current_;  // index of the current block
+  size_t offset_;   // offset in the current block
+  size_t used_;
+  size_t reserved_;
+  size_t live_;
+};
+
+template <typename T>
+shared_array<T> ScopedArena::MakeArray(size_t size) {
+  static_assert(std::is_trivially_destructible<T>::value,
+                "arena arrays support only trivially destructible types");
+  return shared_array<T>(size, Allocator<T>(this));
+}
+
+namespace internal {
+
+template <typename T>
+shared_array<T> AllocateArray(size_t size, std::true_type) {
+  ScopedArena* arena = ScopedArena::active();
+  return arena ? arena->MakeArray<T>(size) : shared_array<T>(size);
+}
+
+template <typename T>
+shared_array<T> AllocateArray(size_t size, std::false_type) {
+  return shared_array<T>(size);
+}
+
+}  // namespace internal
+
+/*!
+ * @brief Allocates array for temporary result from active arena of the
+ * calling thread, or from heap if there is no active arena (or elements
+ * aren't trivially destructible).
+ */
+template <typename T>
+shared_array<T> AllocateArray(size_t size) {
+  return internal::AllocateArray<T>(
+      size, std::integral_constant<bool,
+                std::is_trivially_destructible<T>::value>());
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_ARENA_H_
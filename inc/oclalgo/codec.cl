@@ -0,0 +1,129 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// encoded formats are described in transfer_codec.h
+
+// signed integers are packed relative to signed minimum (-D SIGNED_WORD)
+#ifdef SIGNED_WORD
+typedef int word_t;
+#define WORD_MIN INT_MIN
+#define WORD_MAX INT_MAX
+#else
+typedef uint word_t;
+#define WORD_MIN 0
+#define WORD_MAX UINT_MAX
+#endif  // SIGNED_WORD
+
+__kernel void decode_zero_bitmap(__global const uint* encoded, uint groups,
+                                 uint size, __global uint* out) {
+  uint g = get_global_id(0);
+  if (g >= groups) return;
+  uint bits = encoded[g];
+  uint k = encoded[groups + g];
+  __global const uint* values = encoded + 2 * groups;
+  uint base = g * 32;
+  uint count = min(32u, size - base);
+  for (uint b = 0; b < count; ++b) {
+    uint nonzero = (bits >> b) & 1;
+    out[base + b] = nonzero ? values[k] : 0;
+    k += nonzero;
+  }
+}
+
+__kernel void decode_bitpack(__global const uint* encoded, uint size,
+                             __global uint* out) {
+  uint i = get_global_id(0);
+  if (i >= size) return;
+  uint base = encoded[0];
+  uint width = encoded[1];
+  __global const uint* packed = encoded + 2;
+  ulong bit = (ulong)i * width;
+  uint word = (uint)(bit >> 5);
+  uint shift = (uint)(bit & 31);
+  uint value = packed[word] >> shift;
+  if (shift + width > 32) value |= packed[word + 1] << (32 - shift);
+  uint mask = width == 32 ? 0xFFFFFFFFu : (1u << width) - 1;
+  out[i] = (value & mask) + base;
+}
+
+// local size should be a power of two
+__kernel void minmax_partial(__global const word_t* in, uint size,
+                             __global word_t* partial, __local word_t* lmin,
+                             __local word_t* lmax) {
+  uint lid = get_local_id(0);
+  word_t vmin = WORD_MAX;
+  word_t vmax = WORD_MIN;
+  for (uint i = get_global_id(0); i < size; i += get_global_size(0)) {
+    vmin = min(vmin, in[i]);
+    vmax = max(vmax, in[i]);
+  }
+  lmin[lid] = vmin;
+  lmax[lid] = vmax;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (uint s = get_local_size(0) / 2; s > 0; s >>= 1) {
+    if (lid < s) {
+      lmin[lid] = min(lmin[lid], lmin[lid + s]);
+      lmax[lid] = max(lmax[lid], lmax[lid + s]);
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  if (lid == 0) {
+    partial[2 * get_group_id(0)] = lmin[0];
+    partial[2 * get_group_id(0) + 1] = lmax[0];
+  }
+}
+
+// one work-item builds one packed word (width > 0)
+__kernel void encode_bitpack(__global const word_t* in, uint size,
+                             word_t base, uint width, uint words,
+                             __global uint* packed) {
+  uint w = get_global_id(0);
+  if (w >= words) return;
+  ulong first_bit = (ulong)w * 32;
+  ulong first = first_bit / width;
+  ulong last = min((first_bit + 31) / width, (ulong)size - 1);
+  uint word = 0;
+  for (ulong i = first; i <= last && i < size; ++i) {
+    uint value = (uint)in[i] - (uint)base;
+    long offset = (long)(i * width) - (long)first_bit;
+    word |= offset >= 0 ? value << offset : value >> (-offset);
+  }
+  packed[w] = word;
+}
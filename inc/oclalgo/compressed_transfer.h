@@ -0,0 +1,251 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file compressed_transfer.h
+ *  @brief Contains oclalgo::CompressedTransfer class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Uploads are encoded on host (see transfer_codec.h) and decoded on device by
+ *  kernels from codec.cl. Downloads are packed on device by BitPack scheme
+ *  and unpacked on host.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_COMPRESSED_TRANSFER_H_
+#define INC_OCLALGO_COMPRESSED_TRANSFER_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include <oclalgo/queue.h>
+#include <oclalgo/transfer_codec.h>
+
+namespace oclalgo {
+
+/*!
+ * @brief Class for host-device transfers of encoded data.
+ *
+ * Can be used instead of Queue::memcpy() for arrays which are mostly zeros or
+ * small integers, when bus bandwidth is a bottleneck. Elements should be
+ * 32-bit (int, unsigned int, float).
+ */
+class CompressedTransfer {
+ public:
+  /** @brief Maximal bit width of packed data worth downloading. */
+  constexpr static unsigned max_download_width = 24;
+
+  explicit CompressedTransfer(const Queue* queue)
+      : queue_(queue),
+        last_scheme_(CodecScheme::Raw),
+        last_bytes_(0) {
+  }
+
+  /*!
+   * @brief Copies host memory to cl::Buffer object (asynchronously).
+   *
+   * Data is encoded on host synchronously, encoded data is copied and decoded
+   * to <i>buffer</i> asynchronously. If <i>scheme</i> is CodecScheme::Auto,
+   * it's chosen by sample of data. Raw data is copied by Queue::memcpy(), so
+   * <i>array</i> should be valid until the end of transfer.
+   */
+  template <typename T>
+  oclalgo::future<cl::Buffer> Upload(cl::Buffer&& buffer,
+                                     const shared_array<T>& array,
+                                     CodecScheme scheme = CodecScheme::Auto);
+
+  /*!
+   * @brief Copies cl::Buffer object to host memory (synchronously).
+   *
+   * Data is packed on device by BitPack scheme if its bit width doesn't exceed
+   * max_download_width, otherwise raw data is copied. Any <i>scheme</i> except
+   * CodecScheme::Raw enables packing.
+   */
+  template <typename T>
+  shared_array<T> Download(const shared_array<T>& array,
+                           const cl::Buffer& buffer,
+                           CodecScheme scheme = CodecScheme::Auto);
+
+  /** @brief Returns scheme used by the last transfer. */
+  CodecScheme last_scheme() const noexcept { return last_scheme_; }
+  /** @brief Returns number of bytes sent over bus by the last transfer. */
+  size_t last_bytes() const noexcept { return last_bytes_; }
+
+ private:
+  template <typename T>
+  static std::string Options() {
+    return std::is_signed<typename TransferCodec<T>::Word>::value ?
+        "-D SIGNED_WORD" : "";
+  }
+
+  static size_t RoundUp(size_t size, size_t block) {
+    return (size + block - 1) / block * block;
+  }
+
+  const Queue* queue_;
+  CodecScheme last_scheme_;
+  size_t last_bytes_;
+};
+
+template <typename T>
+oclalgo::future<cl::Buffer> CompressedTransfer::Upload(
+    cl::Buffer&& buffer, const shared_array<T>& array, CodecScheme scheme) {
+  if (array.size() > std::numeric_limits<cl_uint>::max())
+    scheme = CodecScheme::Raw;
+  else if (scheme == CodecScheme::Auto)
+    scheme = TransferCodec<T>::Choose(array.get_raw(), array.size());
+  last_scheme_ = scheme;
+  if (scheme == CodecScheme::Raw) {
+    last_bytes_ = array.memsize();
+    return queue_->memcpy(std::move(buffer), array, BlockingType::Unblock);
+  }
+
+  shared_array<uint32_t> encoded = TransferCodec<T>::Encode(array.get_raw(),
+                                                            array.size(),
+                                                            scheme);
+  last_bytes_ = encoded.memsize();
+  cl::Buffer staging = queue_->CreateBuffer<uint32_t>(encoded.size(),
+                                                      CL_MEM_READ_ONLY,
+                                                      "CompressedTransfer");
+  queue_->memcpy(staging, encoded);
+
+  BufferArg in_arg(staging, ArgType::IN);
+  BufferArg out_arg(buffer, ArgType::OUT);
+  KernelArg<cl_uint> size_arg(static_cast<cl_uint>(array.size()), ArgType::IN);
+  size_t groups = TransferCodec<T>::Groups(array.size());
+  KernelArg<cl_uint> groups_arg(static_cast<cl_uint>(groups), ArgType::IN);
+  bool bitmap = scheme == CodecScheme::ZeroBitmap;
+  Task task = bitmap ?
+      queue_->CreateTask("codec.cl", "decode_zero_bitmap", "", in_arg,
+                         groups_arg, size_arg, out_arg) :
+      queue_->CreateTask("codec.cl", "decode_bitpack", "", in_arg, size_arg,
+                         out_arg);
+  size_t global = bitmap ? groups : array.size();
+  auto future = queue_->EnqueueTask(task, Grid(cl::NDRange(RoundUp(global,
+                                                                    64))));
+  // staging buffer is released by OpenCL after the end of decoding
+  return oclalgo::future<cl::Buffer>(std::move(buffer), future.event());
+}
+
+template <typename T>
+shared_array<T> CompressedTransfer::Download(const shared_array<T>& array,
+                                             const cl::Buffer& buffer,
+                                             CodecScheme scheme) {
+  typedef typename TransferCodec<T>::Word Word;
+  size_t size = array.size();
+  if (scheme == CodecScheme::Raw || size == 0 ||
+      size > std::numeric_limits<cl_uint>::max()) {
+    last_scheme_ = CodecScheme::Raw;
+    last_bytes_ = array.memsize();
+    return queue_->memcpy(array, buffer);
+  }
+
+  // partial minimums and maximums are found by work-groups on device
+  size_t max_local = queue_->device().getInfo<CL_DEVICE_MAX_WORK_GROUP_SIZE>();
+  size_t local = 1;
+  while (local * 2 <= std::min<size_t>(256, max_local)) local *= 2;
+  size_t groups = std::min<size_t>(64, (size + local - 1) / local);
+  BufferArg in_arg(buffer, ArgType::IN);
+  KernelArg<cl_uint> size_arg(static_cast<cl_uint>(size), ArgType::IN);
+  BufferArg partial_arg(queue_->CreateBuffer<Word>(2 * groups,
+                                                   CL_MEM_WRITE_ONLY,
+                                                   "CompressedTransfer"),
+                        ArgType::OUT);
+  LocalArg lmin_arg(queue_->CreateLocalBuffer<Word>(local), ArgType::IN);
+  LocalArg lmax_arg(queue_->CreateLocalBuffer<Word>(local), ArgType::IN);
+  Task minmax_task = queue_->CreateTask("codec.cl", "minmax_partial",
+                                        Options<T>(), in_arg, size_arg,
+                                        partial_arg, lmin_arg, lmax_arg);
+  auto minmax_future = queue_->EnqueueTask(minmax_task,
+                                           Grid(cl::NDRange(groups * local),
+                                                cl::NDRange(local)));
+  cl::Buffer partial = minmax_future.get()[0];
+  shared_array<Word> minmax(2 * groups);
+  queue_->memcpy(minmax, partial);
+  Word min = minmax[0], max = minmax[1];
+  for (size_t g = 1; g < groups; ++g) {
+    min = std::min(min, minmax[2 * g]);
+    max = std::max(max, minmax[2 * g + 1]);
+  }
+
+  unsigned width = TransferCodec<T>::BitWidth(min, max);
+  if (width > max_download_width) {
+    last_scheme_ = CodecScheme::Raw;
+    last_bytes_ = array.memsize() + minmax.memsize();
+    return queue_->memcpy(array, buffer);
+  }
+
+  shared_array<uint32_t> encoded(TransferCodec<T>::PackedSize(size, width));
+  std::fill(encoded.get_raw(), encoded.get_raw() + encoded.size(), 0);
+  encoded[0] = static_cast<uint32_t>(min);
+  encoded[1] = width;
+  size_t words = (static_cast<uint64_t>(size) * width + 31) / 32;
+  if (words > 0) {
+    KernelArg<Word> min_arg(min, ArgType::IN);
+    KernelArg<cl_uint> width_arg(width, ArgType::IN);
+    KernelArg<cl_uint> words_arg(static_cast<cl_uint>(words), ArgType::IN);
+    BufferArg packed_arg(queue_->CreateBuffer<uint32_t>(words,
+                                                        CL_MEM_WRITE_ONLY,
+                                                        "CompressedTransfer"),
+                         ArgType::OUT);
+    Task pack_task = queue_->CreateTask("codec.cl", "encode_bitpack",
+                                        Options<T>(), in_arg, size_arg,
+                                        min_arg, width_arg, words_arg,
+                                        packed_arg);
+    auto pack_future = queue_->EnqueueTask(pack_task,
+                                           Grid(cl::NDRange(RoundUp(words,
+                                                                    64))));
+    cl::Buffer packed = pack_future.get()[0];
+    queue_->queue().enqueueReadBuffer(packed, CL_TRUE, 0,
+                                      words * sizeof(uint32_t),
+                                      encoded.get_raw() + 2);
+  }
+  TransferCodec<T>::Decode(encoded.get_raw(), size, CodecScheme::BitPack,
+                           array.get_raw());
+  last_scheme_ = CodecScheme::BitPack;
+  last_bytes_ = words * sizeof(uint32_t) + minmax.memsize();
+  return array;
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_COMPRESSED_TRANSFER_H_
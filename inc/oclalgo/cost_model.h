@@ -0,0 +1,153 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file cost_model.h
+ *  @brief Contains oclalgo::CostModel class which predicts time of
+ *  operations on host and on OpenCL device.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Host time is work / host rate. Device time is launch latency plus
+ *  transfers of operands and result plus work / device rate. Rates,
+ *  bandwidths and latency are measured once (see Calibrate() in
+ *  dispatcher.h), saved to profile file and refined by exponential moving
+ *  average of recorded timings.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_COST_MODEL_H_
+#define INC_OCLALGO_COST_MODEL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+namespace oclalgo {
+
+/** @brief Where operation is executed. */
+enum class Target { Host, Device };
+
+/*!
+ * @brief Kinds of operations with separate rates (work of Multiply is
+ * number of multiply-adds, work of Elementwise is number of elements).
+ */
+enum class Operation { Multiply, Elementwise };
+
+constexpr int operation_kinds = 2;
+
+/** @brief Measured performance of host and device. */
+struct DeviceProfile {
+  /** @brief Name of device the profile was measured on. */
+  std::string device;
+  /** @brief Host to device bandwidth (bytes per second). */
+  double upload_bandwidth = 1e9;
+  /** @brief Device to host bandwidth (bytes per second). */
+  double download_bandwidth = 1e9;
+  /** @brief Time of task creation, launch and wait (seconds). */
+  double launch_latency = 1e-4;
+  /** @brief Device work per second for every Operation. */
+  double device_rate[operation_kinds] = {1e10, 1e9};
+  /** @brief Host work per second for every Operation. */
+  double host_rate[operation_kinds] = {1e9, 1e9};
+};
+
+/** @brief Size of operation for cost prediction. */
+struct OperationCost {
+  /** @brief Amount of work (see Operation). */
+  double work;
+  /** @brief Bytes uploaded to device before operation. */
+  size_t bytes_in;
+  /** @brief Bytes downloaded from device after operation. */
+  size_t bytes_out;
+};
+
+/*!
+ * @brief Reads profile file, returns false if file doesn't exist or is
+ * malformed.
+ */
+bool LoadProfile(const std::string& path, DeviceProfile* profile);
+/** @brief Writes profile file, returns false on failure. */
+bool SaveProfile(const std::string& path, const DeviceProfile& profile);
+/*!
+ * @brief Returns path of profile file: OCLALGO_PROFILE environment
+ * variable or .oclalgo_profile in home directory (empty if neither is set).
+ */
+std::string DefaultProfilePath();
+
+/*!
+ * @brief Predicts time of operations on host and device.
+ *
+ * All methods are thread-safe.
+ */
+class CostModel {
+ public:
+  /*!
+   * @param profile initial rates
+   * @param smoothing weight of new timing in moving averages
+   */
+  explicit CostModel(const DeviceProfile& profile, double smoothing = 0.25);
+
+  CostModel(const CostModel&) = delete;
+  CostModel& operator=(const CostModel&) = delete;
+
+  /** @brief Returns predicted time of operation in seconds. */
+  double Predict(Target target, Operation op, const OperationCost& cost) const;
+  /** @brief Returns target with the least predicted time. */
+  Target Choose(Operation op, const OperationCost& cost) const;
+  /*!
+   * @brief Refines model by actual time of operation.
+   *
+   * Host timing updates host rate. Device timing updates device rate if
+   * kernel dominates predicted time, otherwise it updates launch latency.
+   */
+  void Record(Target target, Operation op, const OperationCost& cost,
+              double seconds);
+  /** @brief Returns current (refined) profile. */
+  DeviceProfile profile() const;
+
+ private:
+  double PredictLocked(Target target, Operation op,
+                       const OperationCost& cost) const;
+  double Transfer(const OperationCost& cost) const;
+
+  mutable std::mutex mutex_;
+  DeviceProfile profile_;
+  double smoothing_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_COST_MODEL_H_
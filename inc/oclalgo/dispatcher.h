@@ -0,0 +1,265 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file dispatcher.h
+ *  @brief Contains oclalgo::Dispatcher class which runs matrix operations
+ *  on host or on OpenCL device by predicted time.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Small products are faster on host: device product of host matrices pays
+ *  for uploads, task creation, launch and download. Dispatcher predicts
+ *  both times by CostModel, runs operation on the faster target and
+ *  records actual time to refine the model.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_DISPATCHER_H_
+#define INC_OCLALGO_DISPATCHER_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <string>
+
+#include <oclalgo/cost_model.h>
+#include <oclalgo/dmatrix.h>
+
+namespace oclalgo {
+
+namespace internal {
+
+/** @brief Returns the least time of <i>repeats</i> calls of f. */
+template <typename F>
+double BestTime(F f, int repeats) {
+  double best = std::numeric_limits<double>::max();
+  for (int i = 0; i < repeats; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() -
+                                            start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+inline Matrix<float> CalibrationMatrix(int rows, int cols) {
+  Matrix<float> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = static_cast<float>((i + j) % 7);
+  return m;
+}
+
+/*!
+ * @brief Returns rate of work measured as work / (time - latency) (time is
+ * clamped to keep rate finite).
+ */
+inline double Rate(double work, double seconds, double latency) {
+  return work / std::max(seconds - latency, seconds * 0.1);
+}
+
+}  // namespace internal
+
+/*!
+ * @brief Measures transfer bandwidths, launch latency and rates of host and
+ * device operations (takes about a second, the first launch builds
+ * programs).
+ */
+inline DeviceProfile Calibrate() {
+  Queue* queue = MatrixQueue::instance();
+  DeviceProfile profile;
+  profile.device = queue->DeviceName();
+
+  // 16 MB transfers
+  const int rows = 1024, cols = 4096;
+  const double bytes = rows * cols * sizeof(float);
+  Matrix<float> host = internal::CalibrationMatrix(rows, cols);
+  DMatrix<float> device(rows, cols);
+  profile.upload_bandwidth = bytes / internal::BestTime([&]() {
+    device.UpdateData(host);
+  }, 3);
+  profile.download_bandwidth = bytes / internal::BestTime([&]() {
+    device.ToHost(&host);
+  }, 3);
+
+  // the smallest task is dominated by launch (host matrices outlive device
+  // ones created on their data)
+  Matrix<float> host_one = internal::CalibrationMatrix(1, 1);
+  DMatrix<float> one(host_one);
+  (one + one).get();
+  profile.launch_latency = internal::BestTime([&]() {
+    (one + one).get();
+  }, 10);
+  int elementwise = static_cast<int>(Operation::Elementwise);
+  profile.device_rate[elementwise] = internal::Rate(
+      rows * cols, internal::BestTime([&]() {
+        (device + device).get();
+      }, 3), profile.launch_latency);
+  profile.host_rate[elementwise] = rows * cols / internal::BestTime([&]() {
+    host + host;
+  }, 3);
+
+  int multiply = static_cast<int>(Operation::Multiply);
+  const int n = 512;
+  Matrix<float> host_square = internal::CalibrationMatrix(n, n);
+  DMatrix<float> square(host_square);
+  (square * square).get();
+  profile.device_rate[multiply] = internal::Rate(
+      1.0 * n * n * n, internal::BestTime([&]() {
+        (square * square).get();
+      }, 3), profile.launch_latency);
+  const int m = 128;
+  Matrix<float> small = internal::CalibrationMatrix(m, m);
+  profile.host_rate[multiply] = 1.0 * m * m * m / internal::BestTime([&]() {
+    small * small;
+  }, 3);
+  return profile;
+}
+
+/*!
+ * @brief Runs matrix operations on host or device by predicted time.
+ *
+ * Methods are thread-safe.
+ */
+class Dispatcher {
+ public:
+  /*!
+   * @brief Provides dispatcher with profile loaded from
+   * DefaultProfilePath() (if it was measured on the same device) or
+   * measured by Calibrate() and saved there.
+   */
+  static Dispatcher* instance() {
+    static Dispatcher dispatcher(LoadOrCalibrate(DefaultProfilePath()));
+    return &dispatcher;
+  }
+
+  explicit Dispatcher(const DeviceProfile& profile) : model_(profile) {
+  }
+
+  Dispatcher(const Dispatcher&) = delete;
+  Dispatcher& operator=(const Dispatcher&) = delete;
+
+  CostModel* model() noexcept { return &model_; }
+
+  /*!
+   * @brief Returns cached profile of MatrixQueue device or measures and
+   * caches it.
+   */
+  static DeviceProfile LoadOrCalibrate(const std::string& path) {
+    DeviceProfile profile;
+    if (LoadProfile(path, &profile) &&
+        profile.device == MatrixQueue::instance()->DeviceName())
+      return profile;
+    profile = Calibrate();
+    SaveProfile(path, profile);  // the cache is optional
+    return profile;
+  }
+
+  /** @brief Returns target which is chosen for product of matrices. */
+  Target ChooseMultiply(int rows, int inner, int cols, size_t elem_size) const {
+    return model_.Choose(Operation::Multiply,
+                         MultiplyCost(rows, inner, cols, elem_size));
+  }
+
+  /** @brief Returns product of matrices computed on the faster target. */
+  template <typename T>
+  Matrix<T> Multiply(const Matrix<T>& m1, const Matrix<T>& m2) {
+    assert(m1.cols() == m2.rows());
+    OperationCost cost = MultiplyCost(m1.rows(), m1.cols(), m2.cols(),
+                                      sizeof(T));
+    return Run(Operation::Multiply, cost,
+               [&]() { return m1 * m2; },
+               [&]() {
+                 return (ToDevice(m1) * ToDevice(m2)).get().ToHost();
+               });
+  }
+
+  /** @brief Returns sum of matrices computed on the faster target. */
+  template <typename T>
+  Matrix<T> Add(const Matrix<T>& m1, const Matrix<T>& m2) {
+    assert(m1.rows() == m2.rows() && m1.cols() == m2.cols());
+    size_t size = static_cast<size_t>(m1.rows()) * m1.cols();
+    OperationCost cost = {static_cast<double>(size), 2 * size * sizeof(T),
+                          size * sizeof(T)};
+    return Run(Operation::Elementwise, cost,
+               [&]() { return m1 + m2; },
+               [&]() {
+                 return (ToDevice(m1) + ToDevice(m2)).get().ToHost();
+               });
+  }
+
+ private:
+  static OperationCost MultiplyCost(int rows, int inner, int cols,
+                                    size_t elem_size) {
+    OperationCost cost;
+    cost.work = 1.0 * rows * inner * cols;
+    cost.bytes_in = (static_cast<size_t>(rows) * inner +
+                     static_cast<size_t>(inner) * cols) * elem_size;
+    cost.bytes_out = static_cast<size_t>(rows) * cols * elem_size;
+    return cost;
+  }
+
+  template <typename T>
+  static DMatrix<T> ToDevice(const Matrix<T>& m) {
+    DMatrix<T> result(m.rows(), m.cols());
+    result.UpdateData(m);
+    return result;
+  }
+
+  /** @brief Runs operation on the chosen target and records its time. */
+  template <typename HostOp, typename DeviceOp>
+  auto Run(Operation op, const OperationCost& cost, HostOp host_op,
+           DeviceOp device_op) -> decltype(host_op()) {
+    Target target = model_.Choose(op, cost);
+    auto start = std::chrono::steady_clock::now();
+    auto result = target == Target::Host ? host_op() : device_op();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() -
+                                            start;
+    model_.Record(target, op, cost, elapsed.count());
+    return result;
+  }
+
+  CostModel model_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_DISPATCHER_H_
@@ -36,6 +36,11 @@
  *  @author Dmitry Senin <d.senin@samsung.com>
  *  @version 1.0
  *
+ *  @section Notes
+ *  Device matrices are dense and row-major. Host spans and views are uploaded
+ *  without intermediate copies if they are row-major (strided rows are copied
+ *  by rectangular writes), column-major ones are packed on host first.
+ *
  *  @section Copyright
  *  Copyright 2013 Samsung R&D Institute Russia
  */
@@ -46,10 +51,14 @@
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.hpp>
 
+#include <algorithm>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include <oclalgo/matrix.h>
 #include <oclalgo/queue.h>
+#include <oclalgo/scratch_pool.h>
 
 namespace oclalgo {
 
@@ -68,6 +77,20 @@ class MatrixQueue {
   constexpr static int block_size = 32;
 };
 
+namespace internal {
+
+/*!
+ * @brief Returns complete event of MatrixQueue context for results which
+ * need no commands (futures can't wait for null events).
+ */
+inline cl::Event CompletedEvent() {
+  cl::UserEvent event(MatrixQueue::instance()->context());
+  event.setStatus(CL_COMPLETE);
+  return event;
+}
+
+}  // namespace internal
+
 /** @brief Class of matrix with data placed in OpenCL device memory. */
 template <typename T>
 class DMatrix {
@@ -75,8 +98,12 @@ class DMatrix {
   DMatrix();
   /** @brief Creates device matrix by using host matrix data. */
   explicit DMatrix(const Matrix<T>& m);
+  /** @brief Creates device matrix by using host matrix span or view data. */
+  explicit DMatrix(const MatrixSpan<const T>& m);
   /*!
    * @brief Creates device matrix with corresponding number of rows and columns.
+   *
+   * Empty matrix has no buffer.
    */
   DMatrix(int rows, int cols);
   /*!
@@ -122,6 +149,19 @@ class DMatrix {
   oclalgo::future<DMatrix<T>> UpdateData(const Matrix<T>& m,
                                          BlockingType block);
 
+  /** Updates device matrix using host matrix span or view data. */
+  void UpdateData(const MatrixSpan<const T>& m);
+
+  /*!
+   * @brief Updates device matrix using host matrix span or view data as
+   * blocking or unblocking operation (depends on argument <i>block</i>).
+   *
+   * Span memory must not be changed or released until the future is ready.
+   * Column-major spans are always copied synchronously.
+   */
+  oclalgo::future<DMatrix<T>> UpdateData(const MatrixSpan<const T>& m,
+                                         BlockingType block);
+
   /** @brief Returns number of rows in device matrix. */
   int rows() const noexcept { return rows_; }
   /** @brief Returns number of columns in device matrix. */
@@ -130,6 +170,8 @@ class DMatrix {
   cl::Buffer buffer() const noexcept { return buffer_; }
 
  private:
+  cl::Event Upload(const MatrixSpan<const T>& m, BlockingType block);
+
   int rows_;
   int cols_;
   cl::Buffer buffer_;
@@ -141,15 +183,25 @@ DMatrix<T>::DMatrix(): rows_(0), cols_(0) {
 
 template <typename T>
 DMatrix<T>::DMatrix(const Matrix<T>& m): rows_(m.rows()), cols_(m.cols()) {
-  buffer_ = cl::Buffer(MatrixQueue::instance()->context(),
-                       CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR,
-                       m.rows() * m.cols() * sizeof(T), m.data().get_raw());
+  buffer_ = MatrixQueue::instance()->CreateBuffer(
+      m.data(), CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, "DMatrix");
+}
+
+template <typename T>
+DMatrix<T>::DMatrix(const MatrixSpan<const T>& m)
+    : rows_(m.rows()),
+      cols_(m.cols()) {
+  if (rows_ * cols_ == 0) return;
+  buffer_ = MatrixQueue::instance()->CreateBuffer<T>(
+      rows_ * cols_, CL_MEM_READ_WRITE, "DMatrix");
+  Upload(m, BlockingType::Block);
 }
 
 template <typename T>
 DMatrix<T>::DMatrix(int rows, int cols): rows_(rows), cols_(cols) {
-  buffer_ = cl::Buffer(MatrixQueue::instance()->context(), CL_MEM_READ_WRITE,
-                       rows_ * cols_ * sizeof(T));
+  if (rows_ * cols_ == 0) return;
+  buffer_ = MatrixQueue::instance()->CreateBuffer<T>(
+      rows_ * cols_, CL_MEM_READ_WRITE, "DMatrix");
 }
 
 template <typename T>
@@ -183,14 +235,17 @@ DMatrix<T>& DMatrix<T>::operator=(DMatrix<T>&& m) {
 
 template <typename T>
 Matrix<T> DMatrix<T>::ToHost() const {
-  shared_array<T> data(rows_ * cols_);
+  shared_array<T> data =
+      MatrixQueue::instance()->CreateStagingArray<T>(rows_ * cols_);
   MatrixQueue::instance()->memcpy(data, buffer_);
   return Matrix<T>(rows_, cols_, data);
 }
 
 template <typename T>
 oclalgo::future<Matrix<T>> DMatrix<T>::ToHost(BlockingType block) const {
-  shared_array<T> data(rows_ * cols_), copy(data);
+  shared_array<T> data =
+      MatrixQueue::instance()->CreateStagingArray<T>(rows_ * cols_);
+  shared_array<T> copy(data);
   auto f = MatrixQueue::instance()->memcpy(std::move(copy), buffer_,
                                            block);
   Matrix<T> result(rows_, cols_, data);
@@ -209,9 +264,8 @@ void DMatrix<T>::UpdateData(const Matrix<T>& m) {
   if (rows_ != m.rows() || cols_ != m.cols()) {
     rows_ = m.rows();
     cols_ = m.cols();
-    buffer_ = cl::Buffer(MatrixQueue::instance()->context(),
-                         CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR,
-                         rows_ * cols_ * sizeof(T), m.data().get_raw());
+    buffer_ = MatrixQueue::instance()->CreateBuffer(
+        m.data(), CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, "DMatrix");
   } else {
     MatrixQueue::instance()->memcpy(buffer_, m.data());
   }
@@ -223,8 +277,8 @@ oclalgo::future<DMatrix<T>> DMatrix<T>::UpdateData(const Matrix<T>& m,
   if (rows_ != m.rows() || cols_ != m.cols()) {
     rows_ = m.rows();
     cols_ = m.cols();
-    buffer_ = cl::Buffer(MatrixQueue::instance()->context(), CL_MEM_READ_WRITE,
-                         rows_ * cols_ * sizeof(T));
+    buffer_ = MatrixQueue::instance()->CreateBuffer<T>(
+        rows_ * cols_, CL_MEM_READ_WRITE, "DMatrix");
   }
   cl::Buffer copy(buffer_);
   auto f = MatrixQueue::instance()->memcpy(std::move(copy), m.data(), block);
@@ -232,102 +286,528 @@ oclalgo::future<DMatrix<T>> DMatrix<T>::UpdateData(const Matrix<T>& m,
   return oclalgo::future<DMatrix<T>>(std::move(result), f.event());
 }
 
+template <typename T>
+void DMatrix<T>::UpdateData(const MatrixSpan<const T>& m) {
+  UpdateData(m, BlockingType::Block);
+}
+
+template <typename T>
+oclalgo::future<DMatrix<T>> DMatrix<T>::UpdateData(
+    const MatrixSpan<const T>& m, BlockingType block) {
+  if (rows_ != m.rows() || cols_ != m.cols()) {
+    rows_ = m.rows();
+    cols_ = m.cols();
+    buffer_ = rows_ * cols_ == 0 ? cl::Buffer() :
+        MatrixQueue::instance()->CreateBuffer<T>(rows_ * cols_,
+                                                 CL_MEM_READ_WRITE,
+                                                 "DMatrix");
+  }
+  cl::Event event = Upload(m, block);
+  DMatrix<T> result(rows_, cols_, buffer_);
+  return oclalgo::future<DMatrix<T>>(std::move(result), event);
+}
+
+template <typename T>
+cl::Event DMatrix<T>::Upload(const MatrixSpan<const T>& m,
+                             BlockingType block) {
+  cl::CommandQueue queue = MatrixQueue::instance()->queue();
+  cl_bool blocking = block == BlockingType::Block ? CL_TRUE : CL_FALSE;
+  // futures of empty uploads get complete event
+  if (m.rows() * m.cols() == 0) return internal::CompletedEvent();
+  cl::Event event;
+  if (m.packing() == COL) {
+    shared_array<T> packed =
+        MatrixQueue::instance()->CreateStagingArray<T>(rows_ * cols_);
+    Pack(m, packed.get_raw());
+    queue.enqueueWriteBuffer(buffer_, CL_TRUE, 0, packed.memsize(),
+                             packed.get_raw(), nullptr, &event);
+  } else if (m.contiguous()) {
+    queue.enqueueWriteBuffer(buffer_, blocking, 0,
+                             rows_ * cols_ * sizeof(T), m.data(), nullptr,
+                             &event);
+  } else {
+    cl::size_t<3> origin, region;
+    origin[0] = origin[1] = origin[2] = 0;
+    region[0] = cols_ * sizeof(T);
+    region[1] = rows_;
+    region[2] = 1;
+    // host pointer of the C++ wrapper isn't const, data is only read
+    queue.enqueueWriteBufferRect(buffer_, blocking, origin, origin, region,
+                                 cols_ * sizeof(T), 0, m.ld() * sizeof(T), 0,
+                                 const_cast<T*>(m.data()), nullptr, &event);
+  }
+  return event;
+}
+
+/*!
+ * @brief Creates output argument for results of DMatrix operators.
+ *
+ * Buffer is allocated from active ScopedScratch of MatrixQueue if there is
+ * one, otherwise it's created by MatrixQueue with corresponding tag.
+ */
+template <typename T>
+BufferArg AllocateResult(size_t size, const char* tag) {
+  Queue* queue = MatrixQueue::instance();
+  ScopedScratch* scratch = ScopedScratch::active(queue);
+  if (scratch != nullptr)
+    return BufferArg(scratch->Allocate<T>(size), ArgType::OUT);
+  return queue->CreateKernelArg<T>(size, ArgType::OUT, tag);
+}
+
+/*!
+ * @brief Returns ready result of operator on empty matrix (buffers of zero
+ * size can't be created, so no kernel is enqueued).
+ */
+template <typename T>
+oclalgo::future<DMatrix<T>> EmptyResult(int rows, int cols) {
+  return oclalgo::future<DMatrix<T>>(DMatrix<T>(rows, cols, cl::Buffer()),
+                                     internal::CompletedEvent());
+}
+
 template <typename T> std::string PrintType();
 template <> std::string PrintType<int>() { return "int"; }
 template <> std::string PrintType<float>() { return "float"; }
 template <> std::string PrintType<double>() { return "double"; }
 
+/*!
+ * @brief Elementwise operations of map_* kernels (see elementwise.cl).
+ *
+ * Operands are a, b, c (elements of matrices) and alpha (scalar).
+ */
+enum class ElementOp {
+  Add,     // a + b
+  Sub,     // a - b
+  Mul,     // a * b
+  Div,     // a / b
+  Min,     // min(a, b)
+  Max,     // max(a, b)
+  Scale,   // alpha * a
+  Axpy,    // alpha * a + b
+  MulAdd   // a * b + c
+};
+
+namespace internal {
+
+inline const char* ElementOpMacro(ElementOp op) {
+  switch (op) {
+    case ElementOp::Add: return "OP_ADD";
+    case ElementOp::Sub: return "OP_SUB";
+    case ElementOp::Mul: return "OP_MUL";
+    case ElementOp::Div: return "OP_DIV";
+    case ElementOp::Min: return "OP_MIN";
+    case ElementOp::Max: return "OP_MAX";
+    case ElementOp::Scale: return "OP_SCALE";
+    case ElementOp::Axpy: return "OP_AXPY";
+    default: return "OP_MULADD";
+  }
+}
+
+/*!
+ * @brief Returns number of work-items enough to load device (2048 per
+ * compute unit) for grid-stride kernels.
+ */
+inline size_t MaxWorkItems() {
+  static const size_t max_items = 2048 *
+      MatrixQueue::instance()->device().getInfo<CL_DEVICE_MAX_COMPUTE_UNITS>();
+  return max_items;
+}
+
+/** @brief Grid for grid-stride kernel processing <i>items</i> vectors. */
+inline Grid StrideGrid(size_t items) {
+  return Grid(cl::NDRange(std::max<size_t>(1, std::min(items,
+                                                       MaxWorkItems()))));
+}
+
+inline bool SameShape(int /*rows*/, int /*cols*/) {
+  return true;
+}
+
+template <typename T, typename... Tail>
+bool SameShape(int rows, int cols, const DMatrix<T>& m,
+               const Tail&... tail) {
+  return m.rows() == rows && m.cols() == cols && SameShape(rows, cols, tail...);
+}
+
+}  // namespace internal
+
+/*!
+ * @brief Applies elementwise operation <i>op</i> to 1, 2 or 3 device
+ * matrices of the same shape.
+ *
+ * Kernels load vectors of 32 bytes (vload8 for int and float, vload4 for
+ * double) in grid-stride loops, so matrices of any size are processed by
+ * the same number of work-items.
+ */
+template <typename T, typename... Tail>
+oclalgo::future<DMatrix<T>> MapElements(ElementOp op, T alpha,
+                                        const DMatrix<T>& m,
+                                        const Tail&... tail) {
+  static_assert(sizeof...(Tail) < 3, "too many operands");
+  assert(internal::SameShape(m.rows(), m.cols(), tail...));
+  static const char* kernels[] = { "map_unary", "map_binary", "map_ternary" };
+  Queue *queue = MatrixQueue::instance();
+
+  size_t size = static_cast<size_t>(m.rows()) * m.cols();
+  if (size == 0) return EmptyResult<T>(m.rows(), m.cols());
+  BufferArg out = AllocateResult<T>(size, "DMatrix::MapElements");
+  const int width = 32 / sizeof(T);
+  char options[512] = {0};
+  std::snprintf(options, sizeof(options),
+                "-D VAR_TYPE=%s -D VECTOR_WIDTH=%d -D OP=%s",
+                PrintType<T>().c_str(), width, internal::ElementOpMacro(op));
+  Task task = queue->CreateTask("elementwise.cl", kernels[sizeof...(Tail)],
+                               options, BufferArg(m.buffer(), ArgType::IN),
+                               BufferArg(tail.buffer(), ArgType::IN)..., out,
+                               alpha, static_cast<int>(size));
+  Grid grid = internal::StrideGrid((size + width - 1) / width);
+  auto f = queue->EnqueueTask(std::move(task), grid);
+  DMatrix<T> result(m.rows(), m.cols(), out.data());
+  return oclalgo::future<DMatrix<T>>(std::move(result), f.event());
+}
+
 template <typename T>
 oclalgo::future<DMatrix<T>> operator+(const DMatrix<T>& m1,
                                       const DMatrix<T>& m2) {
-  assert(m1.rows() == m2.rows() && m1.cols() == m2.cols());
-  Queue *queue = MatrixQueue::instance();
+  return MapElements(ElementOp::Add, T(), m1, m2);
+}
+
+template <typename T>
+oclalgo::future<DMatrix<T>> operator-(const DMatrix<T>& m1,
+                                      const DMatrix<T>& m2) {
+  return MapElements(ElementOp::Sub, T(), m1, m2);
+}
+
+/** @brief Returns alpha * m. */
+template <typename T>
+oclalgo::future<DMatrix<T>> Scale(const DMatrix<T>& m, T alpha) {
+  return MapElements(ElementOp::Scale, alpha, m);
+}
 
-  BufferArg m1_arg(m1.buffer(), ArgType::IN);
-  BufferArg m2_arg(m2.buffer(), ArgType::IN);
-  size_t size = sizeof(T) * m1.rows() * m1.cols();
-  BufferArg out = queue->CreateKernelArg<T>(size, ArgType::OUT);
+/** @brief Returns alpha * x + y. */
+template <typename T>
+oclalgo::future<DMatrix<T>> Axpy(T alpha, const DMatrix<T>& x,
+                                 const DMatrix<T>& y) {
+  return MapElements(ElementOp::Axpy, alpha, x, y);
+}
+
+/** @brief Returns elementwise product of matrices. */
+template <typename T>
+oclalgo::future<DMatrix<T>> ElementwiseMul(const DMatrix<T>& m1,
+                                           const DMatrix<T>& m2) {
+  return MapElements(ElementOp::Mul, T(), m1, m2);
+}
 
+/** @brief Returns elementwise quotient of matrices. */
+template <typename T>
+oclalgo::future<DMatrix<T>> ElementwiseDiv(const DMatrix<T>& m1,
+                                           const DMatrix<T>& m2) {
+  return MapElements(ElementOp::Div, T(), m1, m2);
+}
+
+/** @brief Returns elementwise minimum of matrices. */
+template <typename T>
+oclalgo::future<DMatrix<T>> ElementwiseMin(const DMatrix<T>& m1,
+                                           const DMatrix<T>& m2) {
+  return MapElements(ElementOp::Min, T(), m1, m2);
+}
+
+/** @brief Returns elementwise maximum of matrices. */
+template <typename T>
+oclalgo::future<DMatrix<T>> ElementwiseMax(const DMatrix<T>& m1,
+                                           const DMatrix<T>& m2) {
+  return MapElements(ElementOp::Max, T(), m1, m2);
+}
+
+/** @brief Returns elementwise a * b + c. */
+template <typename T>
+oclalgo::future<DMatrix<T>> MulAdd(const DMatrix<T>& a, const DMatrix<T>& b,
+                                   const DMatrix<T>& c) {
+  return MapElements(ElementOp::MulAdd, T(), a, b, c);
+}
+
+/*!
+ * @brief Applies binary elementwise operation <i>op</i> to matrix <i>m</i>
+ * and vector <i>v</i> broadcasted over matrix.
+ *
+ * Vector is row (1 x m.cols(), applied to every row) or column
+ * (m.rows() x 1, applied to every column) device matrix.
+ */
+template <typename T>
+oclalgo::future<DMatrix<T>> MapBroadcast(ElementOp op, T alpha,
+                                         const DMatrix<T>& m,
+                                         const DMatrix<T>& v) {
+  bool row = v.rows() == 1 && v.cols() == m.cols();
+  assert(row || (v.cols() == 1 && v.rows() == m.rows()));
+  Queue *queue = MatrixQueue::instance();
+
+  size_t size = static_cast<size_t>(m.rows()) * m.cols();
+  if (size == 0) return EmptyResult<T>(m.rows(), m.cols());
+  BufferArg out = AllocateResult<T>(size, "DMatrix::MapBroadcast");
   char options[512] = {0};
-  std::snprintf(options, sizeof(options), "-D VAR_TYPE=%s",
-                PrintType<T>().c_str());
-  Task task = queue->CreateTask("matrix.cl", "matrix_add", options, m1_arg,
-                               m2_arg, out);
-  Grid grid = Grid(cl::NDRange(m1.rows(), m1.cols()));
-  auto f = queue->EnqueueTask(task, grid);
-  DMatrix<T> result(m1.rows(), m1.cols(), out.data());
+  std::snprintf(options, sizeof(options), "-D VAR_TYPE=%s -D OP=%s",
+                PrintType<T>().c_str(), internal::ElementOpMacro(op));
+  Task task = queue->CreateTask("elementwise.cl", row ? "map_rows" : "map_cols",
+                               options, BufferArg(m.buffer(), ArgType::IN),
+                               BufferArg(v.buffer(), ArgType::IN), out, alpha,
+                               m.rows(), m.cols());
+  // work-items along columns for coalesced access, rows are split between
+  // the rest of work-items
+  size_t cols = std::min<size_t>(m.cols(), 256);
+  size_t rows = std::max<size_t>(
+      1, std::min<size_t>(m.rows(), internal::MaxWorkItems() / cols));
+  Grid grid = Grid(cl::NDRange(cols, rows));
+  auto f = queue->EnqueueTask(std::move(task), grid);
+  DMatrix<T> result(m.rows(), m.cols(), out.data());
   return oclalgo::future<DMatrix<T>>(std::move(result), f.event());
 }
 
+/** @brief Reductions of matrix rows or columns (see reduction.cl). */
+enum class ReduceOp {
+  Sum,
+  Mean,
+  Max,
+  Min,
+  Norm,        // Euclidean norm
+  SumSquares   // squared Euclidean norm
+};
+
+namespace internal {
+
+inline const char* ReduceOpMacro(ReduceOp op) {
+  switch (op) {
+    case ReduceOp::Sum: return "REDUCE_SUM";
+    case ReduceOp::Mean: return "REDUCE_MEAN";
+    case ReduceOp::Max: return "REDUCE_MAX";
+    case ReduceOp::Min: return "REDUCE_MIN";
+    case ReduceOp::Norm: return "REDUCE_NORM";
+    default: return "REDUCE_SUMSQ";
+  }
+}
+
 template <typename T>
-oclalgo::future<DMatrix<T>> operator-(const DMatrix<T>& m1,
-                                      const DMatrix<T>& m2) {
-  assert(m1.rows() == m2.rows() && m1.cols() == m2.cols());
+oclalgo::future<DMatrix<T>> Reduce(const DMatrix<T>& m, ReduceOp op,
+                                   bool rows) {
+  // reductions of empty rows or columns are written by kernels
+  if ((rows ? m.rows() : m.cols()) == 0)
+    return EmptyResult<T>(rows ? 0 : 1, rows ? 1 : 0);
   Queue *queue = MatrixQueue::instance();
+  BufferArg out = AllocateResult<T>(rows ? m.rows() : m.cols(),
+                                    "DMatrix::Reduce");
+  // short rows are reduced by smaller work-groups
+  int group_size = 16;
+  while (group_size < 256 && group_size < m.cols())
+    group_size *= 2;
+  std::string type = PrintType<T>();
+  char options[512] = {0};
+  std::snprintf(options, sizeof(options),
+                "-D VAR_TYPE=%s -D REAL_TYPE=%s -D REDUCE=%s -D GROUP_SIZE=%d",
+                type.c_str(), type == "double" ? "double" : "float",
+                ReduceOpMacro(op), group_size);
+  Task task = queue->CreateTask("reduction.cl",
+                               rows ? "reduce_rows" : "reduce_cols", options,
+                               BufferArg(m.buffer(), ArgType::IN), out,
+                               m.rows(), m.cols());
+  size_t max_groups = MaxWorkItems() / 256;
+  Grid grid = rows ?
+      Grid(cl::NDRange(group_size * std::min<size_t>(m.rows(), max_groups)),
+           cl::NDRange(group_size)) :
+      Grid(cl::NDRange(32 * std::min<size_t>((m.cols() + 31) / 32,
+                                             max_groups), 8),
+           cl::NDRange(32, 8));
+  auto f = queue->EnqueueTask(std::move(task), grid);
+  DMatrix<T> result(rows ? m.rows() : 1, rows ? 1 : m.cols(), out.data());
+  return oclalgo::future<DMatrix<T>>(std::move(result), f.event());
+}
+
+}  // namespace internal
+
+/*!
+ * @brief Reduces every row of matrix (result is m.rows() x 1 column).
+ *
+ * Every row is reduced by one work-group.
+ */
+template <typename T>
+oclalgo::future<DMatrix<T>> ReduceRows(const DMatrix<T>& m, ReduceOp op) {
+  return internal::Reduce(m, op, true);
+}
 
-  BufferArg m1_arg(m1.buffer(), ArgType::IN);
-  BufferArg m2_arg(m2.buffer(), ArgType::IN);
-  size_t size = sizeof(T) * m1.rows() * m1.cols();
-  BufferArg out = queue->CreateKernelArg<T>(size, ArgType::OUT);
+/*!
+ * @brief Reduces every column of matrix (result is 1 x m.cols() row).
+ *
+ * Columns are reduced by tiles of 32 columns x 8 row partitions.
+ */
+template <typename T>
+oclalgo::future<DMatrix<T>> ReduceCols(const DMatrix<T>& m, ReduceOp op) {
+  return internal::Reduce(m, op, false);
+}
+
+namespace internal {
 
+/*!
+ * @brief Creates task of row-wise kernel from normalization.cl and its
+ * grid: rows shorter than 256 elements are packed into one work-group.
+ *
+ * Matrix must not be empty (grid would have no work-groups).
+ */
+template <typename T, typename... Args>
+std::pair<Task, Grid> RowTask(const char* kernel, const DMatrix<T>& m,
+                              const char* extra_options,
+                              const Args&... args) {
+  static_assert(std::is_floating_point<T>::value,
+                "row-wise kernels require floating point matrices");
+  assert(m.rows() > 0 && m.cols() > 0);
+  const int group_size = 256;
+  int lanes = 32;
+  while (lanes < group_size && lanes < m.cols())
+    lanes *= 2;
+  int rows_per_group = group_size / lanes;
   char options[512] = {0};
-  std::snprintf(options, sizeof(options), "-D VAR_TYPE=%s",
-                PrintType<T>().c_str());
-  Task task = queue->CreateTask("matrix.cl", "matrix_sub", options, m1_arg,
-                               m2_arg, out);
-  Grid grid = Grid(cl::NDRange(m1.rows(), m1.cols()));
-  auto f = queue->EnqueueTask(task, grid);
-  DMatrix<T> result(m1.rows(), m1.cols(), out.data());
+  std::snprintf(options, sizeof(options),
+                "-D VAR_TYPE=%s -D GROUP_SIZE=%d -D ROWS_PER_GROUP=%d%s",
+                PrintType<T>().c_str(), group_size, rows_per_group,
+                extra_options);
+  Task task = MatrixQueue::instance()->CreateTask("normalization.cl", kernel,
+                                                  options, args...);
+  size_t groups = std::min<size_t>(
+      (m.rows() + rows_per_group - 1) / rows_per_group,
+      std::max<size_t>(1, MaxWorkItems() / group_size));
+  return std::make_pair(std::move(task),
+                        Grid(cl::NDRange(groups * group_size),
+                             cl::NDRange(group_size)));
+}
+
+template <typename T>
+oclalgo::future<DMatrix<T>> Softmax(const DMatrix<T>& m, bool log) {
+  size_t size = static_cast<size_t>(m.rows()) * m.cols();
+  if (size == 0) return EmptyResult<T>(m.rows(), m.cols());
+  BufferArg out = AllocateResult<T>(size, "DMatrix::Softmax");
+  std::pair<Task, Grid> task = RowTask(
+      "softmax_rows", m, log ? " -D LOG_SOFTMAX" : "",
+      BufferArg(m.buffer(), ArgType::IN), out, m.rows(), m.cols());
+  auto f = MatrixQueue::instance()->EnqueueTask(std::move(task.first),
+                                                task.second);
+  DMatrix<T> result(m.rows(), m.cols(), out.data());
   return oclalgo::future<DMatrix<T>>(std::move(result), f.event());
 }
 
-enum PackingType { ROW, COL };
+}  // namespace internal
 
-struct matrix_param_t {
-  int rows;
-  int cols;
-  PackingType packing;
+/*!
+ * @brief Returns softmax of every row of matrix.
+ *
+ * Max and sum of exponents are computed in one pass by fused kernel
+ * (numerically stable, -INFINITY elements are allowed).
+ */
+template <typename T>
+oclalgo::future<DMatrix<T>> Softmax(const DMatrix<T>& m) {
+  return internal::Softmax(m, false);
+}
 
-  matrix_param_t(int rows, int cols, PackingType packing)
-      : rows(rows),
-        cols(cols),
-        packing(packing) {
-  }
+/** @brief Returns logarithm of softmax of every row of matrix. */
+template <typename T>
+oclalgo::future<DMatrix<T>> LogSoftmax(const DMatrix<T>& m) {
+  return internal::Softmax(m, true);
+}
+
+/*!
+ * @brief Returns layer normalization of every row of matrix:
+ * (x - mean) / sqrt(var + eps) * gamma + beta.
+ *
+ * @param gamma scale row vector (1 x m.cols())
+ * @param beta shift row vector (1 x m.cols())
+ */
+template <typename T>
+oclalgo::future<DMatrix<T>> LayerNorm(const DMatrix<T>& m,
+                                      const DMatrix<T>& gamma,
+                                      const DMatrix<T>& beta,
+                                      T eps = T(1e-5)) {
+  assert(gamma.rows() * gamma.cols() == m.cols());
+  assert(beta.rows() * beta.cols() == m.cols());
+  size_t size = static_cast<size_t>(m.rows()) * m.cols();
+  if (size == 0) return EmptyResult<T>(m.rows(), m.cols());
+  BufferArg out = AllocateResult<T>(size, "DMatrix::LayerNorm");
+  std::pair<Task, Grid> task = internal::RowTask(
+      "layernorm_rows", m, "", BufferArg(m.buffer(), ArgType::IN),
+      BufferArg(gamma.buffer(), ArgType::IN),
+      BufferArg(beta.buffer(), ArgType::IN), out, eps, m.rows(), m.cols());
+  auto f = MatrixQueue::instance()->EnqueueTask(std::move(task.first),
+                                                task.second);
+  DMatrix<T> result(m.rows(), m.cols(), out.data());
+  return oclalgo::future<DMatrix<T>>(std::move(result), f.event());
+}
+
+/** @brief How dimensions of matrix product are passed to OpenCL kernel. */
+enum class KernelShape {
+  /** @brief Dimensions are scalar kernel arguments (one program). */
+  Dynamic,
+  /*!
+   * @brief Dimensions are compiled into kernel (program is built for every
+   * new shape, it's useful for small matrices multiplied many times).
+   */
+  Fixed
 };
 
+namespace internal {
+
+/*!
+ * @brief Enqueues product of the first <i>rows</i> rows of row-major
+ * matrix <i>m1</i> (rows x inner) and <i>m2</i> (inner x cols), result is
+ * written to the first rows of <i>out</i>.
+ */
 template <typename T>
-oclalgo::future<DMatrix<T>> operator*(const DMatrix<T>& m1,
-                                      const DMatrix<T>& m2) {
-  assert(m1.cols() == m2.rows());
-  matrix_param_t m1_param(m1.rows(), m1.cols(), PackingType::ROW);
-  matrix_param_t m2_param(m2.rows(), m2.cols(), PackingType::ROW);
+cl::Event EnqueueMultiply(const cl::Buffer& m1, const cl::Buffer& m2,
+                          const BufferArg& out, int rows, int inner,
+                          int cols, KernelShape shape) {
   Queue *queue = MatrixQueue::instance();
-
-  BufferArg m1_arg(m1.buffer(), ArgType::IN);
-  BufferArg m2_arg(m2.buffer(), ArgType::IN);
-  size_t size = sizeof(T) * m1.rows() * m2.cols();
-  BufferArg out = queue->CreateKernelArg<T>(size, ArgType::OUT);
-  cl::Buffer m1p = cl::Buffer(queue->context(),
-                              CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR,
-                              sizeof(matrix_param_t), &m1_param);
-  BufferArg m1p_arg(m1p, ArgType::IN);
-  cl::Buffer m2p = cl::Buffer(queue->context(),
-                              CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR,
-                              sizeof(matrix_param_t), &m2_param);
-  BufferArg m2p_arg(m2p, ArgType::IN);
+  BufferArg m1_arg(m1, ArgType::IN);
+  BufferArg m2_arg(m2, ArgType::IN);
 
   char options[512] = {0};
   int block_size = MatrixQueue::block_size;
-  std::snprintf(options, sizeof(options), "-D BLOCK_SIZE=%d -D VAR_TYPE=%s",
-                block_size, PrintType<T>().c_str());
-  Task task = queue->CreateTask("matrix.cl", "matrix_mul",
-                               options, m1_arg, m1p_arg, m2_arg, m2p_arg,
-                               out);
-  Grid grid = Grid(cl::NDRange(m2.cols(), m1.rows()),
+  int len = std::snprintf(options, sizeof(options),
+                          "-D BLOCK_SIZE=%d -D VAR_TYPE=%s", block_size,
+                          PrintType<T>().c_str());
+  if (shape == KernelShape::Fixed) {
+    std::snprintf(options + len, sizeof(options) - len,
+                  " -D MUL_ROWS=%d -D MUL_INNER=%d -D MUL_COLS=%d"
+                  " -D A_PACKING=ROW -D B_PACKING=ROW",
+                  rows, inner, cols);
+  }
+  Task task = queue->CreateTask("matrix.cl", "matrix_mul_dims", options,
+                               m1_arg, m2_arg, out, rows, inner, cols,
+                               static_cast<int>(ROW), static_cast<int>(ROW));
+  // global size must be a multiple of work-group size
+  int grid_cols = (cols + block_size - 1) / block_size * block_size;
+  int grid_rows = (rows + block_size - 1) / block_size * block_size;
+  Grid grid = Grid(cl::NDRange(grid_cols, grid_rows),
                    cl::NDRange(block_size, block_size));
-  auto f = queue->EnqueueTask(task, grid);
+  return queue->EnqueueTask(std::move(task), grid).event();
+}
+
+}  // namespace internal
+
+/*!
+ * @brief Multiplies device matrices with corresponding kind of kernel
+ * (operator* uses KernelShape::Dynamic).
+ */
+template <typename T>
+oclalgo::future<DMatrix<T>> Multiply(const DMatrix<T>& m1,
+                                     const DMatrix<T>& m2,
+                                     KernelShape shape) {
+  assert(m1.cols() == m2.rows());
+  size_t size = static_cast<size_t>(m1.rows()) * m2.cols();
+  if (size == 0) return EmptyResult<T>(m1.rows(), m2.cols());
+  BufferArg out = AllocateResult<T>(size, "DMatrix::operator*");
+  cl::Event event = internal::EnqueueMultiply<T>(
+      m1.buffer(), m2.buffer(), out, m1.rows(), m1.cols(), m2.cols(), shape);
   DMatrix<T> result(m1.rows(), m2.cols(), out.data());
-  return oclalgo::future<DMatrix<T>>(std::move(result), f.event());
+  return oclalgo::future<DMatrix<T>>(std::move(result), event);
+}
+
+template <typename T>
+oclalgo::future<DMatrix<T>> operator*(const DMatrix<T>& m1,
+                                      const DMatrix<T>& m2) {
+  return Multiply(m1, m2, KernelShape::Dynamic);
 }
 
 }  // namespace oclalgo
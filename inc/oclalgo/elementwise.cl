@@ -0,0 +1,178 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// Elementwise kernels over matrices stored as contiguous arrays of <n>
+// elements. Work-items process VECTOR_WIDTH elements per load (vloadN) in
+// grid-stride loops, so any global size can be used; the tail (n % width)
+// is processed by scalar loads. Operation is selected by OP macro:
+//   -D VAR_TYPE=float -D VECTOR_WIDTH=8 -D OP=OP_AXPY
+
+#ifndef VAR_TYPE
+#define VAR_TYPE int
+#endif  // VAR_TYPE
+
+#ifndef VECTOR_WIDTH
+#define VECTOR_WIDTH 4
+#endif  // VECTOR_WIDTH
+
+// a, b, c are elements (or vectors) of operands, alpha is scalar argument
+#define OP_ADD 1      // a + b
+#define OP_SUB 2      // a - b
+#define OP_MUL 3      // a * b
+#define OP_DIV 4      // a / b
+#define OP_MIN 5      // min(a, b)
+#define OP_MAX 6      // max(a, b)
+#define OP_SCALE 7    // alpha * a
+#define OP_AXPY 8     // alpha * a + b
+#define OP_MULADD 9   // a * b + c
+
+#ifndef OP
+#define OP OP_ADD
+#endif  // OP
+
+#if OP == OP_ADD
+#define APPLY(a, b, c, alpha) ((a) + (b))
+#elif OP == OP_SUB
+#define APPLY(a, b, c, alpha) ((a) - (b))
+#elif OP == OP_MUL
+#define APPLY(a, b, c, alpha) ((a) * (b))
+#elif OP == OP_DIV
+#define APPLY(a, b, c, alpha) ((a) / (b))
+#elif OP == OP_MIN
+#define APPLY(a, b, c, alpha) min((a), (b))
+#elif OP == OP_MAX
+#define APPLY(a, b, c, alpha) max((a), (b))
+#elif OP == OP_SCALE
+#define APPLY(a, b, c, alpha) ((alpha) * (a))
+#elif OP == OP_AXPY
+#define APPLY(a, b, c, alpha) ((alpha) * (a) + (b))
+#elif OP == OP_MULADD
+#define APPLY(a, b, c, alpha) ((a) * (b) + (c))
+#else
+#error "unknown elementwise operation"
+#endif
+
+#define CONCAT_IMPL(a, b) a##b
+#define CONCAT(a, b) CONCAT_IMPL(a, b)
+#define VEC_TYPE CONCAT(VAR_TYPE, VECTOR_WIDTH)
+#define VLOAD CONCAT(vload, VECTOR_WIDTH)
+#define VSTORE CONCAT(vstore, VECTOR_WIDTH)
+
+__kernel void map_unary(__global const VAR_TYPE *A, __global VAR_TYPE *C,
+                        const VAR_TYPE alpha, const int n) {
+  int vectors = n / VECTOR_WIDTH;
+  for (int v = get_global_id(0); v < vectors; v += get_global_size(0)) {
+    VEC_TYPE a = VLOAD(v, A);
+    VSTORE(APPLY(a, a, a, alpha), v, C);
+  }
+  for (int i = vectors * VECTOR_WIDTH + get_global_id(0); i < n;
+       i += get_global_size(0)) {
+    C[i] = APPLY(A[i], A[i], A[i], alpha);
+  }
+}
+
+__kernel void map_binary(__global const VAR_TYPE *A,
+                         __global const VAR_TYPE *B, __global VAR_TYPE *C,
+                         const VAR_TYPE alpha, const int n) {
+  int vectors = n / VECTOR_WIDTH;
+  for (int v = get_global_id(0); v < vectors; v += get_global_size(0)) {
+    VEC_TYPE a = VLOAD(v, A);
+    VEC_TYPE b = VLOAD(v, B);
+    VSTORE(APPLY(a, b, a, alpha), v, C);
+  }
+  for (int i = vectors * VECTOR_WIDTH + get_global_id(0); i < n;
+       i += get_global_size(0)) {
+    C[i] = APPLY(A[i], B[i], A[i], alpha);
+  }
+}
+
+__kernel void map_ternary(__global const VAR_TYPE *A,
+                          __global const VAR_TYPE *B,
+                          __global const VAR_TYPE *D, __global VAR_TYPE *C,
+                          const VAR_TYPE alpha, const int n) {
+  int vectors = n / VECTOR_WIDTH;
+  for (int v = get_global_id(0); v < vectors; v += get_global_size(0)) {
+    VEC_TYPE a = VLOAD(v, A);
+    VEC_TYPE b = VLOAD(v, B);
+    VEC_TYPE d = VLOAD(v, D);
+    VSTORE(APPLY(a, b, d, alpha), v, C);
+  }
+  for (int i = vectors * VECTOR_WIDTH + get_global_id(0); i < n;
+       i += get_global_size(0)) {
+    C[i] = APPLY(A[i], B[i], D[i], alpha);
+  }
+}
+
+// Broadcast kernels apply binary operation to rows x cols matrix A and
+// vector V: V has <cols> elements in map_rows (the same vector for every
+// row) and <rows> elements in map_cols (one element for every row).
+__kernel void map_rows(__global const VAR_TYPE *A, __global const VAR_TYPE *V,
+                       __global VAR_TYPE *C, const VAR_TYPE alpha,
+                       const int rows, const int cols) {
+  for (int i = get_global_id(1); i < rows; i += get_global_size(1)) {
+    size_t offset = (size_t)i * cols;
+    for (int j = get_global_id(0); j < cols; j += get_global_size(0)) {
+      VAR_TYPE a = A[offset + j];
+      C[offset + j] = APPLY(a, V[j], a, alpha);
+    }
+  }
+}
+
+__kernel void map_cols(__global const VAR_TYPE *A, __global const VAR_TYPE *V,
+                       __global VAR_TYPE *C, const VAR_TYPE alpha,
+                       const int rows, const int cols) {
+  for (int i = get_global_id(1); i < rows; i += get_global_size(1)) {
+    size_t offset = (size_t)i * cols;
+    VAR_TYPE v = V[i];
+    for (int j = get_global_id(0); j < cols; j += get_global_size(0)) {
+      VAR_TYPE a = A[offset + j];
+      C[offset + j] = APPLY(a, v, a, alpha);
+    }
+  }
+}
+
+#undef VSTORE
+#undef VLOAD
+#undef VEC_TYPE
+#undef CONCAT
+#undef CONCAT_IMPL
+#undef APPLY
+#undef VECTOR_WIDTH
+#undef VAR_TYPE
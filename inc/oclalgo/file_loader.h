@@ -0,0 +1,190 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file file_loader.h
+ *  @brief Contains oclalgo::FileLoader class for asynchronous loading of
+ *  files to device memory.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  File is read by chunks with pread() by loader threads into a ring of
+ *  pinned (mapped CL_MEM_ALLOC_HOST_PTR) staging buffers, every chunk is
+ *  uploaded by non-blocking write as soon as it's read, so disk reads and
+ *  bus transfers overlap. Staging buffer is reused after its upload is
+ *  finished.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_FILE_LOADER_H_
+#define INC_OCLALGO_FILE_LOADER_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <oclalgo/future.h>
+#include <oclalgo/queue.h>
+
+namespace oclalgo {
+
+template <typename T> class DMatrix;
+
+namespace internal {
+struct LoadState;
+}  // namespace internal
+
+/** @brief Parameters of FileLoader. */
+struct FileLoaderOptions {
+  /** @brief Size of chunks read and uploaded at once (bytes). */
+  size_t chunk_size = 8 << 20;
+  /** @brief Number of pinned staging buffers of chunk_size bytes. */
+  int staging_buffers = 4;
+  /** @brief Number of threads reading chunks. */
+  int threads = 2;
+};
+
+/*!
+ * @brief Progress of file loading started by FileLoader::Load().
+ *
+ * Futures of chunks and of the whole load are based on OpenCL user events,
+ * so they can be passed as dependencies to Queue::EnqueueTask(): kernels
+ * can process the first chunks while the rest of file is loaded (chunks
+ * are uploaded by own command queue of loader, so tasks waiting for them
+ * don't block uploads). If file read fails, the events get error status
+ * and futures throw cl::Error.
+ */
+class FileLoad {
+ public:
+  /** @brief Returns number of loaded bytes. */
+  size_t size() const;
+  /** @brief Returns number of bytes already uploaded to device. */
+  size_t uploaded() const;
+  /** @brief Returns number of chunks. */
+  int chunks() const;
+  /** @brief Returns byte offset of chunk in destination buffer. */
+  size_t chunk_offset(int chunk) const;
+  /** @brief Returns future of destination buffer completed with load. */
+  oclalgo::future<cl::Buffer> done() const;
+  /** @brief Returns future completed when chunk is uploaded. */
+  oclalgo::future<cl::Buffer> chunk(int chunk) const;
+  /** @brief Returns description of the first read error (or empty). */
+  std::string error() const;
+
+ private:
+  friend class FileLoader;
+  explicit FileLoad(const std::shared_ptr<internal::LoadState>& state)
+      : state_(state) {
+  }
+
+  std::shared_ptr<internal::LoadState> state_;
+};
+
+/*!
+ * @brief Loader of files to device buffers.
+ *
+ * Loads of one loader share its threads, staging buffers and transfer
+ * command queue (created on context and device of Queue) and are served in
+ * order of Load() calls. Destructor waits for started loads.
+ */
+class FileLoader {
+ public:
+  explicit FileLoader(const Queue* queue,
+                      const FileLoaderOptions& options = FileLoaderOptions());
+  FileLoader(const FileLoader&) = delete;
+  FileLoader& operator=(const FileLoader&) = delete;
+  virtual ~FileLoader();
+
+  /*!
+   * @brief Starts loading <i>size</i> bytes of file from
+   * <i>file_offset</i> to <i>buffer</i> at <i>buffer_offset</i>.
+   *
+   * Throws std::system_error if file can't be opened.
+   */
+  FileLoad Load(const std::string& path, const cl::Buffer& buffer,
+                size_t size, size_t file_offset = 0,
+                size_t buffer_offset = 0);
+
+  /*!
+   * @brief Starts loading data of matrix <i>m</i> (rows * cols elements of
+   * type T) from file at <i>file_offset</i>.
+   */
+  template <typename T>
+  FileLoad Load(const std::string& path, const DMatrix<T>& m,
+                size_t file_offset = 0) {
+    return Load(path, m.buffer(), m.rows() * m.cols() * sizeof(T),
+                file_offset);
+  }
+
+ private:
+  struct Slot {
+    cl::Buffer pinned;
+    void* ptr;
+    cl::Event upload;
+  };
+  struct Job {
+    std::shared_ptr<internal::LoadState> state;
+    int chunk;
+  };
+
+  void WorkerLoop();
+  void ReadChunk(const Job& job);
+  int AcquireSlot();
+  void ReleaseSlot(int slot);
+
+  const Queue* queue_;
+  cl::CommandQueue transfer_queue_;
+  FileLoaderOptions options_;
+  std::vector<Slot> slots_;
+  std::vector<int> free_slots_;
+  std::deque<Job> jobs_;
+  std::mutex mutex_;
+  std::condition_variable jobs_ready_;
+  std::condition_variable slot_ready_;
+  bool stop_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_FILE_LOADER_H_
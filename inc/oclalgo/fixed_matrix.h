@@ -0,0 +1,375 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file fixed_matrix.h
+ *  @brief Contains oclalgo::FixedMatrix class for small host matrices.
+ *  @author Dmitry Senin <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Elements are stored inline (row-major), dimensions are template
+ *  parameters and loops of operations are unrolled at compile time, so
+ *  compiler vectorizes them without heap allocations and virtual calls.
+ *  Batches of fixed matrices are converted to oclalgo::Matrix with one
+ *  matrix per row (see BatchSpan() and UnpackBatch()), the same layout is used
+ *  for DMatrix batches.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_FIXED_MATRIX_H_
+#define INC_OCLALGO_FIXED_MATRIX_H_
+
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+
+#include <oclalgo/matrix.h>
+#include <oclalgo/matrix_view.h>
+
+namespace oclalgo {
+
+namespace internal {
+
+// operations on N elements without loops (recursion is inlined)
+template <int N>
+struct Unrolled {
+  template <typename T>
+  static void Fill(T* dst, T value) noexcept {
+    Unrolled<N - 1>::Fill(dst, value);
+    dst[N - 1] = value;
+  }
+  template <typename T, typename U>
+  static void Copy(T* dst, const U* src) noexcept {
+    Unrolled<N - 1>::Copy(dst, src);
+    dst[N - 1] = src[N - 1];
+  }
+  template <typename T>
+  static void Add(T* dst, const T* src) noexcept {
+    Unrolled<N - 1>::Add(dst, src);
+    dst[N - 1] += src[N - 1];
+  }
+  template <typename T>
+  static void Sub(T* dst, const T* src) noexcept {
+    Unrolled<N - 1>::Sub(dst, src);
+    dst[N - 1] -= src[N - 1];
+  }
+  template <typename T>
+  static void Scale(T* dst, T value) noexcept {
+    Unrolled<N - 1>::Scale(dst, value);
+    dst[N - 1] *= value;
+  }
+  // dst = a * x
+  template <typename T>
+  static void Scaled(T* dst, T a, const T* x) noexcept {
+    Unrolled<N - 1>::Scaled(dst, a, x);
+    dst[N - 1] = a * x[N - 1];
+  }
+  // dst += a * x
+  template <typename T>
+  static void Axpy(T* dst, T a, const T* x) noexcept {
+    Unrolled<N - 1>::Axpy(dst, a, x);
+    dst[N - 1] += a * x[N - 1];
+  }
+  template <typename T>
+  static bool Equal(const T* a, const T* b) noexcept {
+    return Unrolled<N - 1>::Equal(a, b) && a[N - 1] == b[N - 1];
+  }
+};
+
+template <>
+struct Unrolled<0> {
+  template <typename T> static void Fill(T*, T) noexcept {}
+  template <typename T, typename U> static void Copy(T*, const U*) noexcept {}
+  template <typename T> static void Add(T*, const T*) noexcept {}
+  template <typename T> static void Sub(T*, const T*) noexcept {}
+  template <typename T> static void Scale(T*, T) noexcept {}
+  template <typename T> static void Scaled(T*, T, const T*) noexcept {}
+  template <typename T> static void Axpy(T*, T, const T*) noexcept {}
+  template <typename T> static bool Equal(const T*, const T*) noexcept {
+    return true;
+  }
+};
+
+// row * m2 for K rows of m2 with C columns: dst = sum of a[k] * m2.row(k)
+template <int K, int C>
+struct RowProduct {
+  template <typename T>
+  static void Run(T* dst, const T* a, const T* m2) noexcept {
+    RowProduct<K - 1, C>::Run(dst, a, m2);
+    Unrolled<C>::Axpy(dst, a[K - 1], m2 + (K - 1) * C);
+  }
+};
+
+template <int C>
+struct RowProduct<1, C> {
+  template <typename T>
+  static void Run(T* dst, const T* a, const T* m2) noexcept {
+    Unrolled<C>::Scaled(dst, a[0], m2);
+  }
+};
+
+// R rows of product
+template <int R, int K, int C>
+struct Product {
+  template <typename T>
+  static void Run(T* dst, const T* m1, const T* m2) noexcept {
+    Product<R - 1, K, C>::Run(dst, m1, m2);
+    RowProduct<K, C>::Run(dst + (R - 1) * C, m1 + (R - 1) * K, m2);
+  }
+};
+
+template <int K, int C>
+struct Product<0, K, C> {
+  template <typename T>
+  static void Run(T*, const T*, const T*) noexcept {}
+};
+
+}  // namespace internal
+
+/*!
+ * @brief Template matrix class with compile-time numbers of rows and
+ * columns.
+ *
+ * Storage is aligned to 16 bytes if its size is a multiple of 16 bytes.
+ */
+template <typename T, int R, int C>
+class FixedMatrix {
+  static_assert(R > 0 && C > 0, "matrix dimensions must be positive");
+
+ public:
+  typedef T value_type;
+
+  /** @brief Creates matrix with uninitialized elements. */
+  FixedMatrix() = default;
+  /** @brief Creates matrix with all elements equal to <i>value</i>. */
+  explicit FixedMatrix(T value) noexcept {
+    internal::Unrolled<R * C>::Fill(data_, value);
+  }
+  /** @brief Creates matrix by copying elements of matrix span or view. */
+  explicit FixedMatrix(const MatrixSpan<const T>& m) noexcept;
+  /** @brief Creates matrix by copying elements of host matrix. */
+  explicit FixedMatrix(const Matrix<T>& m) noexcept
+      : FixedMatrix(MatrixSpan<const T>(m.view())) {
+  }
+
+  /** @brief Returns identity matrix. */
+  static FixedMatrix<T, R, C> Identity() noexcept;
+
+  /** @brief Returns number of rows in matrix. */
+  constexpr static int rows() noexcept { return R; }
+  /** @brief Returns number of columns in matrix. */
+  constexpr static int cols() noexcept { return C; }
+  /** @brief Returns number of elements in matrix. */
+  constexpr static int size() noexcept { return R * C; }
+
+  /** @brief Returns pointer to row-major elements of matrix. */
+  T* data() noexcept { return data_; }
+  /** @brief Returns pointer to row-major elements of matrix. */
+  const T* data() const noexcept { return data_; }
+
+  /*!
+   * @brief Returns matrix element in position (i, j).
+   *
+   * i is in range [0, R - 1]
+   * j is in range [0, C - 1]
+   */
+  const T& operator()(int i, int j) const noexcept {
+    return data_[i * C + j];
+  }
+  /** @brief Returns reference to matrix element in position (i, j). */
+  T& operator()(int i, int j) noexcept { return data_[i * C + j]; }
+
+  /** @brief Returns span of matrix elements. */
+  MatrixSpan<T> span() noexcept { return MatrixSpan<T>(data_, R, C); }
+  /** @brief Returns span of matrix elements. */
+  MatrixSpan<const T> span() const noexcept {
+    return MatrixSpan<const T>(data_, R, C);
+  }
+  /** @brief Returns host matrix with copy of elements. */
+  Matrix<T> ToMatrix() const;
+
+  /** @brief Returns transposed matrix. */
+  FixedMatrix<T, C, R> transposed() const noexcept;
+
+  FixedMatrix<T, R, C>& operator+=(const FixedMatrix<T, R, C>& m) noexcept {
+    internal::Unrolled<R * C>::Add(data_, m.data_);
+    return *this;
+  }
+  FixedMatrix<T, R, C>& operator-=(const FixedMatrix<T, R, C>& m) noexcept {
+    internal::Unrolled<R * C>::Sub(data_, m.data_);
+    return *this;
+  }
+  FixedMatrix<T, R, C>& operator*=(T value) noexcept {
+    internal::Unrolled<R * C>::Scale(data_, value);
+    return *this;
+  }
+
+ private:
+  constexpr static size_t alignment =
+      R * C * sizeof(T) % 16 == 0 ? 16 : alignof(T);
+
+  alignas(alignment) T data_[R * C];
+};
+
+template <typename T, int R, int C>
+FixedMatrix<T, R, C>::FixedMatrix(const MatrixSpan<const T>& m) noexcept {
+  assert(m.rows() == R && m.cols() == C);
+  for (int i = 0; i < R; ++i)
+    for (int j = 0; j < C; ++j)
+      data_[i * C + j] = m(i, j);
+}
+
+template <typename T, int R, int C>
+FixedMatrix<T, R, C> FixedMatrix<T, R, C>::Identity() noexcept {
+  FixedMatrix<T, R, C> res(T(0));
+  for (int i = 0; i < R && i < C; ++i)
+    res(i, i) = T(1);
+  return res;
+}
+
+template <typename T, int R, int C>
+Matrix<T> FixedMatrix<T, R, C>::ToMatrix() const {
+  Matrix<T> res(R, C);
+  T* dst = res.data().get_raw();
+  internal::Unrolled<R * C>::Copy(dst, data_);
+  return res;
+}
+
+template <typename T, int R, int C>
+FixedMatrix<T, C, R> FixedMatrix<T, R, C>::transposed() const noexcept {
+  FixedMatrix<T, C, R> res;
+  for (int i = 0; i < R; ++i)
+    for (int j = 0; j < C; ++j)
+      res(j, i) = (*this)(i, j);
+  return res;
+}
+
+template <typename T, int R, int C>
+FixedMatrix<T, R, C> operator+(FixedMatrix<T, R, C> m1,
+                               const FixedMatrix<T, R, C>& m2) noexcept {
+  return m1 += m2;
+}
+
+template <typename T, int R, int C>
+FixedMatrix<T, R, C> operator-(FixedMatrix<T, R, C> m1,
+                               const FixedMatrix<T, R, C>& m2) noexcept {
+  return m1 -= m2;
+}
+
+template <typename T, int R, int C>
+FixedMatrix<T, R, C> operator*(FixedMatrix<T, R, C> m, T value) noexcept {
+  return m *= value;
+}
+
+template <typename T, int R, int C>
+FixedMatrix<T, R, C> operator*(T value, FixedMatrix<T, R, C> m) noexcept {
+  return m *= value;
+}
+
+/*!
+ * @brief Returns product of fixed matrices.
+ *
+ * Row i of result is accumulated as sum of rows of m2 scaled by m1(i, k), so
+ * operations on rows are vectorized.
+ */
+template <typename T, int R, int K, int C>
+FixedMatrix<T, R, C> operator*(const FixedMatrix<T, R, K>& m1,
+                               const FixedMatrix<T, K, C>& m2) noexcept {
+  FixedMatrix<T, R, C> res;
+  internal::Product<R, K, C>::Run(res.data(), m1.data(), m2.data());
+  return res;
+}
+
+template <typename T, int R, int C>
+bool operator==(const FixedMatrix<T, R, C>& m1,
+                const FixedMatrix<T, R, C>& m2) noexcept {
+  return internal::Unrolled<R * C>::Equal(m1.data(), m2.data());
+}
+
+template <typename T, int R, int C>
+bool operator!=(const FixedMatrix<T, R, C>& m1,
+                const FixedMatrix<T, R, C>& m2) noexcept {
+  return !(m1 == m2);
+}
+
+/*!
+ * @brief Returns span of batch of <i>count</i> fixed matrices.
+ *
+ * Row n of span contains row-major elements of matrix n (padding of aligned
+ * matrices is skipped by leading dimension), so batch is converted to
+ * Matrix or uploaded to DMatrix without intermediate copies.
+ */
+template <typename T, int R, int C>
+MatrixSpan<const T> BatchSpan(const FixedMatrix<T, R, C>* batch,
+                              size_t count) noexcept {
+  static_assert(sizeof(FixedMatrix<T, R, C>) % sizeof(T) == 0,
+                "fixed matrix size must be a multiple of element size");
+  const int ld = sizeof(FixedMatrix<T, R, C>) / sizeof(T);
+  return MatrixSpan<const T>(batch->data(), static_cast<int>(count), R * C,
+                             ld);
+}
+
+/*!
+ * @brief Copies rows of host matrix (batch with one matrix per row) to
+ * array of fixed matrices.
+ */
+template <typename T, int R, int C>
+void UnpackBatch(
+    const MatrixSpan<const typename FixedMatrix<T, R, C>::value_type>& batch,
+    FixedMatrix<T, R, C>* out) {
+  assert(batch.cols() == R * C);
+  ParallelChunks(out, batch.rows(), [&batch, out](size_t first, size_t last) {
+    for (size_t n = first; n < last; ++n) {
+      T* dst = out[n].data();
+      const int row = static_cast<int>(n);
+      for (int k = 0; k < R * C; ++k)
+        dst[k] = batch(row, k);
+    }
+  });
+}
+
+template <typename T, int R, int C>
+std::ostream& operator<<(std::ostream& out, const FixedMatrix<T, R, C>& m) {
+  for (int i = 0; i < R; ++i) {
+    for (int j = 0; j < C; ++j)
+      out << m(i, j) << "\t";
+    out << std::endl;
+  }
+  return out;
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_FIXED_MATRIX_H_
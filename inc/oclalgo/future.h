@@ -32,7 +32,7 @@
  */
 
 /*! @file future.h
- *  @brief Contains oclalgo::future class.
+ *  @brief Contains oclalgo::future and oclalgo::WaitList classes.
  *  @author Senin Dmitry <d.senin@samsung.com>
  *  @version 1.0
  *
@@ -46,6 +46,8 @@
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.hpp>
 
+#include <array>
+#include <utility>
 #include <vector>
 
 namespace oclalgo {
@@ -76,7 +78,7 @@ class future {
   /** @brief Stop host thread and wait the end of corresponding task. */
   void wait() const;
 
-  cl::Event event() const noexcept { return event_; }
+  const cl::Event& event() const noexcept { return event_; }
 
  private:
   T future_result_;
@@ -97,6 +99,17 @@ future<T>::future(future&& f)
   f.event_ = cl::Event();
 }
 
+template <typename T>
+future<T>& future<T>::operator=(future&& f) {
+  if (this != &f) {
+    future_result_ = std::move(f.future_result_);
+    event_ = f.event_;
+    f.future_result_ = T();
+    f.event_ = cl::Event();
+  }
+  return *this;
+}
+
 template <typename T>
 T future<T>::get() {
   if (event_()) {
@@ -115,6 +128,84 @@ void future<T>::wait() const {
     throw cl::Error(CL_INVALID_EVENT, "null event in future::wait()");
 }
 
+/*!
+ * @brief List of OpenCL events to wait before enqueued command.
+ *
+ * Stores up to <i>inline_capacity</i> event handles without heap
+ * allocations. Handles aren't retained: events must be kept alive by their
+ * owners (futures) while the list is used.
+ */
+class WaitList {
+ public:
+  constexpr static size_t inline_capacity = 8;
+
+  WaitList() noexcept : size_(0) {}
+
+  WaitList(const WaitList&) = delete;
+  WaitList& operator=(const WaitList&) = delete;
+
+  /** @brief Appends event to the list (null events are skipped). */
+  void push_back(const cl::Event& event) {
+    if (event() == nullptr) return;
+    if (size_ < inline_capacity) {
+      inline_[size_] = event();
+    } else {
+      if (heap_.empty())
+        heap_.assign(inline_.begin(), inline_.end());
+      heap_.push_back(event());
+    }
+    ++size_;
+  }
+
+  /** @brief Returns number of events in the list. */
+  cl_uint size() const noexcept { return static_cast<cl_uint>(size_); }
+  /** @brief Returns true if the list is empty. */
+  bool empty() const noexcept { return size_ == 0; }
+  /** @brief Returns array of event handles (nullptr for empty list). */
+  const cl_event* data() const noexcept {
+    if (size_ == 0) return nullptr;
+    return size_ <= inline_capacity ? inline_.data() : heap_.data();
+  }
+
+ private:
+  std::array<cl_event, inline_capacity> inline_;
+  std::vector<cl_event> heap_;
+  size_t size_;
+};
+
+inline void AppendEvents(WaitList* /*list*/) {
+}
+
+inline void AppendEvents(WaitList* list, const cl::Event& event) {
+  list->push_back(event);
+}
+
+inline void AppendEvents(WaitList* list, const std::vector<cl::Event>& events) {
+  for (const cl::Event& event : events)
+    list->push_back(event);
+}
+
+template <typename T>
+void AppendEvents(WaitList* list, const future<T>& f) {
+  list->push_back(f.event());
+}
+
+template <typename T>
+void AppendEvents(WaitList* list, const std::vector<future<T>>& futures) {
+  for (const future<T>& f : futures)
+    list->push_back(f.event());
+}
+
+/*!
+ * @brief Appends events of futures, events and vectors of them to wait
+ * list.
+ */
+template <typename First, typename... Tail>
+void AppendEvents(WaitList* list, const First& first, const Tail&... tail) {
+  AppendEvents(list, first);
+  AppendEvents(list, tail...);
+}
+
 }  // namespace oclalgo
 
 #endif  // INC_OCLALGO_FUTURE_H_
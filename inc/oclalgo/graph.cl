@@ -0,0 +1,199 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// Kernels of graph algorithms over CSR adjacency (graph.h). Out-edges of
+// vertex v are col_idx[row_ptr[v]..row_ptr[v + 1]), in-edges are stored in
+// the same way in in_ptr/in_idx. Levels of BFS are -1 for unvisited
+// vertices. counters[0] is size of the next frontier, counters[1] is number
+// of out-edges of the next frontier.
+
+#ifndef VAR_TYPE
+#define VAR_TYPE float
+#endif  // VAR_TYPE
+
+#ifndef GROUP_SIZE
+#define GROUP_SIZE 256
+#endif  // GROUP_SIZE
+
+#ifndef LANES
+#define LANES 32
+#endif  // LANES
+
+__kernel void graph_fill(__global int *a, const int value, const int n) {
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    a[i] = value;
+}
+
+__kernel void bfs_init(__global int *levels, __global int *frontier,
+                       const int n, const int source) {
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    levels[i] = i == source ? 0 : -1;
+  if (get_global_id(0) == 0)
+    frontier[0] = source;
+}
+
+// Marks the vertex found from frontier of level <depth> and appends it to
+// the next frontier (if <next> isn't null).
+inline void bfs_visit(__global const int *row_ptr, __global int *next,
+                      __global int *counters, int v) {
+  if (next)
+    next[atomic_inc(&counters[0])] = v;
+  else
+    atomic_inc(&counters[0]);
+  atomic_add(&counters[1], row_ptr[v + 1] - row_ptr[v]);
+}
+
+// Top-down step: LANES work-items scan out-edges of every frontier vertex
+// and claim unvisited neighbours with atomic_cmpxchg.
+__kernel void bfs_top_down(__global const int *row_ptr,
+                           __global const int *col_idx,
+                           __global int *levels,
+                           __global const int *frontier,
+                           const int frontier_size, __global int *next,
+                           __global int *counters, const int depth) {
+  int lane = get_global_id(0) % LANES;
+  for (int i = get_global_id(0) / LANES; i < frontier_size;
+       i += get_global_size(0) / LANES) {
+    int v = frontier[i];
+    for (int e = row_ptr[v] + lane; e < row_ptr[v + 1]; e += LANES) {
+      int u = col_idx[e];
+      if (levels[u] == -1 && atomic_cmpxchg(&levels[u], -1, depth + 1) == -1)
+        bfs_visit(row_ptr, next, counters, u);
+    }
+  }
+}
+
+// Bottom-up step: every unvisited vertex looks for a parent of level
+// <depth> among its in-edges and stops at the first one.
+__kernel void bfs_bottom_up(__global const int *in_ptr,
+                            __global const int *in_idx,
+                            __global const int *row_ptr, __global int *levels,
+                            __global int *counters, const int n,
+                            const int depth) {
+  for (int v = get_global_id(0); v < n; v += get_global_size(0)) {
+    if (levels[v] != -1)
+      continue;
+    for (int e = in_ptr[v]; e < in_ptr[v + 1]; ++e) {
+      if (levels[in_idx[e]] == depth) {
+        levels[v] = depth + 1;
+        bfs_visit(row_ptr, 0, counters, v);
+        break;
+      }
+    }
+  }
+}
+
+// Gathers vertices of level <depth> to frontier (counters[0] is its size).
+__kernel void bfs_collect(__global const int *levels, __global int *frontier,
+                          __global int *counters, const int n,
+                          const int depth) {
+  for (int v = get_global_id(0); v < n; v += get_global_size(0)) {
+    if (levels[v] == depth)
+      frontier[atomic_inc(&counters[0])] = v;
+  }
+}
+
+// Writes sums of a and b over work-group to P[2 * group] and
+// P[2 * group + 1] (layout of reduce_partials in solvers.cl).
+inline void store_partials(__local VAR_TYPE *part_a, __local VAR_TYPE *part_b,
+                           VAR_TYPE a, VAR_TYPE b, __global VAR_TYPE *P) {
+  int lid = get_local_id(0);
+  part_a[lid] = a;
+  part_b[lid] = b;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int s = GROUP_SIZE / 2; s > 0; s >>= 1) {
+    if (lid < s) {
+      part_a[lid] += part_a[lid + s];
+      part_b[lid] += part_b[lid + s];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  if (lid == 0) {
+    P[2 * get_group_id(0)] = part_a[0];
+    P[2 * get_group_id(0) + 1] = part_b[0];
+  }
+}
+
+__kernel void pagerank_init(__global VAR_TYPE *rank, const int n) {
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    rank[i] = (VAR_TYPE)1 / n;
+}
+
+// contrib = rank / out-degree, partial sums of rank of dangling vertices
+// (without out-edges).
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void pagerank_contrib(__global const int *row_ptr,
+                      __global const VAR_TYPE *rank,
+                      __global VAR_TYPE *contrib, __global VAR_TYPE *P,
+                      const int n) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  VAR_TYPE dangling = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    int degree = row_ptr[i + 1] - row_ptr[i];
+    contrib[i] = degree > 0 ? rank[i] / degree : 0;
+    if (degree == 0)
+      dangling += rank[i];
+  }
+  store_partials(part_a, part_b, dangling, 0, P);
+}
+
+// rank = (1 - damping) / n + damping * (y + dangling / n), where y is sum of
+// contributions of in-edges and dangling is S[0]; partial sums of
+// |rank_new - rank|.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void pagerank_update(__global const VAR_TYPE *y, __global VAR_TYPE *rank,
+                     __global const VAR_TYPE *S, __global VAR_TYPE *P,
+                     const int n, const VAR_TYPE damping) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  VAR_TYPE base = (1 - damping + damping * S[0]) / n;
+  VAR_TYPE delta = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    VAR_TYPE value = base + damping * y[i];
+    delta += fabs(value - rank[i]);
+    rank[i] = value;
+  }
+  store_partials(part_a, part_b, delta, 0, P);
+}
+
+#undef LANES
+#undef GROUP_SIZE
+#undef VAR_TYPE
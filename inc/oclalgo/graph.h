@@ -0,0 +1,358 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file graph.h
+ *  @brief Contains oclalgo::CsrGraph class, breadth-first search and
+ *  PageRank.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Graph, levels and ranks stay in device memory. BFS reads two counters
+ *  (size and out-edges of the next frontier) per level to choose direction
+ *  of the next step, PageRank reads rank change asynchronously like
+ *  solvers (see solvers.h). Kernels are in graph.cl and sparse.cl.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_GRAPH_H_
+#define INC_OCLALGO_GRAPH_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <oclalgo/dmatrix.h>
+#include <oclalgo/solvers.h>
+
+namespace oclalgo {
+
+/*!
+ * @brief Directed graph in device memory: CSR adjacency of out-edges and
+ * of in-edges (the latter is used by bottom-up BFS and PageRank).
+ *
+ * Numbers of vertices and edges are less than 2^31.
+ */
+class CsrGraph {
+ public:
+  CsrGraph() : vertices_(0), edges_(0) {}
+
+  /*!
+   * @brief Builds graph of <i>vertices</i> vertices from list of directed
+   * edges (from, to). Undirected graph is given by edges of both
+   * directions.
+   */
+  static CsrGraph FromEdges(int vertices,
+                            const std::vector<std::pair<int, int>>& edges);
+
+  int vertices() const noexcept { return vertices_; }
+  int edges() const noexcept { return edges_; }
+  /** @brief Returns out-edge offsets of vertices (vertices() + 1 ints). */
+  const cl::Buffer& row_ptr() const noexcept { return row_ptr_; }
+  /** @brief Returns destinations of out-edges (edges() ints). */
+  const cl::Buffer& col_idx() const noexcept { return col_idx_; }
+  /** @brief Returns in-edge offsets of vertices (vertices() + 1 ints). */
+  const cl::Buffer& in_ptr() const noexcept { return in_ptr_; }
+  /** @brief Returns sources of in-edges (edges() ints). */
+  const cl::Buffer& in_idx() const noexcept { return in_idx_; }
+
+ private:
+  int vertices_;
+  int edges_;
+  cl::Buffer row_ptr_;
+  cl::Buffer col_idx_;
+  cl::Buffer in_ptr_;
+  cl::Buffer in_idx_;
+};
+
+/** @brief Direction of BFS steps. */
+enum class BfsDirection {
+  Auto,     ///< direction-optimizing switching of top-down and bottom-up
+  TopDown,  ///< frontier vertices visit their out-edges
+  BottomUp  ///< unvisited vertices look for parents among in-edges
+};
+
+/*!
+ * @brief Parameters of BFS.
+ *
+ * In Auto mode search switches to bottom-up when out-edges of frontier
+ * exceed unexplored edges / alpha and back to top-down when frontier
+ * becomes smaller than vertices / beta.
+ */
+struct BfsOptions {
+  BfsDirection direction = BfsDirection::Auto;
+  int alpha = 14;
+  int beta = 24;
+};
+
+/** @brief Result of BFS. */
+struct BfsResult {
+  /** @brief Levels of vertices (ints, -1 for unreachable vertices). */
+  cl::Buffer levels;
+  /** @brief Number of levels (the largest level + 1). */
+  int depth = 0;
+  /** @brief Number of reached vertices. */
+  int reached = 0;
+  int top_down_steps = 0;
+  int bottom_up_steps = 0;
+};
+
+/** @brief Breadth-first search from vertex <i>source</i>. */
+inline BfsResult BreadthFirstSearch(const CsrGraph& graph, int source,
+                                    const BfsOptions& options = BfsOptions());
+
+/** @brief Parameters of PageRank. */
+struct PageRankOptions {
+  double damping = 0.85;
+  int max_iterations = 100;
+  /** @brief Iterations stop when L1 norm of rank change is not greater. */
+  double tolerance = 1e-6;
+  /** @brief Number of iterations between reads of rank change. */
+  int check_every = 4;
+};
+
+/** @brief Result of PageRank. */
+template <typename T>
+struct PageRankResult {
+  /** @brief vertices x 1 matrix of ranks (their sum is 1). */
+  DMatrix<T> ranks;
+  int iterations = 0;
+  /** @brief The last read L1 norm of rank change. */
+  double delta = 0;
+  bool converged = false;
+};
+
+/*!
+ * @brief PageRank of graph vertices by power iteration (rank of dangling
+ * vertices is spread over all vertices).
+ *
+ * Every iteration is rank / out-degree and SpMV by in-edge adjacency.
+ */
+template <typename T>
+PageRankResult<T> PageRank(const CsrGraph& graph,
+                           const PageRankOptions& options = PageRankOptions());
+
+namespace internal {
+
+inline cl::Buffer UploadInts(const std::vector<int>& data) {
+  return Upload(data.empty() ? std::vector<int>(1, 0) : data);
+}
+
+/*!
+ * @brief Builds CSR offsets and indices of edges grouped by source
+ * (<i>by_source</i>) or by destination.
+ */
+inline void BuildCsr(int vertices,
+                     const std::vector<std::pair<int, int>>& edges,
+                     bool by_source, std::vector<int>* ptr,
+                     std::vector<int>* idx) {
+  ptr->assign(vertices + 1, 0);
+  for (const auto& e : edges)
+    ++(*ptr)[(by_source ? e.first : e.second) + 1];
+  for (int v = 0; v < vertices; ++v)
+    (*ptr)[v + 1] += (*ptr)[v];
+  std::vector<int> cursor(ptr->begin(), ptr->end() - 1);
+  idx->resize(edges.size());
+  for (const auto& e : edges) {
+    int key = by_source ? e.first : e.second;
+    (*idx)[cursor[key]++] = by_source ? e.second : e.first;
+  }
+}
+
+template <typename... Args>
+void RunGraphKernel(const char* kernel, const Grid& grid,
+                    const std::string& type, const Args&... args) {
+  Queue* queue = MatrixQueue::instance();
+  queue->EnqueueTask(queue->CreateTask("graph.cl", kernel,
+                                       SolverBuildOptions(type), args...),
+                     grid);
+}
+
+/** @brief Grid of LANES work-items per frontier vertex. */
+inline Grid FrontierGrid(int frontier_size) {
+  size_t items = std::min<size_t>(
+      static_cast<size_t>(frontier_size) * solver_lanes,
+      std::max<size_t>(solver_lanes, MaxWorkItems()) / solver_lanes *
+          solver_lanes);
+  return Grid(cl::NDRange(items));
+}
+
+inline std::pair<int, int> ReadCounters(const cl::Buffer& counters) {
+  int values[2];
+  MatrixQueue::instance()->queue().enqueueReadBuffer(
+      counters, CL_TRUE, 0, sizeof(values), values);
+  return std::make_pair(values[0], values[1]);
+}
+
+}  // namespace internal
+
+inline CsrGraph CsrGraph::FromEdges(
+    int vertices, const std::vector<std::pair<int, int>>& edges) {
+  assert(vertices > 0);
+  CsrGraph graph;
+  graph.vertices_ = vertices;
+  graph.edges_ = static_cast<int>(edges.size());
+  std::vector<int> ptr, idx;
+  internal::BuildCsr(vertices, edges, true, &ptr, &idx);
+  graph.row_ptr_ = internal::UploadInts(ptr);
+  graph.col_idx_ = internal::UploadInts(idx);
+  internal::BuildCsr(vertices, edges, false, &ptr, &idx);
+  graph.in_ptr_ = internal::UploadInts(ptr);
+  graph.in_idx_ = internal::UploadInts(idx);
+  return graph;
+}
+
+inline BfsResult BreadthFirstSearch(const CsrGraph& graph, int source,
+                                    const BfsOptions& options) {
+  int n = graph.vertices();
+  assert(source >= 0 && source < n);
+  Queue* queue = MatrixQueue::instance();
+  const std::string type = PrintType<float>();
+  BfsResult result;
+  result.levels = queue->CreateBuffer<int>(n, CL_MEM_READ_WRITE, "Graph");
+  cl::Buffer frontier = queue->CreateBuffer<int>(n, CL_MEM_READ_WRITE,
+                                                 "Graph");
+  cl::Buffer next = queue->CreateBuffer<int>(n, CL_MEM_READ_WRITE, "Graph");
+  cl::Buffer counters = queue->CreateBuffer<int>(2, CL_MEM_READ_WRITE,
+                                                 "Graph");
+  Grid vertex_grid = internal::StrideGrid(n);
+  Grid counter_grid = Grid(cl::NDRange(2));
+  internal::RunGraphKernel("bfs_init", vertex_grid, type, result.levels,
+                           frontier, n, source);
+
+  int source_edges[2];
+  queue->queue().enqueueReadBuffer(graph.row_ptr(), CL_TRUE,
+                                   source * sizeof(int), sizeof(source_edges),
+                                   source_edges);
+  // frontier size and its out-edges, edges of unvisited vertices
+  int frontier_size = 1;
+  long long frontier_edges = source_edges[1] - source_edges[0];
+  long long unexplored_edges = graph.edges() - frontier_edges;
+  bool bottom_up = options.direction == BfsDirection::BottomUp;
+  // frontier buffer is valid only after top-down steps
+  bool queue_valid = true;
+  result.reached = 1;
+  for (int depth = 0; frontier_size > 0; ++depth) {
+    if (options.direction == BfsDirection::Auto) {
+      if (!bottom_up) {
+        bottom_up = frontier_edges * options.alpha > unexplored_edges;
+      } else {
+        bottom_up = static_cast<long long>(frontier_size) * options.beta >=
+                    n;
+      }
+    }
+    if (!bottom_up && !queue_valid) {
+      internal::RunGraphKernel("graph_fill", counter_grid, type, counters, 0,
+                               2);
+      internal::RunGraphKernel("bfs_collect", vertex_grid, type,
+                               result.levels, frontier, counters, n, depth);
+    }
+    internal::RunGraphKernel("graph_fill", counter_grid, type, counters, 0,
+                             2);
+    if (bottom_up) {
+      internal::RunGraphKernel("bfs_bottom_up", vertex_grid, type,
+                               graph.in_ptr(), graph.in_idx(),
+                               graph.row_ptr(), result.levels, counters, n,
+                               depth);
+      ++result.bottom_up_steps;
+    } else {
+      internal::RunGraphKernel("bfs_top_down",
+                               internal::FrontierGrid(frontier_size), type,
+                               graph.row_ptr(), graph.col_idx(),
+                               result.levels, frontier, frontier_size, next,
+                               counters, depth);
+      std::swap(frontier, next);
+      ++result.top_down_steps;
+    }
+    queue_valid = !bottom_up;
+    std::pair<int, int> counts = internal::ReadCounters(counters);
+    frontier_size = counts.first;
+    frontier_edges = counts.second;
+    unexplored_edges -= frontier_edges;
+    result.reached += frontier_size;
+    result.depth = depth + 1;
+  }
+  return result;
+}
+
+template <typename T>
+PageRankResult<T> PageRank(const CsrGraph& graph,
+                           const PageRankOptions& options) {
+  static_assert(std::is_floating_point<T>::value,
+                "PageRank requires floating point ranks");
+  int n = graph.vertices();
+  Queue* queue = MatrixQueue::instance();
+  const std::string type = PrintType<T>();
+  internal::KrylovWorkspace<T> ws(n);
+  PageRankResult<T> result;
+  result.ranks = DMatrix<T>(n, 1);
+  cl::Buffer rank = result.ranks.buffer();
+  cl::Buffer contrib = ws.Allocate(n), y = ws.Allocate(n);
+  T damping = static_cast<T>(options.damping);
+  internal::RunGraphKernel("pagerank_init", ws.vector_grid(), type, rank, n);
+
+  auto check = [&](T delta) {
+    result.delta = delta;
+    result.converged = delta <= options.tolerance;
+    return result.converged || delta != delta;
+  };
+  result.iterations = internal::IterateLagged(
+      ws, options.max_iterations, options.check_every, [&]() {
+    internal::RunGraphKernel("pagerank_contrib", ws.partial_grid(), type,
+                             graph.row_ptr(), rank, contrib, ws.partials(),
+                             n);
+    ws.Reduce(0, 1);
+    queue->EnqueueTask(queue->CreateTask(
+        "sparse.cl", "csr_pattern_mv", internal::SolverBuildOptions(type),
+        graph.in_ptr(), graph.in_idx(), contrib, y, n),
+        internal::RowLaneGrid(n));
+    internal::RunGraphKernel("pagerank_update", ws.partial_grid(), type, y,
+                             rank, ws.scalars(), ws.partials(), n, damping);
+    ws.Reduce(2, 3);
+    return 2;  // L1 norm of rank change
+  }, check);
+  return result;
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_GRAPH_H_
@@ -0,0 +1,365 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file hetero_gemm.h
+ *  @brief Contains oclalgo::HeteroGemm class which computes matrix product
+ *  on host and OpenCL device together.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Rows of product are split into two panels: the top panel is computed on
+ *  device by matrix_mul_dims kernel, the bottom one by host threads of
+ *  ThreadPool while device works. The split is proportional to measured
+ *  rates of host and device (transfers included) and is refined by every
+ *  call, so it converges to equal finish times.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_HETERO_GEMM_H_
+#define INC_OCLALGO_HETERO_GEMM_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <oclalgo/dispatcher.h>
+#include <oclalgo/dmatrix.h>
+#include <oclalgo/thread_pool.h>
+
+namespace oclalgo {
+
+namespace internal {
+
+/*!
+ * @brief Computes product of row-major matrices a (rows x inner) and
+ * b (inner x cols) into c by threads of ThreadPool.
+ *
+ * Rows of c are accumulated by rows of b (inner loop is vectorized),
+ * inner dimension is blocked to keep rows of b in cache.
+ */
+template <typename T>
+void HostGemm(const T* a, const T* b, T* c, int rows, int inner, int cols) {
+  const int inner_block = std::max(1, (64 << 10) / static_cast<int>(
+      sizeof(T) * std::max(cols, 1)));
+  ThreadPool::instance()->ParallelFor(rows, [=](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i)
+      std::fill(c + i * cols, c + (i + 1) * cols, T(0));
+    for (int k0 = 0; k0 < inner; k0 += inner_block) {
+      int k1 = std::min(inner, k0 + inner_block);
+      for (size_t i = first; i < last; ++i) {
+        T* row = c + i * cols;
+        for (int k = k0; k < k1; ++k) {
+          const T scale = a[i * inner + k];
+          const T* b_row = b + static_cast<size_t>(k) * cols;
+          for (int j = 0; j < cols; ++j)
+            row[j] += scale * b_row[j];
+        }
+      }
+    }
+  }, 4);
+}
+
+/** @brief Host share of rows shared by HeteroGemm and its pending calls. */
+struct GemmSplit {
+  std::mutex mutex;
+  double host_share;
+  double smoothing;
+};
+
+/*!
+ * @brief Timings of one HeteroGemm call, the last finished panel updates
+ * the split.
+ */
+template <typename T>
+struct GemmCall {
+  GemmCall(const std::shared_ptr<GemmSplit>& split, double host_work,
+           double device_work)
+      : split(split),
+        host_work(host_work),
+        device_work(device_work),
+        start(std::chrono::steady_clock::now()) {
+  }
+
+  /*!
+   * @brief Records time of panel (zero if panel is empty or failed),
+   * split is updated when both panels are timed.
+   */
+  void Finish(Target target, double seconds) {
+    std::lock_guard<std::mutex> lock(split->mutex);
+    (target == Target::Host ? host_seconds : device_seconds) = seconds;
+    if (--pending > 0) return;
+    if (host_seconds > 0 && device_seconds > 0) {
+      double host_rate = host_work / host_seconds;
+      double device_rate = device_work / device_seconds;
+      double share = host_rate / (host_rate + device_rate);
+      split->host_share += split->smoothing * (share - split->host_share);
+    }
+    arrays.clear();
+  }
+
+  double Elapsed() const {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() -
+                                            start;
+    return elapsed.count();
+  }
+
+  std::shared_ptr<GemmSplit> split;
+  double host_work;
+  double device_work;
+  std::chrono::steady_clock::time_point start;
+  double host_seconds = 0;
+  double device_seconds = 0;
+  int pending = 2;
+  /** @brief Host arrays used by transfers of device panel. */
+  std::vector<shared_array<T>> arrays;
+};
+
+template <typename T>
+void CL_CALLBACK OnDevicePanel(cl_event /*event*/, cl_int status,
+                               void* user_data) {
+  auto call = static_cast<std::shared_ptr<GemmCall<T>>*>(user_data);
+  (*call)->Finish(Target::Device,
+                  status == CL_COMPLETE ? (*call)->Elapsed() : 0);
+  delete call;
+}
+
+/** @brief Releases host array after its transfer is finished. */
+template <typename T>
+void CL_CALLBACK ReleaseArray(cl_event /*event*/, cl_int /*status*/,
+                              void* user_data) {
+  delete static_cast<shared_array<T>*>(user_data);
+}
+
+}  // namespace internal
+
+/*!
+ * @brief Matrix product computed by host and device together.
+ *
+ * Multiply() enqueues device panel, computes host panel in calling thread
+ * (with ThreadPool) and returns future of the whole product, so it returns
+ * when the host part is finished. Instances can be used from several
+ * threads.
+ */
+template <typename T>
+class HeteroGemm {
+ public:
+  /*!
+   * @brief Creates driver with split predicted by profile of
+   * Dispatcher::instance() (host rate is multiplied by number of threads).
+   */
+  HeteroGemm() : HeteroGemm(InitialShare()) {
+  }
+
+  /*!
+   * @param host_share initial part of rows computed on host
+   * @param smoothing weight of new measurements of rates
+   */
+  explicit HeteroGemm(double host_share, double smoothing = 0.5)
+      : split_(std::make_shared<internal::GemmSplit>()) {
+    split_->host_share = std::min(std::max(host_share, 0.0), 1.0);
+    split_->smoothing = smoothing;
+  }
+
+  /** @brief Returns current part of rows computed on host. */
+  double host_share() const {
+    std::lock_guard<std::mutex> lock(split_->mutex);
+    return split_->host_share;
+  }
+
+  /*!
+   * @brief Returns number of product rows computed on host (device panel is
+   * rounded to work-group size).
+   */
+  int HostRows(int rows) const {
+    const int block = MatrixQueue::block_size;
+    int device = static_cast<int>((1 - host_share()) * rows / block + 0.5) *
+                 block;
+    return rows - std::min(device, rows);
+  }
+
+  /*!
+   * @brief Returns product of host matrices.
+   *
+   * Operands are uploaded by non-blocking writes and device panel is read
+   * directly into the result, so operands mustn't be changed until the
+   * future is completed.
+   */
+  oclalgo::future<Matrix<T>> Multiply(const Matrix<T>& m1,
+                                      const Matrix<T>& m2) {
+    assert(m1.cols() == m2.rows());
+    const int rows = m1.rows(), inner = m1.cols(), cols = m2.cols();
+    const int host_rows = HostRows(rows), device_rows = rows - host_rows;
+    Queue* queue = MatrixQueue::instance();
+    Matrix<T> result(rows, cols, queue->CreateStagingArray<T>(
+        static_cast<size_t>(rows) * cols));
+    auto call = std::make_shared<internal::GemmCall<T>>(
+        split_, 1.0 * host_rows * inner * cols,
+        1.0 * device_rows * inner * cols);
+
+    cl::Event event;
+    if (device_rows > 0) {
+      DMatrix<T> a(device_rows, inner), b(inner, cols);
+      a.UpdateData(MatrixSpan<const T>(
+          m1.view().block(0, 0, device_rows, inner)), BlockingType::Unblock);
+      b.UpdateData(MatrixSpan<const T>(m2.view()), BlockingType::Unblock);
+      BufferArg out = queue->CreateKernelArg<T>(
+          static_cast<size_t>(device_rows) * cols, ArgType::OUT,
+          "HeteroGemm");
+      internal::EnqueueMultiply<T>(a.buffer(), b.buffer(), out, device_rows,
+                                   inner, cols, KernelShape::Dynamic);
+      cl::CommandQueue cl_queue = queue->queue();
+      cl_queue.enqueueReadBuffer(out.data(), CL_FALSE, 0,
+                                 sizeof(T) * device_rows * cols,
+                                 result.data().get_raw(), nullptr, &event);
+      call->arrays = {m1.data(), m2.data(), result.data()};
+      event.setCallback(CL_COMPLETE, &internal::OnDevicePanel<T>,
+                        new std::shared_ptr<internal::GemmCall<T>>(call));
+      cl_queue.flush();
+    } else {
+      event = internal::CompletedEvent();
+      call->Finish(Target::Device, 0);
+    }
+
+    if (host_rows > 0) {
+      auto start = std::chrono::steady_clock::now();
+      size_t offset = static_cast<size_t>(device_rows);
+      internal::HostGemm(m1.data().get_raw() + offset * inner,
+                         m2.data().get_raw(),
+                         result.data().get_raw() + offset * cols, host_rows,
+                         inner, cols);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      call->Finish(Target::Host, elapsed.count());
+    } else {
+      call->Finish(Target::Host, 0);
+    }
+    return oclalgo::future<Matrix<T>>(std::move(result), event);
+  }
+
+  /*!
+   * @brief Returns product of device matrices.
+   *
+   * Operands of host panel are downloaded before device panel is enqueued,
+   * host panel of result is uploaded after it's computed.
+   */
+  oclalgo::future<DMatrix<T>> Multiply(const DMatrix<T>& m1,
+                                       const DMatrix<T>& m2) {
+    assert(m1.cols() == m2.rows());
+    const int rows = m1.rows(), inner = m1.cols(), cols = m2.cols();
+    if (rows == 0 || cols == 0) return EmptyResult<T>(rows, cols);
+    const int host_rows = HostRows(rows), device_rows = rows - host_rows;
+    Queue* queue = MatrixQueue::instance();
+    cl::CommandQueue cl_queue = queue->queue();
+    BufferArg out = AllocateResult<T>(static_cast<size_t>(rows) * cols,
+                                      "HeteroGemm");
+    auto call = std::make_shared<internal::GemmCall<T>>(
+        split_, 1.0 * host_rows * inner * cols,
+        1.0 * device_rows * inner * cols);
+
+    // queue is in-order: reads are enqueued before kernel to not wait for it
+    shared_array<T> a_host, b_host;
+    cl::Event a_read, b_read;
+    if (host_rows > 0) {
+      a_host = queue->CreateStagingArray<T>(
+          static_cast<size_t>(host_rows) * inner);
+      b_host = queue->CreateStagingArray<T>(
+          static_cast<size_t>(inner) * cols);
+      cl_queue.enqueueReadBuffer(m1.buffer(), CL_FALSE,
+                                 sizeof(T) * device_rows * inner,
+                                 sizeof(T) * host_rows * inner,
+                                 a_host.get_raw(), nullptr, &a_read);
+      cl_queue.enqueueReadBuffer(m2.buffer(), CL_FALSE, 0,
+                                 sizeof(T) * inner * cols, b_host.get_raw(),
+                                 nullptr, &b_read);
+    }
+    cl::Event event;
+    if (device_rows > 0) {
+      event = internal::EnqueueMultiply<T>(m1.buffer(), m2.buffer(), out,
+                                           device_rows, inner, cols,
+                                           KernelShape::Dynamic);
+      event.setCallback(CL_COMPLETE, &internal::OnDevicePanel<T>,
+                        new std::shared_ptr<internal::GemmCall<T>>(call));
+    } else {
+      call->Finish(Target::Device, 0);
+    }
+    cl_queue.flush();
+
+    if (host_rows > 0) {
+      auto start = std::chrono::steady_clock::now();
+      a_read.wait();
+      b_read.wait();
+      shared_array<T> c_host = queue->CreateStagingArray<T>(
+          static_cast<size_t>(host_rows) * cols);
+      internal::HostGemm(a_host.get_raw(), b_host.get_raw(),
+                         c_host.get_raw(), host_rows, inner, cols);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      call->Finish(Target::Host, elapsed.count());
+      // the write follows kernel, so its event completes the whole product
+      cl_queue.enqueueWriteBuffer(out.data(), CL_FALSE,
+                                  sizeof(T) * device_rows * cols,
+                                  sizeof(T) * host_rows * cols,
+                                  c_host.get_raw(), nullptr, &event);
+      event.setCallback(CL_COMPLETE, &internal::ReleaseArray<T>,
+                        new shared_array<T>(c_host));
+      cl_queue.flush();
+    } else {
+      call->Finish(Target::Host, 0);
+    }
+    DMatrix<T> result(rows, cols, out.data());
+    return oclalgo::future<DMatrix<T>>(std::move(result), event);
+  }
+
+ private:
+  static double InitialShare() {
+    DeviceProfile profile = Dispatcher::instance()->model()->profile();
+    int multiply = static_cast<int>(Operation::Multiply);
+    double host = profile.host_rate[multiply] * ThreadPool::instance()->size();
+    return host / (host + profile.device_rate[multiply]);
+  }
+
+  std::shared_ptr<internal::GemmSplit> split_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_HETERO_GEMM_H_
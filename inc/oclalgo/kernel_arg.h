@@ -36,6 +36,12 @@
  *  @author Senin Dmitry <d.senin@samsung.com>
  *  @version 1.0
  *
+ *  @section Notes
+ *  ArgTraits defines compile-time kind of each type accepted by Task:
+ *  buffers (BufferArg, cl::Buffer), SVM pointers (SvmArg), local memory
+ *  (LocalArg, cl::LocalSpaceArg) and scalars (POD types except pointers, passed
+ *  directly or as KernelArg).
+ *
  *  @section Copyright
  *  Copyright 2013 Samsung R&D Institute Russia
  */
@@ -46,6 +52,9 @@
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.hpp>
 
+#include <type_traits>
+#include <utility>
+
 namespace oclalgo {
 
 /** @brief Enum of allowed argument types for OpenCL kernel. */
@@ -74,8 +83,20 @@ struct KernelArg {
   ArgType arg_type_;
 };
 
+/*!
+ * @brief Shared virtual memory pointer passed to OpenCL kernel.
+ *
+ * On devices without SVM support (OpenCL 1.x) <i>ptr</i> is nullptr and
+ * kernel receives <i>buffer</i> created by host pointer.
+ */
+struct SvmPointer {
+  void* ptr;
+  cl::Buffer buffer;
+};
+
 typedef KernelArg<cl::Buffer> BufferArg;
 typedef KernelArg<cl::LocalSpaceArg> LocalArg;
+typedef KernelArg<SvmPointer> SvmArg;
 
 template <typename T>
 KernelArg<T>::KernelArg(const T& data, ArgType arg_type)
@@ -101,9 +122,149 @@ KernelArg<T>& KernelArg<T>::operator=(KernelArg<T>&& arg) {
     data_ = std::move(arg.data_);
     arg_type_ = arg.arg_type_;
   }
-  return this;
+  return *this;
+}
+
+/** @brief Enum of kinds of OpenCL kernel arguments. */
+enum class ArgKind { Buffer, Svm, Local, Scalar };
+
+/*!
+ * @brief Compile-time traits of kernel argument type.
+ *
+ * <i>kind</i> is the argument kind, <i>value_type</i> is the type passed to
+ * kernel and <i>may_output</i> is true if argument can be marked as output
+ * (OUT or IN_OUT).
+ */
+template <typename T>
+struct ArgTraits {
+  static_assert(std::is_pod<T>::value && !std::is_pointer<T>::value,
+                "unsupported kernel argument type: host pointers and "
+                "containers must be passed as buffers (BufferArg, SvmArg)");
+  typedef T value_type;
+  constexpr static ArgKind kind = ArgKind::Scalar;
+  constexpr static bool may_output = false;
+};
+
+template <typename T>
+struct ArgTraits<KernelArg<T>> : ArgTraits<T> {
+};
+
+template <>
+struct ArgTraits<cl::Buffer> {
+  typedef cl::Buffer value_type;
+  constexpr static ArgKind kind = ArgKind::Buffer;
+  constexpr static bool may_output = false;
+};
+
+template <>
+struct ArgTraits<BufferArg> : ArgTraits<cl::Buffer> {
+  constexpr static bool may_output = true;
+};
+
+template <>
+struct ArgTraits<SvmArg> {
+  typedef SvmPointer value_type;
+  constexpr static ArgKind kind = ArgKind::Svm;
+  constexpr static bool may_output = true;
+};
+
+template <>
+struct ArgTraits<cl::LocalSpaceArg> {
+  typedef cl::LocalSpaceArg value_type;
+  constexpr static ArgKind kind = ArgKind::Local;
+  constexpr static bool may_output = false;
+};
+
+template <>
+struct ArgTraits<LocalArg> : ArgTraits<cl::LocalSpaceArg> {
+};
+
+/** @brief Returns data of kernel argument. */
+template <typename T>
+const T& ArgData(const KernelArg<T>& arg) noexcept {
+  return arg.data();
+}
+
+/** @brief Returns data of kernel argument passed without KernelArg. */
+template <typename T>
+const T& ArgData(const T& arg) noexcept {
+  return arg;
+}
+
+/** @brief Returns true if kernel argument is marked as output. */
+template <typename T>
+bool IsOutputArg(const KernelArg<T>& arg) noexcept {
+  return arg.arg_type() == ArgType::OUT || arg.arg_type() == ArgType::IN_OUT;
 }
 
+/** @brief Returns false (arguments without KernelArg are inputs). */
+template <typename T>
+bool IsOutputArg(const T&) noexcept {
+  return false;
+}
+
+/*!
+ * @brief Compile-time number of arguments <i>Args</i> which can be marked as
+ * outputs.
+ */
+template <typename... Args>
+struct OutputCapacity;
+
+template <>
+struct OutputCapacity<> : std::integral_constant<size_t, 0> {
+};
+
+template <typename First, typename... Tail>
+struct OutputCapacity<First, Tail...>
+    : std::integral_constant<size_t, ArgTraits<First>::may_output +
+                                     OutputCapacity<Tail...>::value> {
+};
+
+/*!
+ * @brief Signature of OpenCL kernel (types of kernel parameters in the same
+ * order as in kernel).
+ */
+template <typename... Params>
+struct KernelSignature {
+  constexpr static size_t size = sizeof...(Params);
+};
+
+/*!
+ * @brief Compile-time check that argument type <i>Arg</i> can be passed as
+ * kernel parameter of type <i>Param</i>.
+ *
+ * Kinds must be equal, scalars must have the same value type.
+ */
+template <typename Param, typename Arg>
+struct ArgMatches : std::integral_constant<bool,
+    ArgTraits<Param>::kind == ArgTraits<Arg>::kind &&
+    (ArgTraits<Param>::kind != ArgKind::Scalar ||
+     std::is_same<typename ArgTraits<Param>::value_type,
+                  typename ArgTraits<Arg>::value_type>::value)> {
+};
+
+/** @brief Compile-time check that arguments match kernel signature. */
+template <typename Signature, typename... Args>
+struct SignatureMatches;
+
+template <>
+struct SignatureMatches<KernelSignature<>> : std::true_type {
+};
+
+template <typename... Params>
+struct SignatureMatches<KernelSignature<Params...>> : std::false_type {
+};
+
+template <typename... Args>
+struct SignatureMatches<KernelSignature<>, Args...> : std::false_type {
+};
+
+template <typename Param, typename... Params, typename Arg, typename... Args>
+struct SignatureMatches<KernelSignature<Param, Params...>, Arg, Args...>
+    : std::integral_constant<bool, ArgMatches<Param, Arg>::value &&
+          SignatureMatches<KernelSignature<Params...>, Args...>::value> {
+};
+
 }  // namespace oclalgo
 
 #endif  // INC_OCLALGO_KERNEL_ARG_H_
@@ -0,0 +1,302 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// Kernels of Lloyd's k-means over row-major n x d matrix of points X and
+// k x d matrix of centroids C (VAR_TYPE is float or double).
+
+#ifndef VAR_TYPE
+#define VAR_TYPE float
+#endif  // VAR_TYPE
+
+#ifndef TILE
+#define TILE 16
+#endif  // TILE
+
+#ifndef GROUP_SIZE
+#define GROUP_SIZE 64
+#endif  // GROUP_SIZE
+
+// Assigns every point to the nearest centroid. Distances are computed as
+// |x|^2 - 2 x.c + |c|^2, where x.c is tiled product X * C^T (TILE points x
+// TILE centroids per work-group step), so n x k distance matrix is never
+// stored: every work-item keeps the best centroid of its column of tiles,
+// the best of TILE columns is chosen in local memory.
+__kernel __attribute__((reqd_work_group_size(TILE, TILE, 1)))
+void kmeans_assign(__global const VAR_TYPE *X, __global const VAR_TYPE *C,
+                   __global const VAR_TYPE *x_norms,
+                   __global const VAR_TYPE *c_norms, __global int *labels,
+                   __global VAR_TYPE *distances, const int n, const int k,
+                   const int d) {
+  __local VAR_TYPE XS[TILE][TILE + 1];
+  __local VAR_TYPE CS[TILE][TILE + 1];
+  __local VAR_TYPE best_dist[TILE][TILE];
+  __local int best_label[TILE][TILE];
+  int lx = get_local_id(0);
+  int ly = get_local_id(1);
+  int i = get_group_id(1) * TILE + ly;
+
+  VAR_TYPE best = INFINITY;
+  int label = 0;
+  for (int c0 = 0; c0 < k; c0 += TILE) {
+    VAR_TYPE dot = 0;
+    for (int t = 0; t < d; t += TILE) {
+      XS[ly][lx] = (i < n && t + lx < d) ? X[(size_t)i * d + t + lx] : 0;
+      CS[ly][lx] = (c0 + ly < k && t + lx < d) ?
+          C[(size_t)(c0 + ly) * d + t + lx] : 0;
+      barrier(CLK_LOCAL_MEM_FENCE);
+      #pragma unroll
+      for (int q = 0; q < TILE; ++q)
+        dot += XS[ly][q] * CS[lx][q];
+      barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    int j = c0 + lx;
+    if (j < k) {
+      VAR_TYPE dist = c_norms[j] - 2 * dot;
+      if (dist < best) {
+        best = dist;
+        label = j;
+      }
+    }
+  }
+  best_dist[ly][lx] = best;
+  best_label[ly][lx] = label;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  if (lx == 0 && i < n) {
+    for (int q = 1; q < TILE; ++q) {
+      VAR_TYPE dist = best_dist[ly][q];
+      if (dist < best || (dist == best && best_label[ly][q] < label)) {
+        best = dist;
+        label = best_label[ly][q];
+      }
+    }
+    labels[i] = label;
+    distances[i] = max(x_norms[i] + best, (VAR_TYPE)0);
+  }
+}
+
+__kernel void kmeans_fill(__global int *A, const int value, const int n) {
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    A[i] = value;
+}
+
+// Counting sort of points by labels: counts, offsets (exclusive scan) and
+// scatter of point indices. Order of points inside cluster isn't defined.
+__kernel void kmeans_count(__global const int *labels, __global int *counts,
+                           const int n) {
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    atomic_inc(&counts[labels[i]]);
+}
+
+__kernel void kmeans_offsets(__global const int *counts,
+                             __global int *offsets, __global int *cursors,
+                             const int k) {
+  if (get_global_id(0) != 0) return;
+  int sum = 0;
+  for (int j = 0; j < k; ++j) {
+    offsets[j] = sum;
+    cursors[j] = sum;
+    sum += counts[j];
+  }
+}
+
+__kernel void kmeans_scatter(__global const int *labels,
+                             __global int *cursors, __global int *order,
+                             const int n) {
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    order[atomic_inc(&cursors[labels[i]])] = i;
+}
+
+// Moves every centroid to the mean of its points (empty clusters keep
+// their centroids). One work-group per centroid, work-items split
+// dimensions, so rows of points are read coalesced. Writes squared norm of
+// new centroid and squared shift of centroid.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void kmeans_update(__global const VAR_TYPE *X, __global const int *order,
+                   __global const int *offsets, __global const int *counts,
+                   __global VAR_TYPE *C, __global VAR_TYPE *c_norms,
+                   __global VAR_TYPE *shifts, const int k, const int d) {
+  __local VAR_TYPE part_norm[GROUP_SIZE];
+  __local VAR_TYPE part_shift[GROUP_SIZE];
+  int lid = get_local_id(0);
+  for (int j = get_group_id(0); j < k; j += get_num_groups(0)) {
+    int first = offsets[j];
+    int count = counts[j];
+    __global VAR_TYPE *c = C + (size_t)j * d;
+    VAR_TYPE norm = 0;
+    VAR_TYPE shift = 0;
+    for (int q = lid; q < d; q += GROUP_SIZE) {
+      VAR_TYPE value = c[q];
+      if (count > 0) {
+        VAR_TYPE sum = 0;
+        for (int m = first; m < first + count; ++m)
+          sum += X[(size_t)order[m] * d + q];
+        VAR_TYPE mean = sum / count;
+        shift += (mean - value) * (mean - value);
+        value = mean;
+        c[q] = value;
+      }
+      norm += value * value;
+    }
+    part_norm[lid] = norm;
+    part_shift[lid] = shift;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = GROUP_SIZE / 2; s > 0; s >>= 1) {
+      if (lid < s) {
+        part_norm[lid] += part_norm[lid + s];
+        part_shift[lid] += part_shift[lid + s];
+      }
+      barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (lid == 0) {
+      c_norms[j] = part_norm[0];
+      shifts[j] = part_shift[0];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+// Copies rows index[r] of X to rows r of Y (m rows).
+__kernel void kmeans_gather(__global const VAR_TYPE *X,
+                            __global const int *index, __global VAR_TYPE *Y,
+                            const int m, const int d) {
+  for (int r = get_global_id(1); r < m; r += get_global_size(1)) {
+    __global const VAR_TYPE *x = X + (size_t)index[r] * d;
+    for (int q = get_global_id(0); q < d; q += get_global_size(0))
+      Y[(size_t)r * d + q] = x[q];
+  }
+}
+
+// k-means++ step 1: updates squared distances D of points to the nearest
+// chosen centroid with centroid number c (D is initialized if c == 0).
+__kernel void kmeans_pp_distances(__global const VAR_TYPE *X,
+                                  __global const VAR_TYPE *C,
+                                  __global VAR_TYPE *D, const int c,
+                                  const int n, const int d) {
+  __global const VAR_TYPE *center = C + (size_t)c * d;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    __global const VAR_TYPE *x = X + (size_t)i * d;
+    VAR_TYPE dist = 0;
+    for (int q = 0; q < d; ++q)
+      dist += (x[q] - center[q]) * (x[q] - center[q]);
+    D[i] = c == 0 ? dist : min(D[i], dist);
+  }
+}
+
+// uniform random number in (0, 1) by hash of (seed, i)
+inline float uniform(uint seed, uint i) {
+  uint h = i * 0x9E3779B9u ^ seed;
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  h ^= h >> 16;
+  return ((h >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+// k-means++ step 2: weighted sampling of point with probability ~ D[i]
+// (point with the largest key log(u) / D[i]), partial results of groups.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void kmeans_pp_sample(__global const VAR_TYPE *D, __global float *keys,
+                      __global int *points, const uint seed, const int n) {
+  __local float part_key[GROUP_SIZE];
+  __local int part_point[GROUP_SIZE];
+  int lid = get_local_id(0);
+  float best = -INFINITY;
+  int point = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    float key = D[i] > 0 ? log(uniform(seed, i)) / (float)D[i] : -INFINITY;
+    if (key > best) {
+      best = key;
+      point = i;
+    }
+  }
+  part_key[lid] = best;
+  part_point[lid] = point;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int s = GROUP_SIZE / 2; s > 0; s >>= 1) {
+    if (lid < s && part_key[lid + s] > part_key[lid]) {
+      part_key[lid] = part_key[lid + s];
+      part_point[lid] = part_point[lid + s];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  if (lid == 0) {
+    keys[get_group_id(0)] = part_key[0];
+    points[get_group_id(0)] = part_point[0];
+  }
+}
+
+// k-means++ step 3: chooses the best of <groups> partial samples and copies
+// the point to centroid number c.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void kmeans_pp_select(__global const float *keys,
+                      __global const int *points, const int groups,
+                      __global const VAR_TYPE *X, __global VAR_TYPE *C,
+                      const int c, const int d) {
+  __local float part_key[GROUP_SIZE];
+  __local int part_point[GROUP_SIZE];
+  int lid = get_local_id(0);
+  float best = -INFINITY;
+  int point = 0;
+  for (int g = lid; g < groups; g += GROUP_SIZE) {
+    if (keys[g] > best) {
+      best = keys[g];
+      point = points[g];
+    }
+  }
+  part_key[lid] = best;
+  part_point[lid] = point;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int s = GROUP_SIZE / 2; s > 0; s >>= 1) {
+    if (lid < s && part_key[lid + s] > part_key[lid]) {
+      part_key[lid] = part_key[lid + s];
+      part_point[lid] = part_point[lid + s];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  __global const VAR_TYPE *x = X + (size_t)part_point[0] * d;
+  for (int q = lid; q < d; q += GROUP_SIZE)
+    C[(size_t)c * d + q] = x[q];
+}
+
+#undef GROUP_SIZE
+#undef TILE
+#undef VAR_TYPE
@@ -0,0 +1,327 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file kmeans.h
+ *  @brief Contains oclalgo::KMeans class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Points, centroids, labels and all temporary data stay in device memory,
+ *  only the largest centroid shift is read by host every iteration (and
+ *  inertia once after the last one). Kernels are in kmeans.cl.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_KMEANS_H_
+#define INC_OCLALGO_KMEANS_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+#include <oclalgo/dmatrix.h>
+
+namespace oclalgo {
+
+/** @brief Initialization of k-means centroids. */
+enum class KMeansInit {
+  Random,   ///< k distinct random points
+  PlusPlus  ///< k-means++ seeding
+};
+
+/** @brief Parameters of k-means clustering. */
+struct KMeansOptions {
+  /** @brief Maximal number of Lloyd's iterations. */
+  int max_iterations = 100;
+  /** @brief Clustering stops when no centroid moves further. */
+  double tolerance = 1e-4;
+  KMeansInit init = KMeansInit::PlusPlus;
+  /*!
+   * @brief Number of random points k-means++ is run on (0 - all points).
+   *
+   * Every k-means++ step reads all points, so for large inputs seeding on a
+   * sample is much faster.
+   */
+  int init_sample = 0;
+  unsigned seed = 0;
+};
+
+/*!
+ * @brief Lloyd's k-means clustering of DMatrix rows on OpenCL device.
+ *
+ * Every iteration:
+ * <ol>
+ * <li>points are assigned to the nearest centroids by tiled X * C^T product
+ * with argmin epilogue (|x|^2 - 2 x.c + |c|^2, n x k distances aren't
+ * stored);</li>
+ * <li>points are sorted by clusters with counting sort;</li>
+ * <li>centroids are moved to means of their points by per-cluster
+ * reductions.</li>
+ * </ol>
+ * T is float or double.
+ */
+template <typename T>
+class KMeans {
+ public:
+  static_assert(std::is_floating_point<T>::value,
+                "k-means requires floating point matrices");
+
+  explicit KMeans(int k, const KMeansOptions& options = KMeansOptions())
+      : k_(k),
+        options_(options),
+        inertia_(0),
+        iterations_(0) {
+    assert(k > 0);
+  }
+
+  /*!
+   * @brief Clusters rows of matrix <i>x</i> (x.rows() >= k).
+   *
+   * @return number of iterations
+   */
+  int Fit(const DMatrix<T>& x);
+
+  /** @brief Returns k x d matrix of centroids. */
+  const DMatrix<T>& centroids() const noexcept { return centroids_; }
+  /** @brief Returns buffer of n cluster numbers (int) of points. */
+  cl::Buffer labels() const noexcept { return labels_; }
+  /** @brief Returns sum of squared distances of points to centroids. */
+  T inertia() const noexcept { return inertia_; }
+  int iterations() const noexcept { return iterations_; }
+  int k() const noexcept { return k_; }
+
+ private:
+  constexpr static int tile = 16;
+  constexpr static int group_size = 64;
+  constexpr static int max_sample_groups = 1024;
+
+  template <typename... Args>
+  void Run(const char* kernel, const Grid& grid, const Args&... args) const {
+    Queue* queue = MatrixQueue::instance();
+    queue->EnqueueTask(queue->CreateTask("kmeans.cl", kernel, options(),
+                                         args...), grid);
+  }
+  std::string options() const {
+    char buff[128] = {0};
+    std::snprintf(buff, sizeof(buff), "-D VAR_TYPE=%s -D TILE=%d "
+                  "-D GROUP_SIZE=%d", PrintType<T>().c_str(), tile,
+                  group_size);
+    return buff;
+  }
+  template <typename U>
+  cl::Buffer Allocate(size_t size) const {
+    return MatrixQueue::instance()->CreateBuffer<U>(size, CL_MEM_READ_WRITE,
+                                                    "KMeans");
+  }
+  std::vector<int> SampleRows(int n, int m, std::mt19937* rng) const;
+  void Gather(const DMatrix<T>& x, const std::vector<int>& rows,
+              DMatrix<T>* out) const;
+  void InitCentroids(const DMatrix<T>& x, std::mt19937* rng);
+  void Assign(const DMatrix<T>& x, const cl::Buffer& x_norms);
+  void Update(const DMatrix<T>& x);
+  T ReadReduced(const cl::Buffer& buffer, int size, ReduceOp op) const;
+
+  int k_;
+  KMeansOptions options_;
+  DMatrix<T> centroids_;
+  cl::Buffer c_norms_;
+  cl::Buffer labels_;
+  cl::Buffer distances_;
+  cl::Buffer shifts_;
+  cl::Buffer counts_;
+  cl::Buffer offsets_;
+  cl::Buffer cursors_;
+  cl::Buffer order_;
+  T inertia_;
+  int iterations_;
+};
+
+// definitions of constants bound to references (std::min)
+template <typename T> constexpr int KMeans<T>::tile;
+template <typename T> constexpr int KMeans<T>::group_size;
+template <typename T> constexpr int KMeans<T>::max_sample_groups;
+
+template <typename T>
+int KMeans<T>::Fit(const DMatrix<T>& x) {
+  int n = x.rows(), d = x.cols();
+  assert(n >= k_);
+  centroids_ = DMatrix<T>(k_, d);
+  labels_ = Allocate<int>(n);
+  distances_ = Allocate<T>(n);
+  order_ = Allocate<int>(n);
+  shifts_ = Allocate<T>(k_);
+  counts_ = Allocate<int>(k_);
+  offsets_ = Allocate<int>(k_);
+  cursors_ = Allocate<int>(k_);
+
+  std::mt19937 rng(options_.seed);
+  InitCentroids(x, &rng);
+  c_norms_ = ReduceRows(centroids_, ReduceOp::SumSquares).get().buffer();
+  DMatrix<T> x_norms = ReduceRows(x, ReduceOp::SumSquares).get();
+
+  for (iterations_ = 0; iterations_ < options_.max_iterations;) {
+    Assign(x, x_norms.buffer());
+    Update(x);
+    ++iterations_;
+    T shift = ReadReduced(shifts_, k_, ReduceOp::Max);
+    if (std::sqrt(shift) <= options_.tolerance) break;
+  }
+  // labels and inertia of final centroids
+  Assign(x, x_norms.buffer());
+  inertia_ = ReadReduced(distances_, n, ReduceOp::Sum);
+  return iterations_;
+}
+
+template <typename T>
+std::vector<int> KMeans<T>::SampleRows(int n, int m,
+                                       std::mt19937* rng) const {
+  std::vector<int> rows;
+  if (m > n / 2) {
+    rows.resize(n);
+    for (int i = 0; i < n; ++i)
+      rows[i] = i;
+    std::shuffle(rows.begin(), rows.end(), *rng);
+    rows.resize(m);
+  } else {
+    std::uniform_int_distribution<int> dist(0, n - 1);
+    std::unordered_set<int> chosen;
+    while (static_cast<int>(rows.size()) < m) {
+      int row = dist(*rng);
+      if (chosen.insert(row).second)
+        rows.push_back(row);
+    }
+  }
+  return rows;
+}
+
+template <typename T>
+void KMeans<T>::Gather(const DMatrix<T>& x, const std::vector<int>& rows,
+                       DMatrix<T>* out) const {
+  shared_array<int> index(rows.size());
+  std::copy(rows.begin(), rows.end(), index.begin());
+  cl::Buffer index_buf = MatrixQueue::instance()->CreateBuffer(
+      index, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, "KMeans");
+  int m = static_cast<int>(rows.size()), d = x.cols();
+  Grid grid = Grid(cl::NDRange(
+      std::min(d, group_size),
+      std::max<size_t>(1, std::min<size_t>(m, internal::MaxWorkItems() /
+                                              group_size))));
+  Run("kmeans_gather", grid, x.buffer(), index_buf, out->buffer(), m, d);
+}
+
+template <typename T>
+void KMeans<T>::InitCentroids(const DMatrix<T>& x, std::mt19937* rng) {
+  int n = x.rows(), d = x.cols();
+  if (options_.init == KMeansInit::Random) {
+    Gather(x, SampleRows(n, k_, rng), &centroids_);
+    return;
+  }
+
+  // k-means++ on all points or on random sample
+  int m = n;
+  DMatrix<T> sample;
+  if (options_.init_sample > 0 && options_.init_sample < n) {
+    m = std::max(options_.init_sample, k_);
+    sample = DMatrix<T>(m, d);
+    Gather(x, SampleRows(n, m, rng), &sample);
+  }
+  const DMatrix<T>& points = m < n ? sample : x;
+  Gather(points, SampleRows(m, 1, rng), &centroids_);
+
+  cl::Buffer dist = Allocate<T>(m);
+  int groups = static_cast<int>(std::min<size_t>(
+      (m + group_size - 1) / group_size,
+      std::min<size_t>(max_sample_groups,
+                       internal::MaxWorkItems() / group_size)));
+  cl::Buffer keys = Allocate<float>(groups);
+  cl::Buffer candidates = Allocate<int>(groups);
+  Grid sample_grid = Grid(cl::NDRange(groups * group_size),
+                          cl::NDRange(group_size));
+  Grid select_grid = Grid(cl::NDRange(group_size), cl::NDRange(group_size));
+  for (int c = 1; c < k_; ++c) {
+    Run("kmeans_pp_distances", internal::StrideGrid(m), points.buffer(),
+        centroids_.buffer(), dist, c - 1, m, d);
+    cl_uint seed = static_cast<cl_uint>((*rng)());
+    Run("kmeans_pp_sample", sample_grid, dist, keys, candidates, seed, m);
+    Run("kmeans_pp_select", select_grid, keys, candidates, groups,
+        points.buffer(), centroids_.buffer(), c, d);
+  }
+}
+
+template <typename T>
+void KMeans<T>::Assign(const DMatrix<T>& x, const cl::Buffer& x_norms) {
+  int n = x.rows();
+  int rows = (n + tile - 1) / tile * tile;
+  Run("kmeans_assign", Grid(cl::NDRange(tile, rows), cl::NDRange(tile, tile)),
+      x.buffer(), centroids_.buffer(), x_norms, c_norms_, labels_, distances_,
+      n, k_, x.cols());
+}
+
+template <typename T>
+void KMeans<T>::Update(const DMatrix<T>& x) {
+  int n = x.rows();
+  Run("kmeans_fill", internal::StrideGrid(k_), counts_, 0, k_);
+  Run("kmeans_count", internal::StrideGrid(n), labels_, counts_, n);
+  Run("kmeans_offsets", Grid(cl::NDRange(1)), counts_, offsets_, cursors_,
+      k_);
+  Run("kmeans_scatter", internal::StrideGrid(n), labels_, cursors_, order_,
+      n);
+  size_t groups = std::min<size_t>(k_, internal::MaxWorkItems() / group_size);
+  Run("kmeans_update", Grid(cl::NDRange(groups * group_size),
+                            cl::NDRange(group_size)),
+      x.buffer(), order_, offsets_, counts_, centroids_.buffer(), c_norms_,
+      shifts_, k_, x.cols());
+}
+
+template <typename T>
+T KMeans<T>::ReadReduced(const cl::Buffer& buffer, int size,
+                         ReduceOp op) const {
+  DMatrix<T> values(1, size, buffer);
+  return ReduceRows(values, op).get().ToHost()(0, 0);
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_KMEANS_H_
@@ -0,0 +1,371 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file managed_matrix.h
+ *  @brief Contains oclalgo::ManagedMatrix class.
+ *  @author Dmitry Senin <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Matrix with host and device copies, which are synchronized lazily.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_MANAGED_MATRIX_H_
+#define INC_OCLALGO_MANAGED_MATRIX_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <memory>
+
+#include <oclalgo/dmatrix.h>
+#include <oclalgo/matrix.h>
+
+namespace oclalgo {
+
+/** @brief Enum of memory spaces where matrix data can reside. */
+enum class Residency { Host, Device };
+
+/*!
+ * @brief Matrix class, which keeps host (Matrix) and device (DMatrix) copies
+ * of data and tracks which of them is valid.
+ *
+ * Data is transferred only when a stale copy is accessed. Accessors with
+ * <i>mutable_</i> prefix mark the other copy as dirty, so the next access to
+ * it leads to transfer. Prefetch() starts asynchronous transfer in advance.
+ * Device operations use MatrixQueue in-order queue, so device copy can be
+ * used right after upload is enqueued. Class isn't thread-safe.
+ */
+template <typename T>
+class ManagedMatrix {
+ public:
+  ManagedMatrix();
+  /*!
+   * @brief Creates matrix with corresponding numbers of rows and columns.
+   *
+   * Host and device memory is allocated on first access.
+   */
+  ManagedMatrix(int rows, int cols);
+  /** @brief Creates matrix with valid host copy of corresponding data. */
+  explicit ManagedMatrix(const Matrix<T>& m);
+  /** @brief Creates matrix with valid host copy of corresponding data. */
+  explicit ManagedMatrix(Matrix<T>&& m);
+  /** @brief Creates matrix with valid device copy of corresponding data. */
+  explicit ManagedMatrix(DMatrix<T>&& m);
+  /*!
+   * @brief Creates matrix with device copy which will be valid when
+   * corresponding device operation finishes.
+   */
+  ManagedMatrix(int rows, int cols, oclalgo::future<DMatrix<T>>&& f);
+
+  ManagedMatrix(const ManagedMatrix<T>&) = delete;
+  ManagedMatrix<T>& operator=(const ManagedMatrix<T>&) = delete;
+
+  ManagedMatrix(ManagedMatrix<T>&& m);
+  ManagedMatrix<T>& operator=(ManagedMatrix<T>&& m);
+
+  /** @brief Waits for asynchronous transfer which uses host copy memory. */
+  virtual ~ManagedMatrix();
+
+  /** @brief Returns host copy (downloads data if it is stale). */
+  const Matrix<T>& host() const;
+  /*!
+   * @brief Returns host copy for modification (downloads data if it is stale)
+   * and marks device copy as dirty.
+   */
+  Matrix<T>& mutable_host();
+
+  /** @brief Returns device copy (uploads data if it is stale). */
+  const DMatrix<T>& device() const;
+  /*!
+   * @brief Returns device copy for modification (uploads data if it is stale)
+   * and marks host copy as dirty.
+   */
+  DMatrix<T>& mutable_device();
+
+  /*!
+   * @brief Starts asynchronous transfer of data to corresponding memory space
+   * if copy placed there is stale.
+   */
+  void Prefetch(Residency where) const;
+
+  /** @brief Returns true if host copy is valid. */
+  bool host_valid() const noexcept { return host_valid_; }
+  /** @brief Returns true if device copy is valid. */
+  bool device_valid() const noexcept { return device_valid_; }
+
+  /** @brief Returns number of host to device transfers. */
+  size_t uploads() const noexcept { return uploads_; }
+  /** @brief Returns number of device to host transfers. */
+  size_t downloads() const noexcept { return downloads_; }
+
+  /** @brief Returns number of rows in matrix. */
+  int rows() const noexcept { return rows_; }
+  /** @brief Returns number of columns in matrix. */
+  int cols() const noexcept { return cols_; }
+
+  /** @brief Returns matrix element in position (i, j) using host copy. */
+  const T& operator()(int i, int j) const { return host()(i, j); }
+
+ private:
+  void ResolveResult() const;
+  void WaitPending() const;
+
+  int rows_;
+  int cols_;
+  mutable Matrix<T> host_;
+  mutable DMatrix<T> device_;
+  mutable bool host_valid_;
+  mutable bool device_valid_;
+  mutable cl::Event pending_;  // the last asynchronous transfer
+  mutable std::unique_ptr<oclalgo::future<DMatrix<T>>> result_;
+  mutable size_t uploads_;
+  mutable size_t downloads_;
+};
+
+template <typename T>
+ManagedMatrix<T>::ManagedMatrix()
+    : rows_(0),
+      cols_(0),
+      host_valid_(true),
+      device_valid_(true),
+      uploads_(0),
+      downloads_(0) {
+}
+
+template <typename T>
+ManagedMatrix<T>::ManagedMatrix(int rows, int cols)
+    : rows_(rows),
+      cols_(cols),
+      host_valid_(true),
+      device_valid_(true),
+      uploads_(0),
+      downloads_(0) {
+}
+
+template <typename T>
+ManagedMatrix<T>::ManagedMatrix(const Matrix<T>& m)
+    : rows_(m.rows()),
+      cols_(m.cols()),
+      host_(m),
+      host_valid_(true),
+      device_valid_(false),
+      uploads_(0),
+      downloads_(0) {
+}
+
+template <typename T>
+ManagedMatrix<T>::ManagedMatrix(Matrix<T>&& m)
+    : rows_(m.rows()),
+      cols_(m.cols()),
+      host_(std::move(m)),
+      host_valid_(true),
+      device_valid_(false),
+      uploads_(0),
+      downloads_(0) {
+}
+
+template <typename T>
+ManagedMatrix<T>::ManagedMatrix(DMatrix<T>&& m)
+    : rows_(m.rows()),
+      cols_(m.cols()),
+      device_(std::move(m)),
+      host_valid_(false),
+      device_valid_(true),
+      uploads_(0),
+      downloads_(0) {
+}
+
+template <typename T>
+ManagedMatrix<T>::ManagedMatrix(int rows, int cols,
+                                oclalgo::future<DMatrix<T>>&& f)
+    : rows_(rows),
+      cols_(cols),
+      host_valid_(false),
+      device_valid_(true),
+      result_(new oclalgo::future<DMatrix<T>>(std::move(f))),
+      uploads_(0),
+      downloads_(0) {
+}
+
+template <typename T>
+ManagedMatrix<T>::ManagedMatrix(ManagedMatrix<T>&& m)
+    : rows_(m.rows_),
+      cols_(m.cols_),
+      host_(std::move(m.host_)),
+      device_(std::move(m.device_)),
+      host_valid_(m.host_valid_),
+      device_valid_(m.device_valid_),
+      pending_(m.pending_),
+      result_(std::move(m.result_)),
+      uploads_(m.uploads_),
+      downloads_(m.downloads_) {
+  m.rows_ = m.cols_ = 0;
+  m.host_valid_ = m.device_valid_ = true;
+  m.pending_ = cl::Event();
+}
+
+template <typename T>
+ManagedMatrix<T>& ManagedMatrix<T>::operator=(ManagedMatrix<T>&& m) {
+  if (this != &m) {
+    WaitPending();
+    rows_ = m.rows_;
+    cols_ = m.cols_;
+    host_ = std::move(m.host_);
+    device_ = std::move(m.device_);
+    host_valid_ = m.host_valid_;
+    device_valid_ = m.device_valid_;
+    pending_ = m.pending_;
+    result_ = std::move(m.result_);
+    uploads_ = m.uploads_;
+    downloads_ = m.downloads_;
+
+    m.rows_ = m.cols_ = 0;
+    m.host_valid_ = m.device_valid_ = true;
+    m.pending_ = cl::Event();
+  }
+  return *this;
+}
+
+template <typename T>
+const Matrix<T>& ManagedMatrix<T>::host() const {
+  Prefetch(Residency::Host);
+  WaitPending();
+  return host_;
+}
+
+template <typename T>
+Matrix<T>& ManagedMatrix<T>::mutable_host() {
+  host();
+  device_valid_ = false;
+  return host_;
+}
+
+template <typename T>
+const DMatrix<T>& ManagedMatrix<T>::device() const {
+  // in-order queue executes commands after the upload without waiting
+  Prefetch(Residency::Device);
+  return device_;
+}
+
+template <typename T>
+DMatrix<T>& ManagedMatrix<T>::mutable_device() {
+  device();
+  host_valid_ = false;
+  return device_;
+}
+
+template <typename T>
+void ManagedMatrix<T>::Prefetch(Residency where) const {
+  ResolveResult();
+  Queue* queue = MatrixQueue::instance();
+  if (where == Residency::Host) {
+    bool allocated = host_.rows() == rows_ && host_.cols() == cols_ &&
+                     (host_.data() || rows_ * cols_ == 0);
+    if (host_valid_ && allocated) return;
+    if (!allocated) {
+      WaitPending();
+      host_.resize(rows_, cols_);
+    }
+    if (!host_valid_) {
+      auto f = queue->memcpy(host_.data(), device_.buffer(),
+                             BlockingType::Unblock);
+      pending_ = f.event();
+      host_valid_ = true;
+      ++downloads_;
+    }
+  } else {
+    bool allocated = device_.rows() == rows_ && device_.cols() == cols_ &&
+                     (device_.buffer()() || rows_ * cols_ == 0);
+    if (device_valid_ && allocated) return;
+    if (!allocated)
+      device_ = DMatrix<T>(rows_, cols_);
+    if (!device_valid_) {
+      auto f = queue->memcpy(device_.buffer(), host_.data(),
+                             BlockingType::Unblock);
+      pending_ = f.event();
+      device_valid_ = true;
+      ++uploads_;
+    }
+  }
+}
+
+template <typename T>
+void ManagedMatrix<T>::ResolveResult() const {
+  if (result_) {
+    device_ = result_->get();
+    result_.reset();
+  }
+}
+
+template <typename T>
+ManagedMatrix<T>::~ManagedMatrix() {
+  try {
+    WaitPending();
+  } catch (const cl::Error&) {
+    // failed transfer doesn't use host memory anymore
+  }
+}
+
+template <typename T>
+void ManagedMatrix<T>::WaitPending() const {
+  if (pending_()) {
+    pending_.wait();
+    pending_ = cl::Event();
+  }
+}
+
+template <typename T>
+ManagedMatrix<T> operator+(const ManagedMatrix<T>& m1,
+                           const ManagedMatrix<T>& m2) {
+  return ManagedMatrix<T>(m1.rows(), m1.cols(), m1.device() + m2.device());
+}
+
+template <typename T>
+ManagedMatrix<T> operator-(const ManagedMatrix<T>& m1,
+                           const ManagedMatrix<T>& m2) {
+  return ManagedMatrix<T>(m1.rows(), m1.cols(), m1.device() - m2.device());
+}
+
+template <typename T>
+ManagedMatrix<T> operator*(const ManagedMatrix<T>& m1,
+                           const ManagedMatrix<T>& m2) {
+  return ManagedMatrix<T>(m1.rows(), m2.cols(), m1.device() * m2.device());
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_MANAGED_MATRIX_H_
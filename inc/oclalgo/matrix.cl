@@ -122,5 +122,64 @@ void matrix_mul(__global const VAR_TYPE *A,
   }
 }
 
+inline VAR_TYPE load_element(__global const VAR_TYPE* m, int packing,
+                            int rows, int cols, int i, int j) {
+  return packing == ROW ? m[i * cols + j] : m[j * rows + i];
+}
+
+// Shape of product is fixed at compile time if MUL_ROWS, MUL_INNER, MUL_COLS,
+// A_PACKING and B_PACKING are defined, scalar arguments are ignored then.
+#ifdef MUL_ROWS
+#define MUL_SHAPE(arg, fixed) (fixed)
+#else
+#define MUL_SHAPE(arg, fixed) (arg)
+#endif  // MUL_ROWS
+
+// C = A * B, where A is (rows x inner) and B is (inner x cols) matrices.
+// Global size should be rounded up to multiples of BLOCK_SIZE.
+__kernel __attribute__((reqd_work_group_size(BLOCK_SIZE, BLOCK_SIZE, 1)))
+void matrix_mul_dims(__global const VAR_TYPE *A, __global const VAR_TYPE *B,
+                     __global VAR_TYPE *C, const int rows, const int inner,
+                     const int cols, const int a_packing,
+                     const int b_packing) {
+  const int M = MUL_SHAPE(rows, MUL_ROWS);
+  const int K = MUL_SHAPE(inner, MUL_INNER);
+  const int N = MUL_SHAPE(cols, MUL_COLS);
+  const int pa = MUL_SHAPE(a_packing, A_PACKING);
+  const int pb = MUL_SHAPE(b_packing, B_PACKING);
+
+  int lx = get_local_id(0);
+  int ly = get_local_id(1);
+  int i_A = BLOCK_SIZE * get_group_id(1) + ly;
+  int j_B = BLOCK_SIZE * get_group_id(0) + lx;
+
+  __local VAR_TYPE AS[BLOCK_SIZE][BLOCK_SIZE];
+  __local VAR_TYPE BS[BLOCK_SIZE][BLOCK_SIZE];
+
+  VAR_TYPE sum = 0;
+  for (int t = 0; t < K; t += BLOCK_SIZE) {
+    int j_A = t + lx;
+    int i_B = t + ly;
+    AS[ly][lx] = (i_A < M && j_A < K) ?
+        load_element(A, pa, M, K, i_A, j_A) : 0;
+    BS[ly][lx] = (i_B < K && j_B < N) ?
+        load_element(B, pb, K, N, i_B, j_B) : 0;
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    #pragma unroll
+    for (int k = 0; k < BLOCK_SIZE; ++k) {
+      sum += AS[ly][k] * BS[k][lx];
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (i_A < M && j_B < N) {
+    C[i_A * N + j_B] = sum;
+  }
+}
+
+#undef MUL_SHAPE
 #undef BLOCK_SIZE
 #undef VAR_TYPE
@@ -38,6 +38,10 @@
  *
  *  @section Notes
  *  Use OpenCL and Host resources to compute simplest linear algebra operations.
+ *  Host elementwise operations, copying and transposition run on the library
+ *  thread pool (see thread_pool.h). Results of operators are allocated from
+ *  active ScopedArena if there is one (see arena.h). Operators also accept
+ *  spans and views of sub-matrices (see matrix_view.h) without copying them.
  *
  *  @section Copyright
  *  Copyright 2013 Samsung R&D Institute Russia
@@ -50,8 +54,12 @@
 #include <ostream>
 #include <functional>
 #include <algorithm>
+#include <type_traits>
 
+#include <oclalgo/arena.h>
+#include <oclalgo/matrix_view.h>
 #include <oclalgo/shared_array.h>
+#include <oclalgo/thread_pool.h>
 
 namespace oclalgo {
 
@@ -75,6 +83,8 @@ class Matrix {
    * transferred shared array.
    */
   Matrix(int rows, int cols, const shared_array<T>& array);
+  /** @brief Creates dense row-major copy of matrix span or view. */
+  explicit Matrix(const MatrixSpan<const T>& span);
 
   Matrix(const Matrix<T>& m);
   Matrix(Matrix<T>&& m);
@@ -87,7 +97,11 @@ class Matrix {
   /** @brief Resizes matrix by new one with specified size. */
   virtual void resize(int rows, int cols);
 
-  /** @brief Transposes matrix. */
+  /*!
+   * @brief Transposes matrix.
+   *
+   * New data is allocated from active ScopedArena if there is one.
+   */
   virtual void transpose();
 
   /** @brief Returns number of rows in matrix. */
@@ -97,6 +111,16 @@ class Matrix {
   /** @brief Returns shared_array class object, which contains matrix data. */
   shared_array<T> data() const noexcept { return data_; }
 
+  /** @brief Returns view of the whole matrix sharing its data. */
+  MatrixView<T> view() const { return MatrixView<T>(data_, rows_, cols_); }
+  /*!
+   * @brief Returns view of block with top left element (row, col) and
+   * corresponding numbers of rows and columns sharing matrix data.
+   */
+  MatrixView<T> block(int row, int col, int rows, int cols) const {
+    return view().block(row, col, rows, cols);
+  }
+
   /*!
    * @brief Returns matrix element in position (i, j).
    *
@@ -142,13 +166,24 @@ Matrix<T>::Matrix(int rows, int cols, const shared_array<T>& array)
       data_(array) {
 }
 
+template <typename T>
+Matrix<T>::Matrix(const MatrixSpan<const T>& span)
+    : rows_(span.rows()),
+      cols_(span.cols()),
+      data_(rows_ * cols_) {
+  Pack(span, data_.get_raw());
+}
+
 template <typename T>
 Matrix<T>::Matrix(const Matrix<T>& m)
     : rows_(m.rows_),
       cols_(m.cols_),
       data_(rows_ * cols_) {
-  std::copy(m.data_.get_raw(), m.data_.get_raw() + m.rows_ * m.cols_,
-            data_.get_raw());
+  const T* src = m.data_.get_raw();
+  T* dst = data_.get_raw();
+  ParallelChunks(dst, data_.size(), [src, dst](size_t first, size_t last) {
+    std::copy(src + first, src + last, dst + first);
+  });
 }
 
 template <typename T>
@@ -166,7 +201,10 @@ Matrix<T>& Matrix<T>::operator=(const Matrix<T>& m) {
     rows_ = m.rows_;
     cols_ = m.cols_;
     T* ptr = new T[rows_ * cols_];
-    std::copy(m.data_.get_raw(), m.data_.get_raw() + m.rows_ * m.cols_, ptr);
+    const T* src = m.data_.get_raw();
+    ParallelChunks(ptr, rows_ * cols_, [src, ptr](size_t first, size_t last) {
+      std::copy(src + first, src + last, ptr + first);
+    });
     data_.reset(ptr, rows_ * cols_);
   }
   return *this;
@@ -193,21 +231,89 @@ void Matrix<T>::resize(int rows, int cols) {
 
 template <typename T>
 void Matrix<T>::transpose() {
-  shared_array<T> new_data(rows_ * cols_);
-  for (int i = 0; i < rows_; ++i)
-    for (int j = 0; j < cols_; ++j)
-      new_data[j * rows_ + i] = data_[i * cols_ + j];
+  shared_array<T> new_data = AllocateArray<T>(rows_ * cols_);
+  const T* src = data_.get_raw();
+  T* dst = new_data.get_raw();
+  const int rows = rows_, cols = cols_, tile = 32;
+  // threads get contiguous bands of rows of transposed matrix
+  auto transpose_band = [=](size_t first, size_t last) {
+    const int begin = static_cast<int>(first), end = static_cast<int>(last);
+    for (int jj = begin; jj < end; jj += tile)
+      for (int ii = 0; ii < rows; ii += tile)
+        for (int j = jj; j < std::min(jj + tile, end); ++j)
+          for (int i = ii; i < std::min(ii + tile, rows); ++i)
+            dst[j * rows + i] = src[i * cols + j];
+  };
+  if (new_data.size() < ThreadPool::serial_cutoff)
+    transpose_band(0, cols);
+  else
+    ThreadPool::instance()->ParallelFor(cols, transpose_band, tile);
   std::swap(rows_, cols_);
   data_ = new_data;
 }
 
+/*!
+ * @brief Returns matrix with elements f(m1(i, j), m2(i, j)) of spans with
+ * equal sizes.
+ *
+ * Functor is called concurrently by threads of the library pool.
+ */
+template <typename U, typename FunctorType>
+Matrix<typename std::remove_const<U>::type> MatrixOperation(
+    const MatrixSpan<U>& m1, const MatrixSpan<U>& m2, const FunctorType& f) {
+  typedef typename std::remove_const<U>::type V;
+  const int cols = m1.cols();
+  Matrix<V> res(m1.rows(), cols, AllocateArray<V>(m1.rows() * cols));
+  V* c = res.data().get_raw();
+  ParallelChunks(c, res.data().size(), [=, &f](size_t first, size_t last) {
+    const std::ptrdiff_t sa = m1.col_stride(), sb = m2.col_stride();
+    while (first < last) {
+      int i = static_cast<int>(first / cols);
+      int j = static_cast<int>(first % cols);
+      size_t end = std::min(last, static_cast<size_t>(i + 1) * cols);
+      const U* a = &m1(i, j);
+      const U* b = &m2(i, j);
+      V* out = c + first;
+      size_t n = end - first;
+      if (sa == 1 && sb == 1) {
+        for (size_t k = 0; k < n; ++k)
+          out[k] = f(a[k], b[k]);
+      } else {
+        for (size_t k = 0; k < n; ++k)
+          out[k] = f(a[k * sa], b[k * sb]);
+      }
+      first = end;
+    }
+  });
+  return res;
+}
+
+/*!
+ * @brief Returns matrix with elements f(m1(i, j), m2(i, j)).
+ *
+ * Functor is called concurrently by threads of the library pool.
+ */
 template <typename U, typename FunctorType>
 Matrix<U> MatrixOperation(const Matrix<U>& m1, const Matrix<U>& m2,
                           const FunctorType& f) {
-  Matrix<U> res(m1.rows(), m1.cols());
-  for (int i = 0; i < m1.rows(); ++i)
-    for (int j = 0; j < m1.cols(); ++j)
-      res(i, j) = f(m1(i, j), m2(i, j));
+  return MatrixOperation(MatrixSpan<const U>(m1.view()),
+                         MatrixSpan<const U>(m2.view()), f);
+}
+
+/** @brief Returns product of spans (result is dense row-major matrix). */
+template <typename U>
+Matrix<typename std::remove_const<U>::type> MatrixProduct(
+    const MatrixSpan<U>& m1, const MatrixSpan<U>& m2) {
+  typedef typename std::remove_const<U>::type V;
+  Matrix<V> res(m1.rows(), m2.cols(),
+                AllocateArray<V>(m1.rows() * m2.cols()));
+  for (int i = 0; i < m1.rows(); ++i) {
+    for (int j = 0; j < m2.cols(); ++j) {
+      res(i, j) = 0;
+      for (int k = 0; k < m1.cols(); ++k)
+        res(i, j) += m1(i, k) * m2(k, j);
+    }
+  }
   return res;
 }
 
@@ -226,15 +332,31 @@ Matrix<U> operator-(const Matrix<U>& m1, const Matrix<U>& m2) {
 template <typename U>
 Matrix<U> operator*(const Matrix<U>& m1, const Matrix<U>& m2) {
   assert(m1.cols() == m2.rows());
-  Matrix<U> res(m1.rows(), m2.cols());
-  for (int i = 0; i < m1.rows(); ++i) {
-    for (int j = 0; j < m2.cols(); ++j) {
-      res(i, j) = 0;
-      for (int k = 0; k < m1.cols(); ++k)
-        res(i, j) += m1(i, k) * m2(k, j);
-    }
-  }
-  return res;
+  return MatrixProduct(MatrixSpan<const U>(m1.view()),
+                       MatrixSpan<const U>(m2.view()));
+}
+
+template <typename U>
+Matrix<typename std::remove_const<U>::type> operator+(
+    const MatrixSpan<U>& m1, const MatrixSpan<U>& m2) {
+  assert(m1.cols() == m2.cols() && m1.rows() == m2.rows());
+  return MatrixOperation(m1, m2,
+                         std::plus<typename std::remove_const<U>::type>());
+}
+
+template <typename U>
+Matrix<typename std::remove_const<U>::type> operator-(
+    const MatrixSpan<U>& m1, const MatrixSpan<U>& m2) {
+  assert(m1.cols() == m2.cols() && m1.rows() == m2.rows());
+  return MatrixOperation(m1, m2,
+                         std::minus<typename std::remove_const<U>::type>());
+}
+
+template <typename U>
+Matrix<typename std::remove_const<U>::type> operator*(
+    const MatrixSpan<U>& m1, const MatrixSpan<U>& m2) {
+  assert(m1.cols() == m2.rows());
+  return MatrixProduct(m1, m2);
 }
 
 template<typename T>
@@ -242,7 +364,7 @@ std::ostream& operator<<(std::ostream& out, const Matrix<T>& m) {
   for (int i = 0; i < m.rows(); ++i) {
     for (int j = 0; j < m.cols(); ++j)
       out << m(i, j) << "\t";
-    out << std::endl;
+    out << '\n';
   }
   return out;
 }
@@ -0,0 +1,271 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file matrix_view.h
+ *  @brief Contains oclalgo::MatrixSpan and oclalgo::MatrixView classes for
+ *  zero-copy access to sub-matrices.
+ *  @author Dmitry Senin <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Span and view address element (i, j) as data[i * ld + j] for row-major
+ *  packing and as data[j * ld + i] for column-major packing, where ld is the
+ *  leading dimension. Blocks and transpositions of spans share the data.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_MATRIX_VIEW_H_
+#define INC_OCLALGO_MATRIX_VIEW_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#include <oclalgo/shared_array.h>
+#include <oclalgo/thread_pool.h>
+
+namespace oclalgo {
+
+/** @brief Packing of matrix elements in memory. */
+enum PackingType { ROW, COL };
+
+/*!
+ * @brief Non-owning matrix of elements placed in external memory.
+ *
+ * Memory must outlive the span and its blocks.
+ */
+template <typename T>
+class MatrixSpan {
+ public:
+  typedef T value_type;
+
+  MatrixSpan() noexcept;
+  /*!
+   * @brief Creates span of matrix with corresponding numbers of rows and
+   * columns placed in <i>data</i>.
+   *
+   * Zero leading dimension means dense matrix (cols for row-major packing and
+   * rows for column-major packing).
+   */
+  MatrixSpan(T* data, int rows, int cols, int ld = 0,
+             PackingType packing = ROW) noexcept;
+  /** @brief Converts span of T to span of const T. */
+  template <typename U, typename = typename std::enable_if<
+      std::is_convertible<U*, T*>::value>::type>
+  MatrixSpan(const MatrixSpan<U>& span) noexcept
+      : MatrixSpan(span.data(), span.rows(), span.cols(), span.ld(),
+                   span.packing()) {
+  }
+
+  /** @brief Returns number of rows in matrix. */
+  int rows() const noexcept { return rows_; }
+  /** @brief Returns number of columns in matrix. */
+  int cols() const noexcept { return cols_; }
+  /** @brief Returns leading dimension of matrix. */
+  int ld() const noexcept { return ld_; }
+  /** @brief Returns packing of matrix elements. */
+  PackingType packing() const noexcept { return packing_; }
+  /** @brief Returns pointer to element (0, 0). */
+  T* data() const noexcept { return data_; }
+
+  /** @brief Returns distance between elements (i, j) and (i + 1, j). */
+  std::ptrdiff_t row_stride() const noexcept {
+    return packing_ == ROW ? ld_ : 1;
+  }
+  /** @brief Returns distance between elements (i, j) and (i, j + 1). */
+  std::ptrdiff_t col_stride() const noexcept {
+    return packing_ == ROW ? 1 : ld_;
+  }
+  /** @brief Returns true if matrix elements have no gaps between them. */
+  bool contiguous() const noexcept {
+    return ld_ == (packing_ == ROW ? cols_ : rows_) || rows_ * cols_ == 0;
+  }
+
+  /*!
+   * @brief Returns matrix element in position (i, j).
+   *
+   * i is in range [0, rows - 1]
+   * j is in range [0, cols - 1]
+   */
+  T& operator()(int i, int j) const noexcept {
+    return data_[i * row_stride() + j * col_stride()];
+  }
+
+  /*!
+   * @brief Returns span of block with top left element (row, col) and
+   * corresponding numbers of rows and columns.
+   */
+  MatrixSpan<T> block(int row, int col, int rows, int cols) const noexcept;
+  /** @brief Returns span of transposed matrix (packing is swapped). */
+  MatrixSpan<T> transposed() const noexcept;
+
+ private:
+  T* data_;
+  int rows_;
+  int cols_;
+  int ld_;
+  PackingType packing_;
+};
+
+/*!
+ * @brief Matrix span which shares ownership of shared_array data.
+ *
+ * Views of Matrix data are created by Matrix::view() and Matrix::block().
+ */
+template <typename T>
+class MatrixView : public MatrixSpan<T> {
+ public:
+  MatrixView() = default;
+  /*!
+   * @brief Creates view of matrix placed in <i>array</i> starting from
+   * element <i>offset</i>.
+   */
+  MatrixView(const shared_array<T>& array, int rows, int cols,
+             size_t offset = 0, int ld = 0, PackingType packing = ROW);
+
+  /** @brief Returns shared_array class object, which contains view data. */
+  const shared_array<T>& array() const noexcept { return array_; }
+  /** @brief Returns offset of element (0, 0) in shared array. */
+  size_t offset() const noexcept { return this->data() - array_.get_raw(); }
+
+  /** @brief Returns view of block sharing data with this view. */
+  MatrixView<T> block(int row, int col, int rows, int cols) const noexcept;
+  /** @brief Returns view of transposed matrix (packing is swapped). */
+  MatrixView<T> transposed() const noexcept;
+
+ private:
+  MatrixView(const MatrixSpan<T>& span, const shared_array<T>& array) noexcept
+      : MatrixSpan<T>(span),
+        array_(array) {
+  }
+
+  shared_array<T> array_;
+};
+
+template <typename T>
+MatrixSpan<T>::MatrixSpan() noexcept
+    : data_(nullptr),
+      rows_(0),
+      cols_(0),
+      ld_(0),
+      packing_(ROW) {
+}
+
+template <typename T>
+MatrixSpan<T>::MatrixSpan(T* data, int rows, int cols, int ld,
+                          PackingType packing) noexcept
+    : data_(data),
+      rows_(rows),
+      cols_(cols),
+      ld_(ld != 0 ? ld : (packing == ROW ? cols : rows)),
+      packing_(packing) {
+  assert(ld_ >= (packing == ROW ? cols : rows));
+}
+
+template <typename T>
+MatrixSpan<T> MatrixSpan<T>::block(int row, int col, int rows,
+                                   int cols) const noexcept {
+  assert(row >= 0 && col >= 0 && row + rows <= rows_ && col + cols <= cols_);
+  return MatrixSpan<T>(&(*this)(row, col), rows, cols, ld_, packing_);
+}
+
+template <typename T>
+MatrixSpan<T> MatrixSpan<T>::transposed() const noexcept {
+  return MatrixSpan<T>(data_, cols_, rows_, ld_, packing_ == ROW ? COL : ROW);
+}
+
+template <typename T>
+MatrixView<T>::MatrixView(const shared_array<T>& array, int rows, int cols,
+                          size_t offset, int ld, PackingType packing)
+    : MatrixSpan<T>(array.get_raw() + offset, rows, cols, ld, packing),
+      array_(array) {
+  assert(rows * cols == 0 ||
+         offset + (&(*this)(rows - 1, cols - 1) - this->data()) <
+             array.size());
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::block(int row, int col, int rows,
+                                   int cols) const noexcept {
+  return MatrixView<T>(MatrixSpan<T>::block(row, col, rows, cols), array_);
+}
+
+template <typename T>
+MatrixView<T> MatrixView<T>::transposed() const noexcept {
+  return MatrixView<T>(MatrixSpan<T>::transposed(), array_);
+}
+
+/*!
+ * @brief Copies elements of span to dense row-major array <i>out</i>.
+ *
+ * Rows are copied by threads of the library pool, column-major spans are
+ * transposed by tiles.
+ */
+template <typename T, typename U>
+void Pack(const MatrixSpan<T>& span, U* out) {
+  const int rows = span.rows(), cols = span.cols();
+  if (span.packing() == ROW) {
+    ParallelChunks(out, static_cast<size_t>(rows) * cols,
+                   [=](size_t first, size_t last) {
+      while (first < last) {
+        int i = static_cast<int>(first / cols);
+        int j = static_cast<int>(first % cols);
+        size_t end = std::min(last, static_cast<size_t>(i + 1) * cols);
+        const T* src = &span(i, j);
+        std::copy(src, src + (end - first), out + first);
+        first = end;
+      }
+    });
+    return;
+  }
+  const int tile = 32;
+  auto pack_band = [=](size_t first, size_t last) {
+    const int begin = static_cast<int>(first), end = static_cast<int>(last);
+    for (int ii = begin; ii < end; ii += tile)
+      for (int jj = 0; jj < cols; jj += tile)
+        for (int i = ii; i < std::min(ii + tile, end); ++i)
+          for (int j = jj; j < std::min(jj + tile, cols); ++j)
+            out[static_cast<size_t>(i) * cols + j] = span(i, j);
+  };
+  if (static_cast<size_t>(rows) * cols < ThreadPool::serial_cutoff)
+    pack_band(0, rows);
+  else
+    ThreadPool::instance()->ParallelFor(rows, pack_band, tile);
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_MATRIX_VIEW_H_
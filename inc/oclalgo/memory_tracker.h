@@ -0,0 +1,236 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file memory_tracker.h
+ *  @brief Contains oclalgo::MemoryTracker class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Accounts device memory allocated through Queue and enforces a configurable
+ *  memory budget.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_MEMORY_TRACKER_H_
+#define INC_OCLALGO_MEMORY_TRACKER_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*!
+ * @brief Expands to "file:line" string literal, which can be used as a tag
+ * of allocation call site.
+ */
+#define OCLALGO_CALL_SITE __FILE__ ":" OCLALGO_STRINGIFY(__LINE__)
+#define OCLALGO_STRINGIFY(x) OCLALGO_STRINGIFY_IMPL(x)
+#define OCLALGO_STRINGIFY_IMPL(x) #x
+
+namespace oclalgo {
+
+/** @brief Enum of actions taken when allocation exceeds memory budget. */
+enum class BudgetPolicy {
+  FailFast,     ///< throw cl::Error(CL_MEM_OBJECT_ALLOCATION_FAILURE)
+  EvictCache,   ///< release cached buffers (oldest first), then fail
+  SpillToHost   ///< allocate buffer in host memory (CL_MEM_ALLOC_HOST_PTR)
+};
+
+/** @brief Device memory usage counters. */
+struct MemoryUsage {
+  size_t live;         ///< bytes which are currently allocated
+  size_t peak;         ///< maximum of live bytes
+  size_t allocations;  ///< number of allocations
+
+  MemoryUsage() : live(0), peak(0), allocations(0) {}
+};
+
+/*!
+ * @brief Class for accounting of device memory allocated by OpenCL buffers.
+ *
+ * Every buffer created by Allocate() is registered with a tag (call site or
+ * user label) and is unregistered by OpenCL destructor callback when the last
+ * reference to it is released. Live bytes and peak watermarks are collected
+ * per tag and in total.
+ *
+ * Buffers which are not needed anymore can be returned to the tracker by
+ * Recycle(). They are kept in a buffer cache and reused by next allocations
+ * of the same size and flags. Under BudgetPolicy::EvictCache cached buffers
+ * are released to satisfy the budget.
+ *
+ * Object must be owned by std::shared_ptr: pending destructor callbacks keep
+ * the tracker alive after its owner is destroyed. All methods are thread-safe.
+ */
+class MemoryTracker : public std::enable_shared_from_this<MemoryTracker> {
+ public:
+  explicit MemoryTracker(const cl::Context& context);
+
+  MemoryTracker(const MemoryTracker&) = delete;
+  MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+  /*!
+   * @brief Creates OpenCL buffer and registers it with corresponding tag.
+   *
+   * If allocation exceeds memory budget, the configured BudgetPolicy is
+   * applied. Buffers without host pointer are taken from the buffer cache
+   * when there is a cached buffer with the same size and flags.
+   *
+   * @param flags OpenCL memory flags
+   * @param size buffer size in bytes
+   * @param host_ptr host pointer passed to cl::Buffer constructor
+   * @param tag call site or user label (nullptr means "untagged")
+   */
+  cl::Buffer Allocate(cl_mem_flags flags, size_t size, void* host_ptr,
+                      const char* tag);
+
+  /*!
+   * @brief Returns buffer to the buffer cache for further reuse.
+   *
+   * Buffers which weren't created by this tracker or were created with host
+   * pointer are ignored. Caller shouldn't use the buffer after recycling.
+   * Buffer is accounted until its last reference is released, even if it's
+   * evicted from the cache.
+   */
+  void Recycle(const cl::Buffer& buffer);
+
+  /** @brief Releases all buffers stored in the buffer cache. */
+  void ClearCache();
+
+  /*!
+   * @brief Allocates shared virtual memory (OpenCL 2.0) and registers it with
+   * corresponding tag.
+   *
+   * Returns nullptr if SVM isn't supported by OpenCL headers or if allocation
+   * exceeds memory budget under BudgetPolicy::SpillToHost (caller should use
+   * host memory instead).
+   *
+   * @param flags SVM memory flags (CL_MEM_SVM_FINE_GRAIN_BUFFER etc.)
+   * @param size allocation size in bytes
+   * @param tag call site or user label (nullptr means "untagged")
+   */
+  void* AllocateSvm(cl_mem_flags flags, size_t size, const char* tag);
+
+  /** @brief Frees shared virtual memory allocated by AllocateSvm(). */
+  void FreeSvm(void* ptr);
+
+  /*!
+   * @brief Returns true if pointer was allocated by AllocateSvm().
+   *
+   * If <i>flags</i> isn't nullptr, SVM flags of allocation are stored there.
+   */
+  bool IsSvmPointer(const void* ptr, cl_mem_flags* flags = nullptr) const;
+
+  /*!
+   * @brief Sets memory budget in bytes and policy applied on its exceeding.
+   *
+   * Buffers spilled to host memory aren't counted against the budget.
+   */
+  void SetBudget(size_t budget, BudgetPolicy policy);
+
+  /** @brief Returns memory budget in bytes. */
+  size_t budget() const;
+  /** @brief Returns policy applied on memory budget exceeding. */
+  BudgetPolicy policy() const;
+
+  /** @brief Returns number of live device bytes (cached buffers included). */
+  size_t live_bytes() const;
+  /** @brief Returns peak number of live device bytes. */
+  size_t peak_bytes() const;
+  /** @brief Returns number of bytes kept in the buffer cache. */
+  size_t cached_bytes() const;
+  /** @brief Returns number of live bytes spilled to host memory. */
+  size_t spilled_bytes() const;
+
+  /** @brief Returns memory usage of corresponding tag. */
+  MemoryUsage usage(const std::string& tag) const;
+  /** @brief Returns memory usage of all tags. */
+  std::map<std::string, MemoryUsage> usage() const;
+
+  /** @brief Resets peak watermarks to current live bytes. */
+  void ResetPeak();
+
+ private:
+  struct Record {
+    std::shared_ptr<MemoryTracker> tracker;
+    std::string tag;
+    size_t size;
+    cl_mem_flags flags;
+    bool spilled;
+    bool counted;
+  };
+
+  struct CacheEntry {
+    cl::Buffer buffer;
+    Record* record;
+  };
+
+  static void CL_CALLBACK OnRelease(cl_mem memobj, void* user_data);
+
+  bool CheckBudget(size_t size, std::list<CacheEntry>* evicted);
+  cl::Buffer Register(cl::Buffer buffer, size_t size, cl_mem_flags flags,
+                      bool spilled, const char* tag, size_t reserved);
+  void Account(Record* record, const std::string& tag);
+  void Unaccount(Record* record);
+  bool TakeFromCache(size_t size, cl_mem_flags flags, const char* tag,
+                     cl::Buffer* buffer);
+  void EvictUntilFits(size_t size, size_t* used,
+                      std::list<CacheEntry>* evicted);
+  void Unreserve(size_t bytes);
+
+  cl::Context context_;
+  mutable std::mutex mutex_;
+  size_t budget_;
+  BudgetPolicy policy_;
+  MemoryUsage total_;
+  size_t spilled_;
+  size_t cached_;
+  size_t reserved_;  // bytes of allocations in progress
+  std::map<std::string, MemoryUsage> tags_;
+  std::unordered_map<cl_mem, Record*> records_;
+  std::unordered_map<const void*, Record*> svm_records_;
+  std::list<CacheEntry> cache_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_MEMORY_TRACKER_H_
@@ -0,0 +1,189 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// Fused row-wise softmax, log-softmax and layer normalization of row-major
+// rows x cols matrix (VAR_TYPE is float or double).
+//
+// Work-group of GROUP_SIZE work-items processes ROWS_PER_GROUP rows at once:
+// every row is processed by LANES = GROUP_SIZE / ROWS_PER_GROUP work-items
+// (one row per group for long rows, several rows per group for short ones).
+// Row statistics are computed in one pass (online max and sum of
+// exponents, Welford mean and variance), partial statistics of lanes are
+// combined in local memory, then the row is written in the second pass.
+// GROUP_SIZE and ROWS_PER_GROUP are powers of two.
+
+#ifndef VAR_TYPE
+#define VAR_TYPE float
+#endif  // VAR_TYPE
+
+#ifndef GROUP_SIZE
+#define GROUP_SIZE 256
+#endif  // GROUP_SIZE
+
+#ifndef ROWS_PER_GROUP
+#define ROWS_PER_GROUP 1
+#endif  // ROWS_PER_GROUP
+
+#define LANES (GROUP_SIZE / ROWS_PER_GROUP)
+
+// sum of exponents s relative to max m after merging of (m1, s1), (m2, s2)
+inline VAR_TYPE merge_exp_sum(VAR_TYPE m1, VAR_TYPE s1, VAR_TYPE m2,
+                              VAR_TYPE s2, VAR_TYPE m) {
+  return (m1 == -INFINITY ? 0 : s1 * exp(m1 - m)) +
+         (m2 == -INFINITY ? 0 : s2 * exp(m2 - m));
+}
+
+// Softmax of every row, log-softmax if LOG_SOFTMAX is defined.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void softmax_rows(__global const VAR_TYPE *A, __global VAR_TYPE *C,
+                  const int rows, const int cols) {
+  __local VAR_TYPE part_max[GROUP_SIZE];
+  __local VAR_TYPE part_sum[GROUP_SIZE];
+  int lid = get_local_id(0);
+  int lane = lid % LANES;
+  int head = lid - lane;
+  for (int r = get_group_id(0) * ROWS_PER_GROUP; r < rows;
+       r += get_num_groups(0) * ROWS_PER_GROUP) {
+    int i = r + lid / LANES;
+    __global const VAR_TYPE *a = A + (size_t)i * cols;
+    VAR_TYPE m = -INFINITY;
+    VAR_TYPE s = 0;
+    if (i < rows) {
+      for (int j = lane; j < cols; j += LANES) {
+        VAR_TYPE x = a[j];
+        if (x > m) {
+          s = s * exp(m - x) + 1;
+          m = x;
+        } else if (m != -INFINITY) {
+          s += exp(x - m);
+        }
+      }
+    }
+    part_max[lid] = m;
+    part_sum[lid] = s;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int step = LANES / 2; step > 0; step >>= 1) {
+      if (lane < step) {
+        VAR_TYPE m1 = part_max[lid];
+        VAR_TYPE m2 = part_max[lid + step];
+        VAR_TYPE mm = max(m1, m2);
+        part_sum[lid] = merge_exp_sum(m1, part_sum[lid], m2,
+                                      part_sum[lid + step], mm);
+        part_max[lid] = mm;
+      }
+      barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    m = part_max[head];
+    s = part_sum[head];
+    if (i < rows) {
+      __global VAR_TYPE *c = C + (size_t)i * cols;
+#ifdef LOG_SOFTMAX
+      VAR_TYPE shift = m + log(s);
+      for (int j = lane; j < cols; j += LANES)
+        c[j] = a[j] - shift;
+#else
+      VAR_TYPE inv_sum = 1 / s;
+      for (int j = lane; j < cols; j += LANES)
+        c[j] = exp(a[j] - m) * inv_sum;
+#endif  // LOG_SOFTMAX
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+// Layer normalization of every row: (x - mean) / sqrt(var + eps) scaled by
+// G and shifted by B (vectors of <cols> elements).
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void layernorm_rows(__global const VAR_TYPE *A, __global const VAR_TYPE *G,
+                    __global const VAR_TYPE *B, __global VAR_TYPE *C,
+                    const VAR_TYPE eps, const int rows, const int cols) {
+  __local VAR_TYPE part_n[GROUP_SIZE];
+  __local VAR_TYPE part_mean[GROUP_SIZE];
+  __local VAR_TYPE part_m2[GROUP_SIZE];
+  int lid = get_local_id(0);
+  int lane = lid % LANES;
+  int head = lid - lane;
+  for (int r = get_group_id(0) * ROWS_PER_GROUP; r < rows;
+       r += get_num_groups(0) * ROWS_PER_GROUP) {
+    int i = r + lid / LANES;
+    __global const VAR_TYPE *a = A + (size_t)i * cols;
+    VAR_TYPE n = 0;
+    VAR_TYPE mean = 0;
+    VAR_TYPE m2 = 0;
+    if (i < rows) {
+      for (int j = lane; j < cols; j += LANES) {
+        VAR_TYPE x = a[j];
+        n += 1;
+        VAR_TYPE delta = x - mean;
+        mean += delta / n;
+        m2 += delta * (x - mean);
+      }
+    }
+    part_n[lid] = n;
+    part_mean[lid] = mean;
+    part_m2[lid] = m2;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int step = LANES / 2; step > 0; step >>= 1) {
+      if (lane < step && part_n[lid + step] > 0) {
+        VAR_TYPE na = part_n[lid];
+        VAR_TYPE nb = part_n[lid + step];
+        VAR_TYPE nn = na + nb;
+        VAR_TYPE delta = part_mean[lid + step] - part_mean[lid];
+        part_mean[lid] += delta * nb / nn;
+        part_m2[lid] += part_m2[lid + step] + delta * delta * na * nb / nn;
+        part_n[lid] = nn;
+      }
+      barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    mean = part_mean[head];
+    VAR_TYPE inv_std = rsqrt(part_m2[head] / cols + eps);
+    if (i < rows) {
+      __global VAR_TYPE *c = C + (size_t)i * cols;
+      for (int j = lane; j < cols; j += LANES)
+        c[j] = (a[j] - mean) * inv_std * G[j] + B[j];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+#undef LANES
+#undef ROWS_PER_GROUP
+#undef GROUP_SIZE
+#undef VAR_TYPE
@@ -0,0 +1,331 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file npy.h
+ *  @brief Contains functions and classes to read and write NumPy .npy and
+ *  .npz files.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Files are read by mapping them to memory (private copy-on-write mapping),
+ *  so arrays are wrapped into shared_array without copying and loading time
+ *  is bounded by page faults. Arrays in Fortran order are mapped to
+ *  column-major (COL) packing. Only uncompressed (stored) .npz archives are
+ *  supported, ZIP64 is used for large archives.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_NPY_H_
+#define INC_OCLALGO_NPY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <oclalgo/matrix.h>
+#include <oclalgo/matrix_view.h>
+#include <oclalgo/shared_array.h>
+
+namespace oclalgo {
+
+namespace internal {
+
+/** @brief Parsed header of .npy array. */
+struct NpyHeader {
+  std::string descr;
+  bool fortran_order = false;
+  std::vector<size_t> shape;
+  /** @brief Offset of array data from the beginning of .npy data. */
+  size_t data_offset = 0;
+};
+
+/*!
+ * @brief Parses header of .npy data of <i>size</i> bytes.
+ *
+ * Throws std::runtime_error with <i>source</i> in message for malformed
+ * data.
+ */
+NpyHeader ParseNpyHeader(const char* data, size_t size,
+                         const std::string& source);
+
+/*!
+ * @brief Returns .npy magic and header of array (padded so that data is
+ * aligned to 64 bytes).
+ */
+std::string FormatNpyHeader(const std::string& descr, bool fortran_order,
+                            const std::vector<size_t>& shape);
+
+/*!
+ * @brief Returns matrix shape of array: (n,) is n x 1, (n, m, ...) is
+ * n x (m * ...) for C order.
+ */
+std::pair<int, int> NpyMatrixShape(const NpyHeader& header,
+                                   const std::string& source);
+
+/** @brief Returns true if array description matches <i>expected</i>. */
+bool NpyDescrMatches(const std::string& descr, const std::string& expected);
+
+/** @brief Returns NumPy type description of T ("<f4" for float). */
+template <typename T>
+std::string NpyDescr() {
+  static_assert(std::is_arithmetic<T>::value,
+                "NumPy arrays of arithmetic types are supported");
+  char kind = std::is_floating_point<T>::value ? 'f' :
+      (std::is_signed<T>::value ? 'i' : 'u');
+  return std::string(sizeof(T) == 1 ? "|" : "<") + kind +
+         std::to_string(sizeof(T));
+}
+
+/** @brief Read-only file mapped to memory (copy-on-write). */
+struct MappedFile {
+  std::shared_ptr<char> data;
+  size_t size = 0;
+};
+
+/** @brief Maps file to memory, throws std::system_error on failure. */
+MappedFile MapFile(const std::string& path);
+
+/** @brief Updates CRC-32 (ZIP polynomial) by <i>size</i> bytes. */
+uint32_t Crc32(const void* data, size_t size, uint32_t crc = 0);
+
+/*!
+ * @brief Returns view of .npy array placed in memory owned by
+ * <i>owner</i>.
+ *
+ * Array shares memory with owner if data is aligned for T, otherwise it's
+ * copied.
+ */
+template <typename T>
+MatrixView<T> NpyView(const std::shared_ptr<char>& owner, const char* npy,
+                      size_t size, const std::string& source) {
+  NpyHeader header = ParseNpyHeader(npy, size, source);
+  if (!NpyDescrMatches(header.descr, NpyDescr<T>()))
+    throw std::runtime_error(source + ": array of type " + header.descr +
+                             " can't be read as " + NpyDescr<T>());
+  std::pair<int, int> shape = NpyMatrixShape(header, source);
+  size_t count = static_cast<size_t>(shape.first) * shape.second;
+  if (header.data_offset + count * sizeof(T) > size)
+    throw std::runtime_error(source + ": array data is truncated");
+
+  const char* data = npy + header.data_offset;
+  shared_array<T> array;
+  if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0) {
+    // aliasing shared_ptr keeps mapping alive while array is used
+    T* ptr = reinterpret_cast<T*>(const_cast<char*>(data));
+    array = shared_array<T>(std::shared_ptr<T>(owner, ptr), count);
+  } else {
+    array = shared_array<T>(count);
+    std::memcpy(array.get_raw(), data, count * sizeof(T));
+  }
+  return MatrixView<T>(array, shape.first, shape.second, 0, 0,
+                       header.fortran_order ? COL : ROW);
+}
+
+/** @brief Returns dense row-major matrix of view (shares data if can). */
+template <typename T>
+Matrix<T> ToMatrix(const MatrixView<T>& view) {
+  if (view.packing() == ROW && view.contiguous() && view.offset() == 0)
+    return Matrix<T>(view.rows(), view.cols(), view.array());
+  return Matrix<T>(MatrixSpan<const T>(view));
+}
+
+/*!
+ * @brief Returns .npy header of span and pointer to its data; non-contiguous
+ * spans are packed to <i>packed</i>.
+ */
+template <typename T>
+std::pair<std::string, const T*> NpyData(const MatrixSpan<const T>& m,
+                                         std::vector<T>* packed) {
+  std::vector<size_t> shape = {static_cast<size_t>(m.rows()),
+                               static_cast<size_t>(m.cols())};
+  if (m.contiguous())
+    return std::make_pair(FormatNpyHeader(NpyDescr<T>(), m.packing() == COL,
+                                          shape), m.data());
+  packed->resize(static_cast<size_t>(m.rows()) * m.cols());
+  Pack(m, packed->data());
+  return std::make_pair(FormatNpyHeader(NpyDescr<T>(), false, shape),
+                        static_cast<const T*>(packed->data()));
+}
+
+/** @brief Writes .npy header and data to file. */
+void WriteNpy(const std::string& path, const std::string& header,
+              const void* data, size_t bytes);
+
+}  // namespace internal
+
+/*!
+ * @brief Maps .npy file to memory and returns view of its array without
+ * copying.
+ *
+ * Arrays in Fortran order have COL packing. Changes of elements aren't
+ * written to file. File must not be truncated or overwritten while the view
+ * (or matrices sharing its data) is used.
+ */
+template <typename T>
+MatrixView<T> MapNpy(const std::string& path) {
+  internal::MappedFile file = internal::MapFile(path);
+  return internal::NpyView<T>(file.data, file.data.get(), file.size, path);
+}
+
+/*!
+ * @brief Reads .npy file to row-major matrix.
+ *
+ * Arrays in C order share mapped file memory, arrays in Fortran order are
+ * transposed to row-major copy.
+ */
+template <typename T>
+Matrix<T> LoadNpy(const std::string& path) {
+  return internal::ToMatrix(MapNpy<T>(path));
+}
+
+/*!
+ * @brief Writes matrix to .npy file (in Fortran order for contiguous COL
+ * spans, in C order otherwise).
+ */
+template <typename T>
+void SaveNpy(const std::string& path, const MatrixSpan<const T>& m) {
+  std::vector<T> packed;
+  auto npy = internal::NpyData(m, &packed);
+  internal::WriteNpy(path, npy.first, npy.second,
+                     static_cast<size_t>(m.rows()) * m.cols() * sizeof(T));
+}
+
+template <typename T>
+void SaveNpy(const std::string& path, const Matrix<T>& m) {
+  SaveNpy(path, MatrixSpan<const T>(m.view()));
+}
+
+/*!
+ * @brief Archive of .npy arrays (.npz) mapped to memory.
+ *
+ * Arrays are accessed by names without ".npy" suffix.
+ */
+class NpzFile {
+ public:
+  /*!
+   * @brief Maps archive and reads its directory.
+   *
+   * Throws std::runtime_error for compressed or malformed archives.
+   */
+  explicit NpzFile(const std::string& path);
+
+  /** @brief Returns names of arrays in archive order. */
+  const std::vector<std::string>& names() const noexcept { return names_; }
+  bool contains(const std::string& name) const {
+    return entries_.count(name) != 0;
+  }
+
+  /** @brief Returns view of array without copying (see MapNpy()). */
+  template <typename T>
+  MatrixView<T> Map(const std::string& name) const {
+    std::pair<size_t, size_t> entry = Find(name);
+    return internal::NpyView<T>(file_.data, file_.data.get() + entry.first,
+                                entry.second, path_ + ":" + name);
+  }
+
+  /** @brief Returns row-major matrix of array (see LoadNpy()). */
+  template <typename T>
+  Matrix<T> Load(const std::string& name) const {
+    return internal::ToMatrix(Map<T>(name));
+  }
+
+ private:
+  // offset and size of .npy data of array
+  std::pair<size_t, size_t> Find(const std::string& name) const;
+
+  std::string path_;
+  internal::MappedFile file_;
+  std::vector<std::string> names_;
+  std::map<std::string, std::pair<size_t, size_t>> entries_;
+};
+
+/*!
+ * @brief Writer of uncompressed .npz archives readable by numpy.load().
+ *
+ * Archive directory is written by Close() or destructor.
+ */
+class NpzWriter {
+ public:
+  /** @brief Creates archive, throws std::system_error on failure. */
+  explicit NpzWriter(const std::string& path);
+  NpzWriter(const NpzWriter&) = delete;
+  NpzWriter& operator=(const NpzWriter&) = delete;
+  virtual ~NpzWriter();
+
+  /** @brief Adds array <i>name</i> (see SaveNpy()). */
+  template <typename T>
+  void Add(const std::string& name, const MatrixSpan<const T>& m) {
+    std::vector<T> packed;
+    auto npy = internal::NpyData(m, &packed);
+    AddEntry(name, npy.first, npy.second,
+             static_cast<size_t>(m.rows()) * m.cols() * sizeof(T));
+  }
+
+  template <typename T>
+  void Add(const std::string& name, const Matrix<T>& m) {
+    Add(name, MatrixSpan<const T>(m.view()));
+  }
+
+  /** @brief Writes archive directory and closes file. */
+  void Close();
+
+ private:
+  struct Entry {
+    std::string name;
+    uint32_t crc;
+    uint64_t size;
+    uint64_t offset;
+  };
+
+  void AddEntry(const std::string& name, const std::string& header,
+                const void* data, size_t bytes);
+
+  std::string path_;
+  std::ofstream out_;
+  std::vector<Entry> entries_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_NPY_H_
@@ -0,0 +1,135 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file numa.h
+ *  @brief Contains oclalgo::Numa class and NUMA-aware shared arrays.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Topology is read from /sys/devices/system/node, memory policies are set
+ *  by mbind() system call. On systems without NUMA support (or not Linux)
+ *  allocations use default policy and there is one node with all CPUs.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_NUMA_H_
+#define INC_OCLALGO_NUMA_H_
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <oclalgo/shared_array.h>
+#include <oclalgo/thread_pool.h>
+
+namespace oclalgo {
+
+/** @brief Enum of NUMA placement policies of host arrays. */
+enum class NumaPolicy {
+  Default,     ///< pages are placed on the node of thread touching them first
+  Interleave,  ///< pages are interleaved over all nodes
+  FirstTouch,  ///< pages are touched by pool threads which process them
+  Bind         ///< pages are placed on the specified node
+};
+
+/** @brief Class providing NUMA topology and placement of host memory. */
+class Numa {
+ public:
+  Numa() = delete;
+
+  /** @brief Returns number of NUMA nodes (1 if NUMA isn't supported). */
+  static int nodes();
+  /** @brief Returns list of CPUs of corresponding node. */
+  static const std::vector<int>& cpus(int node);
+  /** @brief Returns all CPUs ordered by nodes. */
+  static std::vector<int> NodeOrderedCpus();
+  /** @brief Returns node of corresponding CPU (0 if it's unknown). */
+  static int NodeOfCpu(int cpu);
+
+  /*!
+   * @brief Returns NUMA node of PCI device by its address
+   * ("domain:bus:device.function", for example "0000:82:00.0").
+   *
+   * Returns -1 if node can't be determined.
+   */
+  static int PciDeviceNode(const std::string& address);
+
+  /*!
+   * @brief Allocates <i>bytes</i> of zeroed page aligned host memory with
+   * corresponding placement policy.
+   *
+   * <i>node</i> is used by NumaPolicy::Bind policy only. Pages aren't touched,
+   * so NumaPolicy::FirstTouch is the same as NumaPolicy::Default here.
+   */
+  static void* Allocate(size_t bytes, NumaPolicy policy, int node = -1);
+  /** @brief Frees memory allocated by Allocate(). */
+  static void Free(void* ptr, size_t bytes);
+
+  /** @brief Parses CPU list in sysfs format ("0-3,8-11"). */
+  static std::vector<int> ParseCpuList(const std::string& list);
+};
+
+/*!
+ * @brief Creates shared array placed in host memory by NUMA policy.
+ *
+ * Elements are value-initialized. With NumaPolicy::FirstTouch they are
+ * initialized by threads of the library pool in the same chunks as used by
+ * ParallelChunks(), so pinned pool threads (see ThreadPool::SetPinning())
+ * later process pages of their own nodes.
+ */
+template <typename T>
+shared_array<T> MakeNumaArray(size_t size, NumaPolicy policy, int node = -1) {
+  static_assert(std::is_trivially_destructible<T>::value,
+                "NUMA arrays support only trivially destructible types");
+  size_t bytes = size * sizeof(T);
+  T* ptr = static_cast<T*>(Numa::Allocate(bytes, policy, node));
+  std::shared_ptr<T> sp(ptr, [bytes](T* p) { Numa::Free(p, bytes); });
+  auto touch = [ptr](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i)
+      new (ptr + i) T();
+  };
+  // memory is zeroed by Allocate(), so arithmetic elements are initialized
+  if (policy == NumaPolicy::FirstTouch)
+    ParallelChunks(ptr, size, touch);
+  else if (!std::is_arithmetic<T>::value)
+    touch(0, size);
+  return shared_array<T>(sp, size);
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_NUMA_H_
@@ -100,13 +100,16 @@
 #include <CL/cl.hpp>
 
 #include <cstdio>
+#include <memory>
 #include <unordered_map>
 #include <string>
-#include <fstream>
 #include <vector>
 
+#include <oclalgo/memory_tracker.h>
+#include <oclalgo/numa.h>
 #include <oclalgo/shared_array.h>
 #include <oclalgo/task.h>
+#include <oclalgo/typed_kernel.h>
 #include <oclalgo/kernel_arg.h>
 #include <oclalgo/grid.h>
 #include <oclalgo/future.h>
@@ -119,6 +122,13 @@ enum class BufferType { ReadOnly, WriteOnly, ReadWrite };
 /** @brief Enum of task execution type (with blocking or not). */
 enum class BlockingType { Block, Unblock };
 
+/** @brief Enum of shared virtual memory (OpenCL 2.0) allocation modes. */
+enum class SvmMode {
+  None,         ///< SVM isn't used (host memory and OpenCL buffers)
+  CoarseGrain,  ///< host access requires Queue::MapSvm()/Queue::UnmapSvm()
+  FineGrain     ///< host and device access memory concurrently
+};
+
 /*!
  * @brief Class for simple execution of OpenCL kernels.
  *
@@ -148,6 +158,9 @@ class Queue {
   Queue(const Queue&) = delete;
   Queue& operator=(const Queue&) = delete;
 
+  /** @brief Releases buffers kept in the buffer cache of memory tracker. */
+  ~Queue();
+
   /*!
    * @brief Creates Task object by corresponding program and kernel names.
    *
@@ -164,24 +177,110 @@ class Queue {
   Task CreateTask(const std::string& programName, const std::string& kernelName,
                   const std::string& options, const Args&... args) const;
 
-  /** @brief Creates OpenCL buffer with corresponding size and OpenCL flags. */
+  /*!
+   * @brief Creates reusable typed kernel with parameters <i>Params</i>
+   * (see TypedKernel).
+   *
+   * Program is built (or found in program cache) and kernel is created only
+   * once. Signature is checked against kernel argument info if it's
+   * available.
+   *
+   * @param programName path to OpenCL program source file (*.cl)
+   * @param kernelName function name in OpenCL program (*.cl source file)
+   * @param options compilation options used for building OpenCL program
+   */
+  template <typename... Params>
+  TypedKernel<Params...> Kernel(const std::string& programName,
+                                const std::string& kernelName,
+                                const std::string& options = "") const;
+
+  /*!
+   * @brief Creates OpenCL buffer with corresponding size and OpenCL flags.
+   *
+   * All CreateBuffer() methods register created buffer in memory tracker of
+   * this queue with corresponding <i>tag</i> (call site or user label) and
+   * apply memory budget policy of the tracker.
+   */
   template <typename T>
-  cl::Buffer CreateBuffer(size_t size, cl_mem_flags flags) const;
+  cl::Buffer CreateBuffer(size_t size, cl_mem_flags flags,
+                          const char* tag = nullptr) const;
 
   /** @brief Creates OpenCL buffer with corresponding size and type. */
   template <typename T>
-  cl::Buffer CreateBuffer(size_t size, BufferType type) const;
+  cl::Buffer CreateBuffer(size_t size, BufferType type,
+                          const char* tag = nullptr) const;
 
   /*!
    * @brief Creates OpenCL buffer by host array with corresponding OpenCL flags.
    */
   template <typename T>
-  cl::Buffer CreateBuffer(const shared_array<T>& array,
-                          cl_mem_flags flags) const;
+  cl::Buffer CreateBuffer(const shared_array<T>& array, cl_mem_flags flags,
+                          const char* tag = nullptr) const;
 
   /** @brief Creates OpenCL buffer by host array with corresponding type. */
   template <typename T>
-  cl::Buffer CreateBuffer(const shared_array<T>& array, BufferType type) const;
+  cl::Buffer CreateBuffer(const shared_array<T>& array, BufferType type,
+                          const char* tag = nullptr) const;
+
+  /*!
+   * @brief Returns buffer to the buffer cache of memory tracker.
+   *
+   * Recycled buffer is reused by the next CreateBuffer() call with the same
+   * size and flags, so caller shouldn't use it after recycling.
+   */
+  void RecycleBuffer(const cl::Buffer& buffer) const {
+    tracker_->Recycle(buffer);
+  }
+
+  /*!
+   * @brief Creates shared array in shared virtual memory (OpenCL 2.0).
+   *
+   * If device doesn't support requested mode, coarse-grain SVM is used.
+   * If device doesn't support SVM at all (OpenCL 1.x) or allocation is spilled
+   * by memory budget policy, ordinary host array is created, and it should be
+   * passed to kernels through buffers (see CreateSvmArg()).
+   */
+  template <typename T>
+  shared_array<T> CreateSvmArray(size_t size, SvmMode mode = SvmMode::FineGrain,
+                                 const char* tag = nullptr) const;
+
+  /*!
+   * @brief Creates SvmArg class object for corresponding shared array.
+   *
+   * If array was allocated in shared virtual memory, kernel gets SVM pointer
+   * and no copies are made. Otherwise OpenCL buffer is created by host pointer
+   * (as CreateKernelArg() does), and it is returned in output buffers of task.
+   */
+  template <typename T>
+  SvmArg CreateSvmArg(const shared_array<T>& array, ArgType arg_type,
+                      const char* tag = nullptr) const;
+
+  /*!
+   * @brief Maps coarse-grain SVM array for host access (blocking).
+   *
+   * Does nothing for fine-grain SVM and ordinary host arrays.
+   */
+  template <typename T>
+  void MapSvm(const shared_array<T>& array, cl_map_flags flags) const;
+
+  /** @brief Unmaps SVM array mapped by MapSvm() (blocking). */
+  template <typename T>
+  void UnmapSvm(const shared_array<T>& array) const;
+
+  /** @brief Returns the best SVM mode supported by device of this queue. */
+  SvmMode svm_mode() const noexcept { return svm_mode_; }
+
+  /*!
+   * @brief Creates host array for transfers to and from device of this queue.
+   *
+   * Array is bound to NUMA node closest to the device, if it's determined by
+   * PCI address of the device (see numa_node()).
+   */
+  template <typename T>
+  shared_array<T> CreateStagingArray(size_t size) const;
+
+  /** @brief Returns NUMA node closest to device (-1 if it's unknown). */
+  int numa_node() const noexcept { return numa_node_; }
 
   /** @brief Creates OpenCL local buffer with corresponding size. */
   template <typename T>
@@ -192,14 +291,16 @@ class Queue {
    * shared_array class object.
    */
   template <typename T>
-  BufferArg CreateKernelArg(const shared_array<T>& array, ArgType arg_type);
+  BufferArg CreateKernelArg(const shared_array<T>& array, ArgType arg_type,
+                            const char* tag = nullptr);
 
   /**
    * @brief Creates KernelArg<cl::Buffer> class object with corresponding
    * size and type.
    */
   template <typename T>
-  BufferArg CreateKernelArg(size_t size, ArgType arg_type);
+  BufferArg CreateKernelArg(size_t size, ArgType arg_type,
+                            const char* tag = nullptr);
 
   /** @brief Copies host memory to cl::Buffer object (synchronously). */
   template <typename T>
@@ -231,11 +332,24 @@ class Queue {
       shared_array<T>&& array, const cl::Buffer& buffer, BlockingType block,
       size_t offset = 0, const std::vector<cl::Event>* events = nullptr) const;
 
-  /** @brief Starts task in OpenCL queue. */
+  /*!
+   * @brief Starts task in OpenCL queue after events of <i>deps</i>
+   * (futures, events or vectors of them).
+   *
+   * Returned future contains output buffers of task. Enqueue doesn't
+   * allocate heap memory for up to WaitList::inline_capacity dependencies.
+   */
+  template <typename... Args>
+  oclalgo::future<TaskResult> EnqueueTask(const Task& task, const Grid& grid,
+                                          const Args&... deps) const;
+
+  /*!
+   * @brief Starts task in OpenCL queue moving its output buffers to
+   * returned future.
+   */
   template <typename... Args>
-  oclalgo::future<std::vector<cl::Buffer>> EnqueueTask(const Task& task,
-                                                       const Grid& grid,
-                                                       const Args&...) const;
+  oclalgo::future<TaskResult> EnqueueTask(Task&& task, const Grid& grid,
+                                          const Args&... deps) const;
 
   /** @brief Returns string corresponding to the error code. */
   static std::string StatusStr(cl_int code);
@@ -262,9 +376,15 @@ class Queue {
   cl::Context context() const noexcept { return context_; }
   /** @brief Returns cl::CommandQueue object of this queue. */
   cl::CommandQueue queue() const noexcept { return queue_; }
+  /** @brief Returns tracker of device memory allocated by this queue. */
+  MemoryTracker* memory_tracker() const noexcept { return tracker_.get(); }
 
  private:
   static BufferType CastToBufferType(ArgType arg_type);
+  static SvmMode QuerySvmMode(const cl::Device& device);
+  static int QueryNumaNode(const cl::Device& device);
+  cl::Program GetProgram(const std::string& programName,
+                         const std::string& options) const;
 
   cl::Platform platform_;
   cl::Device device_;
@@ -273,57 +393,132 @@ class Queue {
   cl::Context context_;
   cl::CommandQueue queue_;
   mutable std::unordered_map<std::string, cl::Program> programs_;
+  std::shared_ptr<MemoryTracker> tracker_;
+  SvmMode svm_mode_;
+  int numa_node_;
 };
 
 template <typename T>
-cl::Buffer Queue::CreateBuffer(size_t size, cl_mem_flags flags) const {
-  return cl::Buffer(context_, flags, size * sizeof(T), nullptr);
+cl::Buffer Queue::CreateBuffer(size_t size, cl_mem_flags flags,
+                               const char* tag) const {
+  return tracker_->Allocate(flags, size * sizeof(T), nullptr, tag);
 }
 
 template <typename T>
-cl::Buffer Queue::CreateBuffer(size_t size, BufferType type) const {
-  cl::Buffer buffer;
+cl::Buffer Queue::CreateBuffer(size_t size, BufferType type,
+                               const char* tag) const {
+  cl_mem_flags flags = CL_MEM_READ_WRITE;
   switch (type) {
     case BufferType::ReadOnly:
-      buffer = cl::Buffer(context_, CL_MEM_READ_ONLY, size * sizeof(T));
+      flags = CL_MEM_READ_ONLY;
       break;
     case BufferType::WriteOnly:
-      buffer = cl::Buffer(context_, CL_MEM_WRITE_ONLY, size * sizeof(T));
+      flags = CL_MEM_WRITE_ONLY;
       break;
     case BufferType::ReadWrite:
-      buffer = cl::Buffer(context_, CL_MEM_READ_WRITE, size * sizeof(T));
+      flags = CL_MEM_READ_WRITE;
       break;
   }
-  return buffer;
+  return tracker_->Allocate(flags, size * sizeof(T), nullptr, tag);
 }
 
 template <typename T>
 cl::Buffer Queue::CreateBuffer(const shared_array<T>& array,
-                               cl_mem_flags flags) const {
-  return cl::Buffer(context_, flags, array.memsize(), array.get_raw());
+                               cl_mem_flags flags, const char* tag) const {
+  return tracker_->Allocate(flags, array.memsize(), array.get_raw(), tag);
 }
 
 template <typename T>
-cl::Buffer Queue::CreateBuffer(const shared_array<T>& array,
-                               BufferType type) const {
+cl::Buffer Queue::CreateBuffer(const shared_array<T>& array, BufferType type,
+                               const char* tag) const {
   cl::Buffer buffer;
   switch (type) {
     case BufferType::ReadOnly:
-      buffer = cl::Buffer(context_, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR,
-                          array.memsize(), array.get_raw());
+      buffer = tracker_->Allocate(CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR,
+                                  array.memsize(), array.get_raw(), tag);
       break;
     case BufferType::WriteOnly:
-      buffer = cl::Buffer(context_, CL_MEM_WRITE_ONLY, array.memsize(),
-                          nullptr);
+      buffer = tracker_->Allocate(CL_MEM_WRITE_ONLY, array.memsize(), nullptr,
+                                  tag);
       break;
     case BufferType::ReadWrite:
-      buffer = cl::Buffer(context_, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR,
-                          array.memsize(), array.get_raw());
+      buffer = tracker_->Allocate(CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR,
+                                  array.memsize(), array.get_raw(), tag);
       break;
   }
   return buffer;
 }
 
+template <typename T>
+shared_array<T> Queue::CreateSvmArray(size_t size, SvmMode mode,
+                                      const char* tag) const {
+  if (mode == SvmMode::None || svm_mode_ == SvmMode::None)
+    return shared_array<T>(size);
+  cl_mem_flags flags = CL_MEM_READ_WRITE;
+#ifdef CL_VERSION_2_0
+  if (mode == SvmMode::FineGrain && svm_mode_ == SvmMode::FineGrain)
+    flags |= CL_MEM_SVM_FINE_GRAIN_BUFFER;
+#endif  // CL_VERSION_2_0
+  T* ptr = static_cast<T*>(tracker_->AllocateSvm(flags, size * sizeof(T),
+                                                 tag));
+  if (ptr == nullptr) return shared_array<T>(size);
+  std::shared_ptr<MemoryTracker> tracker = tracker_;
+  return shared_array<T>(std::shared_ptr<T>(ptr, [tracker](T* p) {
+    tracker->FreeSvm(p);
+  }), size);
+}
+
+template <typename T>
+shared_array<T> Queue::CreateStagingArray(size_t size) const {
+  if (numa_node_ < 0 || Numa::nodes() < 2) return shared_array<T>(size);
+  return MakeNumaArray<T>(size, NumaPolicy::Bind, numa_node_);
+}
+
+template <typename T>
+SvmArg Queue::CreateSvmArg(const shared_array<T>& array, ArgType arg_type,
+                           const char* tag) const {
+  SvmPointer svm;
+  if (tracker_->IsSvmPointer(array.get_raw())) {
+    svm.ptr = array.get_raw();
+  } else {
+    svm.ptr = nullptr;
+    svm.buffer = CreateBuffer(array, Queue::CastToBufferType(arg_type), tag);
+  }
+  return SvmArg(svm, arg_type);
+}
+
+template <typename T>
+void Queue::MapSvm(const shared_array<T>& array, cl_map_flags flags) const {
+#ifdef CL_VERSION_2_0
+  cl_mem_flags svm_flags = 0;
+  if (!tracker_->IsSvmPointer(array.get_raw(), &svm_flags) ||
+      (svm_flags & CL_MEM_SVM_FINE_GRAIN_BUFFER))
+    return;
+  cl_int err = clEnqueueSVMMap(queue_(), CL_TRUE, flags, array.get_raw(),
+                               array.memsize(), 0, nullptr, nullptr);
+  if (err != CL_SUCCESS) throw cl::Error(err, "clEnqueueSVMMap");
+#else
+  (void)array, (void)flags;
+#endif  // CL_VERSION_2_0
+}
+
+template <typename T>
+void Queue::UnmapSvm(const shared_array<T>& array) const {
+#ifdef CL_VERSION_2_0
+  cl_mem_flags svm_flags = 0;
+  if (!tracker_->IsSvmPointer(array.get_raw(), &svm_flags) ||
+      (svm_flags & CL_MEM_SVM_FINE_GRAIN_BUFFER))
+    return;
+  cl::Event event;
+  cl_int err = clEnqueueSVMUnmap(queue_(), array.get_raw(), 0, nullptr,
+                                 &event());
+  if (err != CL_SUCCESS) throw cl::Error(err, "clEnqueueSVMUnmap");
+  event.wait();
+#else
+  (void)array;
+#endif  // CL_VERSION_2_0
+}
+
 template <typename T>
 cl::LocalSpaceArg Queue::CreateLocalBuffer(size_t size) const {
   return cl::Local(size * sizeof(T));
@@ -331,15 +526,16 @@ cl::LocalSpaceArg Queue::CreateLocalBuffer(size_t size) const {
 
 template <typename T>
 BufferArg Queue::CreateKernelArg(const shared_array<T>& array,
-                                 ArgType arg_type) {
+                                 ArgType arg_type, const char* tag) {
   BufferType buffer_type = Queue::CastToBufferType(arg_type);
-  return BufferArg(this->CreateBuffer(array, buffer_type), arg_type);
+  return BufferArg(this->CreateBuffer(array, buffer_type, tag), arg_type);
 }
 
 template <typename T>
-BufferArg Queue::CreateKernelArg(size_t size, ArgType arg_type) {
+BufferArg Queue::CreateKernelArg(size_t size, ArgType arg_type,
+                                 const char* tag) {
   BufferType buffer_type = Queue::CastToBufferType(arg_type);
-  return BufferArg(this->CreateBuffer<T>(size, buffer_type), arg_type);
+  return BufferArg(this->CreateBuffer<T>(size, buffer_type, tag), arg_type);
 }
 
 template <typename T>
@@ -388,56 +584,40 @@ template <typename... Args>
 Task Queue::CreateTask(const std::string& programName,
                        const std::string& kernelName,
                        const std::string& options, const Args&... args) const {
-  char buff[512] = {0};
-  std::snprintf(buff, sizeof(buff), "program=\"%s\"\noptions=\"%s\"",
-                programName.c_str(), options.c_str());
-  std::string program_id(buff);
-  cl::Program program;
-
-  if (programs_.find(program_id) == programs_.end()) {
-    std::ifstream source_file(programName);
-    std::string source_code(std::istreambuf_iterator<char>(source_file),
-                            (std::istreambuf_iterator<char>()));
-    cl::Program::Sources cl_source(1, std::make_pair(source_code.c_str(),
-                                                     source_code.length() + 1));
-    // build program from source code
-    program = cl::Program(context_, cl_source);
-    try {
-      program.build({ device_ }, options.c_str());
-    } catch (const cl::Error& e) {
-      std::printf("Build log:\n%s\n",
-                  program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device_).c_str());
-      throw(e);
-    }
-    programs_[program_id] = program;
-  } else {
-    program = programs_[program_id];
-  }
-
-  cl::Kernel kernel = cl::Kernel(program, kernelName.c_str());
+  cl::Kernel kernel = cl::Kernel(GetProgram(programName, options),
+                                 kernelName.c_str());
   return Task(kernel, args...);
 }
 
-std::vector<cl::Event> ExtractEvents();
-
-template <typename T>
-std::vector<cl::Event> ExtractEvents(const T& data);
+template <typename... Params>
+TypedKernel<Params...> Queue::Kernel(const std::string& programName,
+                                     const std::string& kernelName,
+                                     const std::string& options) const {
+  cl::Kernel kernel = cl::Kernel(GetProgram(programName, options),
+                                 kernelName.c_str());
+  return TypedKernel<Params...>(queue_, kernel);
+}
 
-template <typename First, typename... Tail>
-std::vector<cl::Event> ExtractEvents(const First& first, const Tail&... tail);
+template <typename... Args>
+oclalgo::future<TaskResult> Queue::EnqueueTask(const Task& task,
+                                               const Grid& grid,
+                                               const Args&... deps) const {
+  WaitList events;
+  AppendEvents(&events, deps...);
+  cl::Event event = EnqueueKernel(queue_, task.kernel(), grid, events);
+  return oclalgo::future<TaskResult>(TaskResult(task), event);
+}
 
 template <typename... Args>
-oclalgo::future<std::vector<cl::Buffer>> Queue::EnqueueTask(
-    const Task& task, const Grid& grid, const Args&... args) const {
-  std::vector<cl::Event> events = ExtractEvents(args...), *pevents = nullptr;
-  if (events.size()) pevents = &events;
-  cl::Event event;
-  queue_.enqueueNDRangeKernel(task.kernel(), grid.offset(), grid.global(),
-                              grid.local(), pevents, &event);
-  return oclalgo::future<std::vector<cl::Buffer>>(task.output(), event);
+oclalgo::future<TaskResult> Queue::EnqueueTask(Task&& task, const Grid& grid,
+                                               const Args&... deps) const {
+  WaitList events;
+  AppendEvents(&events, deps...);
+  cl::Event event = EnqueueKernel(queue_, task.kernel(), grid, events);
+  return oclalgo::future<TaskResult>(TaskResult(std::move(task)), event);
 }
 
-BufferType Queue::CastToBufferType(ArgType arg_type) {
+inline BufferType Queue::CastToBufferType(ArgType arg_type) {
   switch (arg_type) {
     case ArgType::IN:
       return BufferType::ReadOnly;
@@ -450,27 +630,6 @@ BufferType Queue::CastToBufferType(ArgType arg_type) {
   }
 }
 
-template <typename T>
-std::vector<cl::Event> ExtractEvents(const oclalgo::future<T>& f) {
-  return std::vector<cl::Event>({ f.event() });
-}
-
-template <typename T, typename U>
-std::vector<cl::Event> ExtractEvents(const std::vector<oclalgo::future<T>>& f) {
-  std::vector<cl::Event> events;
-  for (const auto& el : f)
-    events.push_back(el.event());
-  return events;
-}
-
-template <typename First, typename... Tail>
-std::vector<cl::Event> ExtractEvents(const First& first, const Tail&... tail) {
-  std::vector<cl::Event> events = ExtractEvents(first);
-  std::vector<cl::Event> tail_events = ExtractEvents(tail...);
-  events.insert(events.end(), tail_events.begin(), tail_events.end());
-  return events;
-}
-
 }  // namespace oclalgo
 
 #endif  // INC_OCLALGO_QUEUE_H_
@@ -0,0 +1,174 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// Reductions of row-major rows x cols matrix along rows (one value per row)
+// or along columns (one value per column). Operation is selected by REDUCE
+// macro, for example:
+//   -D VAR_TYPE=float -D REDUCE=REDUCE_MAX -D GROUP_SIZE=256
+
+#ifndef VAR_TYPE
+#define VAR_TYPE int
+#endif  // VAR_TYPE
+
+// type of sqrt() argument for REDUCE_NORM
+#ifndef REAL_TYPE
+#define REAL_TYPE float
+#endif  // REAL_TYPE
+
+#define REDUCE_SUM 1
+#define REDUCE_MEAN 2
+#define REDUCE_MAX 3
+#define REDUCE_MIN 4
+#define REDUCE_NORM 5
+#define REDUCE_SUMSQ 6
+
+#ifndef REDUCE
+#define REDUCE REDUCE_SUM
+#endif  // REDUCE
+
+// INIT gets the first element of reduced row or column (max and min start
+// from it, so no type-specific identity is needed)
+#if REDUCE == REDUCE_SUM || REDUCE == REDUCE_MEAN
+#define INIT(first) ((VAR_TYPE)0)
+#define ACCUMULATE(acc, x) ((acc) + (x))
+#define COMBINE(a, b) ((a) + (b))
+#elif REDUCE == REDUCE_MAX
+#define INIT(first) (first)
+#define ACCUMULATE(acc, x) max((acc), (x))
+#define COMBINE(a, b) max((a), (b))
+#elif REDUCE == REDUCE_MIN
+#define INIT(first) (first)
+#define ACCUMULATE(acc, x) min((acc), (x))
+#define COMBINE(a, b) min((a), (b))
+#elif REDUCE == REDUCE_NORM || REDUCE == REDUCE_SUMSQ
+#define INIT(first) ((VAR_TYPE)0)
+#define ACCUMULATE(acc, x) ((acc) + (x) * (x))
+#define COMBINE(a, b) ((a) + (b))
+#else
+#error "unknown reduction"
+#endif
+
+#if REDUCE == REDUCE_MEAN
+#define FINALIZE(acc, n) ((acc) / (VAR_TYPE)(n))
+#elif REDUCE == REDUCE_NORM
+#define FINALIZE(acc, n) ((VAR_TYPE)sqrt((REAL_TYPE)(acc)))
+#else
+#define FINALIZE(acc, n) (acc)
+#endif
+
+#ifndef GROUP_SIZE
+#define GROUP_SIZE 256
+#endif  // GROUP_SIZE
+
+#ifndef TILE_COLS
+#define TILE_COLS 32
+#endif  // TILE_COLS
+
+#ifndef TILE_ROWS
+#define TILE_ROWS 8
+#endif  // TILE_ROWS
+
+// One work-group per row: work-items read row with stride GROUP_SIZE
+// (coalesced), partial results are combined by tree reduction in local
+// memory. GROUP_SIZE is a power of two.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void reduce_rows(__global const VAR_TYPE *A, __global VAR_TYPE *C,
+                 const int rows, const int cols) {
+  __local VAR_TYPE partial[GROUP_SIZE];
+  int lid = get_local_id(0);
+  for (int i = get_group_id(0); i < rows; i += get_num_groups(0)) {
+    __global const VAR_TYPE *row = A + (size_t)i * cols;
+    VAR_TYPE acc = INIT(row[0]);
+    for (int j = lid; j < cols; j += GROUP_SIZE)
+      acc = ACCUMULATE(acc, row[j]);
+    partial[lid] = acc;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = GROUP_SIZE / 2; s > 0; s >>= 1) {
+      if (lid < s)
+        partial[lid] = COMBINE(partial[lid], partial[lid + s]);
+      barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (lid == 0)
+      C[i] = FINALIZE(partial[0], cols);
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+// Work-group processes tile of TILE_COLS columns: neighbouring work-items
+// read neighbouring columns (coalesced), TILE_ROWS work-items split rows of
+// every column, their results are combined in local memory. TILE_ROWS is a
+// power of two.
+__kernel __attribute__((reqd_work_group_size(TILE_COLS, TILE_ROWS, 1)))
+void reduce_cols(__global const VAR_TYPE *A, __global VAR_TYPE *C,
+                 const int rows, const int cols) {
+  __local VAR_TYPE partial[TILE_ROWS][TILE_COLS];
+  int lx = get_local_id(0);
+  int ly = get_local_id(1);
+  for (int j0 = get_group_id(0) * TILE_COLS; j0 < cols;
+       j0 += get_num_groups(0) * TILE_COLS) {
+    int j = j0 + lx;
+    VAR_TYPE acc = 0;
+    if (j < cols) {
+      acc = INIT(A[j]);
+      for (int i = ly; i < rows; i += TILE_ROWS)
+        acc = ACCUMULATE(acc, A[(size_t)i * cols + j]);
+    }
+    partial[ly][lx] = acc;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = TILE_ROWS / 2; s > 0; s >>= 1) {
+      if (ly < s)
+        partial[ly][lx] = COMBINE(partial[ly][lx], partial[ly + s][lx]);
+      barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (ly == 0 && j < cols)
+      C[j] = FINALIZE(partial[0][lx], rows);
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+#undef TILE_ROWS
+#undef TILE_COLS
+#undef GROUP_SIZE
+#undef FINALIZE
+#undef COMBINE
+#undef ACCUMULATE
+#undef INIT
+#undef REAL_TYPE
+#undef VAR_TYPE
@@ -0,0 +1,141 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file scratch_pool.h
+ *  @brief Contains oclalgo::ScopedScratch class (device scratch pool).
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Scratch pool is active in the thread which created it until its
+ *  destruction. Buffers allocated from pool (including results of DMatrix
+ *  operators) must not escape its scope.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_SCRATCH_POOL_H_
+#define INC_OCLALGO_SCRATCH_POOL_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <atomic>
+#include <memory>
+
+#include <oclalgo/queue.h>
+
+namespace oclalgo {
+
+/*!
+ * @brief Scoped pool of device memory for short-lived buffers.
+ *
+ * Pool reserves one buffer (registered in memory tracker of the queue with
+ * tag "ScopedScratch") and returns sub-buffers of it, so allocation doesn't
+ * touch device allocator. While pool exists, DMatrix operators allocate
+ * results from it. If pool is exhausted, ordinary buffers are created.
+ * At destruction the reserved buffer is returned to the buffer cache of the
+ * queue (see Queue::RecycleBuffer()), so the next pool of the same capacity
+ * gets it without allocation. Live sub-buffers are counted by their
+ * destructor callbacks: if some of them aren't deleted at that moment (a
+ * result escaped the scope or commands using it are pending), the reserved
+ * buffer isn't recycled and is freed after the last of them.
+ */
+class ScopedScratch {
+ public:
+  /*!
+   * @brief Creates pool of <i>capacity</i> bytes and makes it active for
+   * <i>queue</i> in the calling thread.
+   */
+  ScopedScratch(const Queue* queue, size_t capacity);
+
+  ScopedScratch(const ScopedScratch&) = delete;
+  ScopedScratch& operator=(const ScopedScratch&) = delete;
+
+  /*!
+   * @brief Recycles reserved buffer (if all its sub-buffers are deleted)
+   * and activates the previous pool.
+   */
+  virtual ~ScopedScratch();
+
+  /*!
+   * @brief Returns active pool of the calling thread created for
+   * <i>queue</i> (or nullptr).
+   */
+  static ScopedScratch* active(const Queue* queue) noexcept;
+
+  /*!
+   * @brief Allocates buffer of <i>bytes</i> with corresponding flags (null
+   * buffer for zero bytes).
+   */
+  cl::Buffer Allocate(size_t bytes, cl_mem_flags flags = CL_MEM_READ_WRITE);
+
+  /** @brief Allocates buffer of <i>size</i> elements of type T. */
+  template <typename T>
+  cl::Buffer Allocate(size_t size, cl_mem_flags flags = CL_MEM_READ_WRITE) {
+    return Allocate(size * sizeof(T), flags);
+  }
+
+  /*!
+   * @brief Makes all pool memory available again.
+   *
+   * Buffers allocated before must not be used by commands enqueued after
+   * reset.
+   */
+  void Reset() noexcept { offset_ = used_ = 0; }
+
+  /** @brief Returns queue of this pool. */
+  const Queue* queue() const noexcept { return queue_; }
+  /** @brief Returns capacity of pool in bytes. */
+  size_t capacity() const noexcept { return capacity_; }
+  /** @brief Returns number of bytes allocated from pool. */
+  size_t used_bytes() const noexcept { return used_; }
+  /** @brief Returns number of bytes allocated by ordinary buffers. */
+  size_t overflow_bytes() const noexcept { return overflow_; }
+
+ private:
+  const Queue* queue_;
+  ScopedScratch* previous_;
+  cl::Buffer buffer_;
+  std::shared_ptr<std::atomic<int>> live_sub_buffers_;
+  size_t capacity_;
+  size_t align_;
+  size_t offset_;
+  size_t used_;
+  size_t overflow_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_SCRATCH_POOL_H_
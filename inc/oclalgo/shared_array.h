@@ -36,6 +36,11 @@
  *  @author Senin Dmitry <d.senin@samsung.com>
  *  @version 1.0
  *
+ *  @section Notes
+ *  Arrays created by size keep reference counter and data in one allocation
+ *  (as std::make_shared does), data is aligned to cache line. Arrays created
+ *  by raw or shared pointers allocate separate counter.
+ *
  *  @section Copyright
  *  Copyright 2013 Samsung R&D Institute Russia
  */
@@ -44,38 +49,202 @@
 #define INC_OCLALGO_SHARED_ARRAY_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 namespace oclalgo {
 
-/** @brief Class to provide shared array storage. */
+/** @brief Enum of reference counting modes of shared arrays. */
+enum class RefCount {
+  Atomic,    ///< copies can be used by different threads
+  NonAtomic  ///< all copies are used by one thread (copying is cheaper)
+};
+
+namespace internal {
+
+/** @brief Reference counter of shared_array data. */
+class ArrayHeader {
+ public:
+  typedef void (*DestroyFunction)(ArrayHeader*);
+
+  ArrayHeader(RefCount mode, DestroyFunction destroy) noexcept
+      : count_(1),
+        atomic_(mode == RefCount::Atomic),
+        destroy_(destroy) {
+  }
+
+  void Retain() noexcept {
+    if (atomic_)
+      count_.fetch_add(1, std::memory_order_relaxed);
+    else
+      count_.store(count_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  }
+
+  void Release() noexcept {
+    long count;
+    if (atomic_) {
+      count = count_.fetch_sub(1, std::memory_order_acq_rel) - 1;
+    } else {
+      count = count_.load(std::memory_order_relaxed) - 1;
+      count_.store(count, std::memory_order_relaxed);
+    }
+    if (count == 0) destroy_(this);
+  }
+
+  long use_count() const noexcept {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<long> count_;
+  bool atomic_;
+  DestroyFunction destroy_;
+};
+
+// header and data are placed in one allocation: [header][padding][data],
+// storage is allocated in std::max_align_t units to align header
+template <typename T, typename StorageAlloc>
+class InlineHeader : public ArrayHeader {
+ public:
+  typedef typename StorageAlloc::value_type Unit;
+
+  constexpr static size_t alignment =
+      alignof(T) > 64 ? alignof(T) : 64;
+
+  static T* Create(size_t size, const StorageAlloc& alloc, RefCount mode,
+                   ArrayHeader** header) {
+    typedef typename std::remove_const<T>::type U;
+    StorageAlloc storage_alloc(alloc);
+    size_t bytes = sizeof(InlineHeader) + alignment - 1 + size * sizeof(T);
+    size_t units = (bytes + sizeof(Unit) - 1) / sizeof(Unit);
+    Unit* raw = storage_alloc.allocate(units);
+    uintptr_t begin = reinterpret_cast<uintptr_t>(raw) + sizeof(InlineHeader);
+    U* data = reinterpret_cast<U*>((begin + alignment - 1) / alignment *
+                                   alignment);
+    size_t i = 0;
+    try {
+      for (; i < size; ++i)
+        new (data + i) U;
+    } catch (...) {
+      DestroyElements(data, i);
+      storage_alloc.deallocate(raw, units);
+      throw;
+    }
+    *header = new (raw) InlineHeader(mode, storage_alloc, units, size, data);
+    return data;
+  }
+
+ private:
+  InlineHeader(RefCount mode, const StorageAlloc& alloc, size_t units,
+               size_t size, T* data)
+      : ArrayHeader(mode, &InlineHeader::Destroy),
+        alloc_(alloc),
+        units_(units),
+        size_(size),
+        data_(data) {
+  }
+
+  template <typename U>
+  static void DestroyElements(U* data, size_t size) {
+    if (!std::is_trivially_destructible<U>::value)
+      while (size > 0) data[--size].~U();
+  }
+
+  static void Destroy(ArrayHeader* header) {
+    InlineHeader* h = static_cast<InlineHeader*>(header);
+    DestroyElements(const_cast<typename std::remove_const<T>::type*>(h->data_),
+                    h->size_);
+    StorageAlloc alloc(h->alloc_);
+    size_t units = h->units_;
+    h->~InlineHeader();
+    alloc.deallocate(reinterpret_cast<Unit*>(h), units);
+  }
+
+  StorageAlloc alloc_;
+  size_t units_;  // allocated storage in StorageAlloc units
+  size_t size_;
+  T* data_;
+};
+
+// header of data owned by another object (raw or shared pointer)
+template <typename Owner>
+class OwnerHeader : public ArrayHeader {
+ public:
+  OwnerHeader(RefCount mode, Owner&& owner)
+      : ArrayHeader(mode, &OwnerHeader::Destroy),
+        owner_(std::move(owner)) {
+  }
+
+ private:
+  static void Destroy(ArrayHeader* header) {
+    delete static_cast<OwnerHeader*>(header);
+  }
+
+  Owner owner_;
+};
+
+}  // namespace internal
+
+/*!
+ * @brief Class to provide shared array storage.
+ *
+ * Copies of array share data and reference counter. Elements are accessed by
+ * raw pointers (operator[], begin(), end(), data()), so loops over arrays are
+ * vectorized by compiler.
+ */
 template<typename T>
 class shared_array {
+  template <typename U> friend class shared_array;
+
  public:
   typedef T element_type;
+  typedef T value_type;
+  typedef T* iterator;
+  typedef const T* const_iterator;
 
-  shared_array();
-  /** @brief Creates shared array with corresponding size. */
+  shared_array() noexcept;
+  /*!
+   * @brief Creates shared array with corresponding size.
+   *
+   * Reference counter and elements are placed in one allocation.
+   */
   explicit shared_array(size_t size);
+  /** @brief Creates shared array with corresponding reference counting. */
+  shared_array(size_t size, RefCount mode);
+  /*!
+   * @brief Creates shared array in memory of allocator <i>alloc</i> (counter
+   * and elements are placed in one allocation).
+   */
+  template <typename Alloc>
+  shared_array(size_t size, const Alloc& alloc,
+               RefCount mode = RefCount::Atomic);
   /** @brief Creates shared array based on raw pointer and data size. */
   shared_array(T* ptr, size_t size);
   /** @brief Creates shared array based on shared pointer and data size. */
   shared_array(const std::shared_ptr<T>& sp, size_t size);
 
-  shared_array(const shared_array<T>& array);
-  shared_array<T>& operator=(const shared_array<T>& array);
+  shared_array(const shared_array<T>& array) noexcept;
+  shared_array(shared_array<T>&& array) noexcept;
+  shared_array<T>& operator=(const shared_array<T>& array) noexcept;
+  shared_array<T>& operator=(shared_array<T>&& array) noexcept;
+
+  ~shared_array() { if (header_) header_->Release(); }
 
   /** @brief Swaps data of this array with array in argument. */
-  inline void swap(shared_array<T>& array);
+  inline void swap(shared_array<T>& array) noexcept;
 
   /** @brief Resets data of shared array. */
-  inline void reset();
+  inline void reset() noexcept;
 
   /*!
    * @brief Resets data of shared array to corresponding shared pointer and
    * data size.
    */
-
   inline void reset(const std::shared_ptr<T>& sp, size_t size);
   /*!
    * @brief Resets data of shared array to corresponding raw pointer and
@@ -83,111 +252,173 @@ class shared_array {
    */
   inline void reset(T* ptr, size_t size);
 
-  const T& operator[](std::ptrdiff_t i) const noexcept;
-  T& operator[](std::ptrdiff_t i) noexcept;
+  const T& operator[](std::ptrdiff_t i) const noexcept { return ptr_[i]; }
+  T& operator[](std::ptrdiff_t i) noexcept { return ptr_[i]; }
 
   /** @brief Checks for the existence of data. */
-  operator bool() const noexcept;
+  operator bool() const noexcept { return ptr_ != nullptr; }
   /** @brief Convert data pointer to const data pointer. */
-  operator shared_array<const T>() const;
+  operator shared_array<const T>() const noexcept;
 
-  /** @brief Returns shared pointer to array data. */
-  std::shared_ptr<T> get() const noexcept { return sp_; }
+  /*!
+   * @brief Returns shared pointer to array data.
+   *
+   * Shared pointer holds a reference to array data (it allocates control
+   * block, so get_raw() or data() should be used in loops).
+   */
+  std::shared_ptr<T> get() const;
   /** @brief Returns raw pointer to array data. */
-  T* get_raw() const noexcept { return sp_.get(); }
+  T* get_raw() const noexcept { return ptr_; }
+  /** @brief Returns raw pointer to array data. */
+  T* data() const noexcept { return ptr_; }
+  /** @brief Returns pointer to the first element. */
+  T* begin() const noexcept { return ptr_; }
+  /** @brief Returns pointer past the last element. */
+  T* end() const noexcept { return ptr_ + size_; }
   /** @brief Returns true if this shared array data is unique. */
-  bool unique() const noexcept { return sp_.unique(); }
+  bool unique() const noexcept { return use_count() == 1; }
   /** @brief Returns number of references on shared array data. */
-  int use_count() const noexcept { return sp_.use_count(); }
+  int use_count() const noexcept {
+    return header_ ? static_cast<int>(header_->use_count()) : 0;
+  }
   /** @brief Returns number of elements in shared array. */
   size_t size() const noexcept { return size_; }
   /** @brief Returns memory size occupied by shared array. */
   size_t memsize() const noexcept { return sizeof(T) * size_; }
 
  private:
-  std::shared_ptr<T> sp_;  // shared memory, which contains host array
-  size_t size_;            // number of elements in array
+  shared_array(T* ptr, size_t size, internal::ArrayHeader* header) noexcept
+      : ptr_(ptr),
+        size_(size),
+        header_(header) {
+  }
+
+  T* ptr_;                         // array data
+  size_t size_;                    // number of elements in array
+  internal::ArrayHeader* header_;  // reference counter
 };
 
 template <typename T>
-shared_array<T>::shared_array() : size_(0) {
+shared_array<T>::shared_array() noexcept
+    : ptr_(nullptr),
+      size_(0),
+      header_(nullptr) {
 }
 
 template <typename T>
 shared_array<T>::shared_array(size_t size)
-    : sp_(new T[size], std::default_delete<T[]>()),
-      size_(size) {
+    : shared_array(size, std::allocator<std::max_align_t>(), RefCount::Atomic) {
+}
+
+template <typename T>
+shared_array<T>::shared_array(size_t size, RefCount mode)
+    : shared_array(size, std::allocator<std::max_align_t>(), mode) {
+}
+
+template <typename T>
+template <typename Alloc>
+shared_array<T>::shared_array(size_t size, const Alloc& alloc, RefCount mode)
+    : ptr_(nullptr),
+      size_(size),
+      header_(nullptr) {
+  typedef typename std::allocator_traits<Alloc>::template rebind_alloc<
+      std::max_align_t> StorageAlloc;
+  ptr_ = internal::InlineHeader<T, StorageAlloc>::Create(
+      size, StorageAlloc(alloc), mode, &header_);
 }
 
 template <typename T>
 shared_array<T>::shared_array(T* ptr, size_t size)
-    : sp_(ptr, std::default_delete<T[]>()),
-      size_(size) {
+    : ptr_(ptr),
+      size_(size),
+      header_(nullptr) {
+  std::unique_ptr<T[]> owner(ptr);
+  header_ = new internal::OwnerHeader<std::unique_ptr<T[]>>(
+      RefCount::Atomic, std::move(owner));
 }
 
 template <typename T>
 shared_array<T>::shared_array(const std::shared_ptr<T>& sp, size_t size)
-    : sp_(sp),
-      size_(size) {
+    : ptr_(sp.get()),
+      size_(size),
+      header_(nullptr) {
+  if (sp) {
+    std::shared_ptr<T> owner(sp);
+    header_ = new internal::OwnerHeader<std::shared_ptr<T>>(
+        RefCount::Atomic, std::move(owner));
+  }
 }
 
 template <typename T>
-shared_array<T>::shared_array(const shared_array<T>& array)
-    : sp_(array.sp_),
-      size_(array.size_) {
+shared_array<T>::shared_array(const shared_array<T>& array) noexcept
+    : ptr_(array.ptr_),
+      size_(array.size_),
+      header_(array.header_) {
+  if (header_) header_->Retain();
 }
 
 template <typename T>
-shared_array<T>& shared_array<T>::operator=(const shared_array<T>& array) {
-  if (this != &array) {
-    sp_ = array.sp_;
-    size_ = array.size_;
-  }
-  return *this;
+shared_array<T>::shared_array(shared_array<T>&& array) noexcept
+    : ptr_(array.ptr_),
+      size_(array.size_),
+      header_(array.header_) {
+  array.ptr_ = nullptr;
+  array.size_ = 0;
+  array.header_ = nullptr;
 }
 
 template <typename T>
-inline void shared_array<T>::reset() {
-  sp_.reset();
-  size_ = 0;
+shared_array<T>& shared_array<T>::operator=(
+    const shared_array<T>& array) noexcept {
+  shared_array<T>(array).swap(*this);
+  return *this;
 }
 
 template <typename T>
-inline void shared_array<T>::reset(const std::shared_ptr<T>& sp, size_t size) {
-  sp_ = sp;
-  size_ = size;
+shared_array<T>& shared_array<T>::operator=(shared_array<T>&& array) noexcept {
+  shared_array<T>(std::move(array)).swap(*this);
+  return *this;
 }
 
 template <typename T>
-inline void shared_array<T>::reset(T* ptr, size_t size) {
-  sp_.reset(ptr, std::default_delete<T[]>());
-  size_ = size;
+inline void shared_array<T>::reset() noexcept {
+  shared_array<T>().swap(*this);
 }
 
 template <typename T>
-inline void shared_array<T>::swap(shared_array<T>& array) {
-  sp_.swap(array.sp_);
-  std::swap(size_, array.size_);
+inline void shared_array<T>::reset(const std::shared_ptr<T>& sp, size_t size) {
+  shared_array<T>(sp, size).swap(*this);
 }
 
 template <typename T>
-const T& shared_array<T>::operator[](std::ptrdiff_t i) const noexcept {
-  return *(sp_.get() + i);
+inline void shared_array<T>::reset(T* ptr, size_t size) {
+  shared_array<T>(ptr, size).swap(*this);
 }
 
 template <typename T>
-T& shared_array<T>::operator[](std::ptrdiff_t i) noexcept {
-  return *(sp_.get() + i);
+inline void shared_array<T>::swap(shared_array<T>& array) noexcept {
+  std::swap(ptr_, array.ptr_);
+  std::swap(size_, array.size_);
+  std::swap(header_, array.header_);
 }
 
 template <typename T>
-shared_array<T>::operator bool() const noexcept {
-  return sp_.get() != nullptr;
+shared_array<T>::operator shared_array<const T>() const noexcept {
+  if (header_) header_->Retain();
+  return shared_array<const T>(ptr_, size_, header_);
 }
 
 template <typename T>
-shared_array<T>::operator shared_array<const T>() const {
-  return shared_array<const T>(sp_, size_);
+std::shared_ptr<T> shared_array<T>::get() const {
+  if (header_ == nullptr) return std::shared_ptr<T>();
+  internal::ArrayHeader* header = header_;
+  header->Retain();
+  try {
+    return std::shared_ptr<T>(ptr_, [header](T*) { header->Release(); });
+  } catch (...) {
+    header->Release();
+    throw;
+  }
 }
 
 template<class T>
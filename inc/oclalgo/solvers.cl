@@ -0,0 +1,283 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// Vector kernels of Krylov solvers (solvers.h). Scalars of solvers (dot
+// products) are kept in device array S and are read by kernels, so
+// iterations don't wait for host. Dot products are reduced in two stages:
+// partial sums of work-groups (fused with vector updates) and
+// reduce_partials kernel of one work-group.
+
+#ifndef VAR_TYPE
+#define VAR_TYPE float
+#endif  // VAR_TYPE
+
+#ifndef GROUP_SIZE
+#define GROUP_SIZE 256
+#endif  // GROUP_SIZE
+
+#ifndef LANES
+#define LANES 32
+#endif  // LANES
+
+// Coefficients are zero after breakdown (zero denominator), so solvers stall
+// instead of filling vectors with NaN.
+#define SAFE_DIV(a, b) ((b) != 0 ? (a) / (b) : 0)
+
+// Writes sums of a and b over work-group to P[2 * group] and
+// P[2 * group + 1].
+inline void store_partials(__local VAR_TYPE *part_a, __local VAR_TYPE *part_b,
+                           VAR_TYPE a, VAR_TYPE b, __global VAR_TYPE *P) {
+  int lid = get_local_id(0);
+  part_a[lid] = a;
+  part_b[lid] = b;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int s = GROUP_SIZE / 2; s > 0; s >>= 1) {
+    if (lid < s) {
+      part_a[lid] += part_a[lid + s];
+      part_b[lid] += part_b[lid + s];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  if (lid == 0) {
+    P[2 * get_group_id(0)] = part_a[0];
+    P[2 * get_group_id(0) + 1] = part_b[0];
+  }
+}
+
+// Dense matrix-vector product y = A x, LANES work-items per row.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void dense_mv(__global const VAR_TYPE *A, __global const VAR_TYPE *x,
+              __global VAR_TYPE *y, const int rows, const int cols) {
+  __local VAR_TYPE partial[GROUP_SIZE];
+  int lid = get_local_id(0);
+  int lane = lid % LANES;
+  for (int r = get_group_id(0) * (GROUP_SIZE / LANES); r < rows;
+       r += get_num_groups(0) * (GROUP_SIZE / LANES)) {
+    int i = r + lid / LANES;
+    VAR_TYPE sum = 0;
+    if (i < rows) {
+      __global const VAR_TYPE *a = A + (size_t)i * cols;
+      for (int j = lane; j < cols; j += LANES)
+        sum += a[j] * x[j];
+    }
+    partial[lid] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int s = LANES / 2; s > 0; s >>= 1) {
+      if (lane < s)
+        partial[lid] += partial[lid + s];
+      barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (lane == 0 && i < rows)
+      y[i] = partial[lid];
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+}
+
+// Partial sums of a.b.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void dot(__global const VAR_TYPE *a, __global const VAR_TYPE *b,
+         __global VAR_TYPE *P, const int n) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  VAR_TYPE ab = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    ab += a[i] * b[i];
+  store_partials(part_a, part_b, ab, 0, P);
+}
+
+// Partial sums of a.b and c.d.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void dot2(__global const VAR_TYPE *a, __global const VAR_TYPE *b,
+          __global const VAR_TYPE *c, __global const VAR_TYPE *d,
+          __global VAR_TYPE *P, const int n) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  VAR_TYPE ab = 0;
+  VAR_TYPE cd = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    ab += a[i] * b[i];
+    cd += c[i] * d[i];
+  }
+  store_partials(part_a, part_b, ab, cd, P);
+}
+
+// Sums partial results of <groups> work-groups: S[slot_a] and S[slot_b]
+// (negative slot_b - the second sum isn't stored).
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void reduce_partials(__global const VAR_TYPE *P, const int groups,
+                     __global VAR_TYPE *S, const int slot_a,
+                     const int slot_b) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  int lid = get_local_id(0);
+  VAR_TYPE a = 0;
+  VAR_TYPE b = 0;
+  for (int g = lid; g < groups; g += GROUP_SIZE) {
+    a += P[2 * g];
+    b += P[2 * g + 1];
+  }
+  part_a[lid] = a;
+  part_b[lid] = b;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int s = GROUP_SIZE / 2; s > 0; s >>= 1) {
+    if (lid < s) {
+      part_a[lid] += part_a[lid + s];
+      part_b[lid] += part_b[lid + s];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  if (lid == 0) {
+    S[slot_a] = part_a[0];
+    if (slot_b >= 0)
+      S[slot_b] = part_b[0];
+  }
+}
+
+// r = b - r (r contains A x), p = r, partial sums of r.r and b.b.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void residual(__global const VAR_TYPE *b, __global VAR_TYPE *r,
+              __global VAR_TYPE *p, __global VAR_TYPE *P, const int n) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  VAR_TYPE rr = 0;
+  VAR_TYPE bb = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    VAR_TYPE value = b[i] - r[i];
+    r[i] = value;
+    p[i] = value;
+    rr += value * value;
+    bb += b[i] * b[i];
+  }
+  store_partials(part_a, part_b, rr, bb, P);
+}
+
+// CG slots of S: r.r (two slots, current and new), p.q
+#define CG_PQ 2
+
+// CG: alpha = rr / p.q; x += alpha p; r -= alpha q; partial sums of r.r.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void cg_update(__global VAR_TYPE *x, __global VAR_TYPE *r,
+               __global const VAR_TYPE *p, __global const VAR_TYPE *q,
+               __global const VAR_TYPE *S, __global VAR_TYPE *P,
+               const int rr_slot, const int n) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  VAR_TYPE alpha = SAFE_DIV(S[rr_slot], S[CG_PQ]);
+  VAR_TYPE rr = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    x[i] += alpha * p[i];
+    VAR_TYPE value = r[i] - alpha * q[i];
+    r[i] = value;
+    rr += value * value;
+  }
+  store_partials(part_a, part_b, rr, 0, P);
+}
+
+// CG: beta = rr_new / rr; p = r + beta p.
+__kernel void cg_direction(__global VAR_TYPE *p, __global const VAR_TYPE *r,
+                           __global const VAR_TYPE *S, const int rr_slot,
+                           const int n) {
+  VAR_TYPE beta = SAFE_DIV(S[1 - rr_slot], S[rr_slot]);
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    p[i] = r[i] + beta * p[i];
+}
+
+// BiCGSTAB slots of S: rho = r0.r (two slots, current and new), r0.v, t.s,
+// t.t
+#define BI_R0V 2
+#define BI_TS 3
+#define BI_TT 4
+
+// BiCGSTAB: alpha = rho / r0.v; s = r - alpha v.
+__kernel void bicgstab_s(__global const VAR_TYPE *r,
+                         __global const VAR_TYPE *v, __global VAR_TYPE *s,
+                         __global const VAR_TYPE *S, const int rho_slot,
+                         const int n) {
+  VAR_TYPE alpha = SAFE_DIV(S[rho_slot], S[BI_R0V]);
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    s[i] = r[i] - alpha * v[i];
+}
+
+// BiCGSTAB: omega = t.s / t.t; x += alpha p + omega s; r = s - omega t;
+// partial sums of r0.r and r.r.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void bicgstab_update(__global VAR_TYPE *x, __global VAR_TYPE *r,
+                     __global const VAR_TYPE *r0, __global const VAR_TYPE *p,
+                     __global const VAR_TYPE *s, __global const VAR_TYPE *t,
+                     __global const VAR_TYPE *S, __global VAR_TYPE *P,
+                     const int rho_slot, const int n) {
+  __local VAR_TYPE part_a[GROUP_SIZE];
+  __local VAR_TYPE part_b[GROUP_SIZE];
+  VAR_TYPE alpha = SAFE_DIV(S[rho_slot], S[BI_R0V]);
+  VAR_TYPE omega = SAFE_DIV(S[BI_TS], S[BI_TT]);
+  VAR_TYPE r0r = 0;
+  VAR_TYPE rr = 0;
+  for (int i = get_global_id(0); i < n; i += get_global_size(0)) {
+    x[i] += alpha * p[i] + omega * s[i];
+    VAR_TYPE value = s[i] - omega * t[i];
+    r[i] = value;
+    r0r += r0[i] * value;
+    rr += value * value;
+  }
+  store_partials(part_a, part_b, r0r, rr, P);
+}
+
+// BiCGSTAB: beta = (rho_new / rho) (alpha / omega); p = r + beta (p - omega v).
+__kernel void bicgstab_direction(__global VAR_TYPE *p,
+                                 __global const VAR_TYPE *r,
+                                 __global const VAR_TYPE *v,
+                                 __global const VAR_TYPE *S,
+                                 const int rho_slot, const int n) {
+  VAR_TYPE alpha = SAFE_DIV(S[rho_slot], S[BI_R0V]);
+  VAR_TYPE omega = SAFE_DIV(S[BI_TS], S[BI_TT]);
+  VAR_TYPE beta = SAFE_DIV(S[1 - rho_slot], S[rho_slot]) *
+                  SAFE_DIV(alpha, omega);
+  for (int i = get_global_id(0); i < n; i += get_global_size(0))
+    p[i] = r[i] + beta * (p[i] - omega * v[i]);
+}
+
+#undef BI_TT
+#undef BI_TS
+#undef BI_R0V
+#undef CG_PQ
+#undef SAFE_DIV
+#undef LANES
+#undef GROUP_SIZE
+#undef VAR_TYPE
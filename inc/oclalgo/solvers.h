@@ -0,0 +1,471 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file solvers.h
+ *  @brief Contains Krylov solvers of linear systems (oclalgo::ConjugateGradient
+ *  and oclalgo::BiCgStab) and matrix operators for them.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  All vectors and scalars of solvers stay in device memory: coefficients
+ *  (alpha, beta, omega) are computed by kernels from dot products stored in
+ *  device buffer, so iterations are enqueued without waiting for host.
+ *  Residual is read by host asynchronously once in
+ *  SolverOptions::check_every iterations and is checked one interval later,
+ *  when the read is already finished (so up to 2 * check_every extra
+ *  iterations are made after convergence). Kernels are in solvers.cl and
+ *  sparse.cl.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_SOLVERS_H_
+#define INC_OCLALGO_SOLVERS_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <oclalgo/dmatrix.h>
+
+namespace oclalgo {
+
+/*!
+ * @brief Square matrix operator y = A x used by solvers.
+ *
+ * Apply() enqueues computation of y into MatrixQueue::instance() and
+ * returns without waiting.
+ */
+template <typename T>
+class LinearOperator {
+ public:
+  virtual ~LinearOperator() = default;
+
+  /** @brief Returns number of rows (and columns) of operator. */
+  virtual int size() const = 0;
+  /** @brief Enqueues y = A x (both buffers contain size() elements). */
+  virtual void Apply(const cl::Buffer& x, const cl::Buffer& y) const = 0;
+};
+
+namespace internal {
+
+constexpr int solver_group_size = 256;
+constexpr int solver_lanes = 32;
+
+inline std::string SolverBuildOptions(const std::string& type) {
+  char buff[128] = {0};
+  std::snprintf(buff, sizeof(buff), "-D VAR_TYPE=%s -D GROUP_SIZE=%d "
+                "-D LANES=%d", type.c_str(), solver_group_size, solver_lanes);
+  return buff;
+}
+
+template <typename U>
+cl::Buffer Upload(const std::vector<U>& data) {
+  shared_array<U> array(data.size());
+  std::copy(data.begin(), data.end(), array.begin());
+  return MatrixQueue::instance()->CreateBuffer(
+      array, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, "Solver");
+}
+
+/** @brief Grid of kernels processing every row by solver_lanes work-items. */
+inline Grid RowLaneGrid(int rows) {
+  size_t rows_per_group = solver_group_size / solver_lanes;
+  size_t groups = std::min<size_t>(
+      (rows + rows_per_group - 1) / rows_per_group,
+      std::max<size_t>(1, MaxWorkItems() / solver_group_size));
+  return Grid(cl::NDRange(groups * solver_group_size),
+              cl::NDRange(solver_group_size));
+}
+
+}  // namespace internal
+
+/** @brief Operator of dense square DMatrix. */
+template <typename T>
+class DenseOperator : public LinearOperator<T> {
+ public:
+  explicit DenseOperator(const DMatrix<T>& m)
+      : buffer_(m.buffer()),
+        rows_(m.rows()),
+        cols_(m.cols()) {
+    assert(m.rows() == m.cols());
+  }
+
+  int size() const override { return rows_; }
+  void Apply(const cl::Buffer& x, const cl::Buffer& y) const override {
+    Queue* queue = MatrixQueue::instance();
+    queue->EnqueueTask(queue->CreateTask(
+        "solvers.cl", "dense_mv",
+        internal::SolverBuildOptions(PrintType<T>()), buffer_, x, y, rows_,
+        cols_), internal::RowLaneGrid(rows_));
+  }
+
+ private:
+  cl::Buffer buffer_;
+  int rows_;
+  int cols_;
+};
+
+/*!
+ * @brief Operator of square sparse matrix in CSR format (row_ptr of
+ * rows + 1 offsets, column indices and values of nonzero elements).
+ */
+template <typename T>
+class CsrOperator : public LinearOperator<T> {
+ public:
+  CsrOperator(int rows, const cl::Buffer& row_ptr, const cl::Buffer& col_idx,
+              const cl::Buffer& values)
+      : rows_(rows),
+        row_ptr_(row_ptr),
+        col_idx_(col_idx),
+        values_(values) {
+  }
+
+  /** @brief Copies CSR matrix from host to device. */
+  static CsrOperator FromHost(const std::vector<int>& row_ptr,
+                              const std::vector<int>& col_idx,
+                              const std::vector<T>& values);
+
+  int size() const override { return rows_; }
+  void Apply(const cl::Buffer& x, const cl::Buffer& y) const override {
+    Queue* queue = MatrixQueue::instance();
+    queue->EnqueueTask(queue->CreateTask(
+        "sparse.cl", "csr_mv", internal::SolverBuildOptions(PrintType<T>()),
+        row_ptr_, col_idx_, values_, x, y, rows_),
+        internal::RowLaneGrid(rows_));
+  }
+
+ private:
+  int rows_;
+  cl::Buffer row_ptr_;
+  cl::Buffer col_idx_;
+  cl::Buffer values_;
+};
+
+/** @brief Parameters of iterative solvers. */
+struct SolverOptions {
+  int max_iterations = 1000;
+  /** @brief Solver stops when |b - A x| <= tolerance * |b|. */
+  double tolerance = 1e-6;
+  /*!
+   * @brief Number of iterations between residual reads.
+   *
+   * Residual read at a check is evaluated at the next check, so solver
+   * makes up to 2 * check_every iterations more than necessary, but host
+   * doesn't stall device every iteration.
+   */
+  int check_every = 4;
+};
+
+/** @brief Result of iterative solver. */
+struct SolverResult {
+  /** @brief Number of performed iterations. */
+  int iterations = 0;
+  /** @brief The last read relative residual |b - A x| / |b|. */
+  double residual = 0;
+  bool converged = false;
+};
+
+/*!
+ * @brief Solves A x = b by conjugate gradient method (A is symmetric
+ * positive definite).
+ *
+ * b and x are n x 1 matrices, x contains initial approximation on input
+ * and solution on output.
+ */
+template <typename T>
+SolverResult ConjugateGradient(const LinearOperator<T>& a,
+                               const DMatrix<T>& b, DMatrix<T>* x,
+                               const SolverOptions& options = SolverOptions());
+
+/*!
+ * @brief Solves A x = b by stabilized biconjugate gradient method
+ * (BiCGSTAB) for general nonsingular A.
+ *
+ * b and x are n x 1 matrices, x contains initial approximation on input
+ * and solution on output.
+ */
+template <typename T>
+SolverResult BiCgStab(const LinearOperator<T>& a, const DMatrix<T>& b,
+                      DMatrix<T>* x,
+                      const SolverOptions& options = SolverOptions());
+
+namespace internal {
+
+/*!
+ * @brief Device buffers and kernel launches shared by Krylov solvers and
+ * other iterative methods (PageRank).
+ *
+ * Dot products are computed by two kernels: work-groups write partial sums
+ * to partials_ (fused with vector updates where possible), reduce_partials
+ * sums them into slots of scalars_.
+ */
+template <typename T>
+class KrylovWorkspace {
+ public:
+  constexpr static int slots = 8;
+
+  explicit KrylovWorkspace(int n)
+      : n_(n),
+        groups_(static_cast<int>(std::min<size_t>(
+            (n + solver_group_size - 1) / solver_group_size,
+            std::max<size_t>(1, MaxWorkItems() / solver_group_size)))),
+        scalars_(Allocate(slots)),
+        partials_(Allocate(2 * groups_)) {
+  }
+
+  cl::Buffer Allocate(size_t size) const {
+    return MatrixQueue::instance()->CreateBuffer<T>(size, CL_MEM_READ_WRITE,
+                                                    "Solver");
+  }
+
+  template <typename... Args>
+  void Run(const char* kernel, const Grid& grid, const Args&... args) const {
+    Queue* queue = MatrixQueue::instance();
+    queue->EnqueueTask(queue->CreateTask(
+        "solvers.cl", kernel, SolverBuildOptions(PrintType<T>()), args...),
+        grid);
+  }
+
+  /** @brief Grid of kernels writing partial sums. */
+  Grid partial_grid() const {
+    return Grid(cl::NDRange(groups_ * solver_group_size),
+                cl::NDRange(solver_group_size));
+  }
+  /** @brief Grid of element-wise kernels. */
+  Grid vector_grid() const { return StrideGrid(n_); }
+
+  /*!
+   * @brief Sums partials into scalars slot_a and slot_b (negative slot_b -
+   * the second sum is dropped).
+   */
+  void Reduce(int slot_a, int slot_b) const {
+    Run("reduce_partials", Grid(cl::NDRange(solver_group_size),
+                                cl::NDRange(solver_group_size)),
+        partials_, groups_, scalars_, slot_a, slot_b);
+  }
+
+  /** @brief Stores a.b into scalar slot. */
+  void Dot(const cl::Buffer& a, const cl::Buffer& b, int slot) const {
+    Run("dot", partial_grid(), a, b, partials_, n_);
+    Reduce(slot, -1);
+  }
+
+  /** @brief Stores a.b and c.d into scalars slot_a and slot_b. */
+  void Dot2(const cl::Buffer& a, const cl::Buffer& b, const cl::Buffer& c,
+            const cl::Buffer& d, int slot_a, int slot_b) const {
+    Run("dot2", partial_grid(), a, b, c, d, partials_, n_);
+    Reduce(slot_a, slot_b);
+  }
+
+  /*!
+   * @brief Computes r = b - A x and p = r, stores r.r and b.b into scalars
+   * slot_rr and slot_bb.
+   */
+  void Residual(const LinearOperator<T>& a, const cl::Buffer& b,
+                const cl::Buffer& x, const cl::Buffer& r, const cl::Buffer& p,
+                int slot_rr, int slot_bb) const {
+    a.Apply(x, r);
+    Run("residual", partial_grid(), b, r, p, partials_, n_);
+    Reduce(slot_rr, slot_bb);
+  }
+
+  /** @brief Reads all scalars (synchronously). */
+  shared_array<T> ReadAll() const {
+    Queue* queue = MatrixQueue::instance();
+    return queue->memcpy(queue->CreateStagingArray<T>(slots), scalars_);
+  }
+
+  /** @brief Starts asynchronous read of scalar slot. */
+  oclalgo::future<shared_array<T>> ReadAsync(int slot) const {
+    Queue* queue = MatrixQueue::instance();
+    oclalgo::future<shared_array<T>> f = queue->memcpy(
+        queue->CreateStagingArray<T>(1), scalars_, BlockingType::Unblock,
+        slot * sizeof(T));
+    queue->queue().flush();
+    return f;
+  }
+
+  int n() const noexcept { return n_; }
+  const cl::Buffer& scalars() const noexcept { return scalars_; }
+  const cl::Buffer& partials() const noexcept { return partials_; }
+
+ private:
+  int n_;
+  int groups_;
+  cl::Buffer scalars_;
+  cl::Buffer partials_;
+};
+
+/*!
+ * @brief Runs up to <i>max_iterations</i> iterations and checks a scalar
+ * read asynchronously every <i>check_every</i> iterations.
+ *
+ * <i>step</i> enqueues one iteration and returns scalar slot to check,
+ * <i>check</i> gets the value read at the previous check (when the read is
+ * already finished) and returns true to stop. Returns number of iterations.
+ */
+template <typename T, typename Step, typename Check>
+int IterateLagged(const KrylovWorkspace<T>& ws, int max_iterations,
+                  int check_every, Step step, Check check) {
+  check_every = std::max(1, check_every);
+  // read started at the previous check (null event - none)
+  oclalgo::future<shared_array<T>> pending{shared_array<T>(), cl::Event()};
+  bool stop = false;
+  int iterations = 0;
+  while (!stop && iterations < max_iterations) {
+    int slot = step();
+    ++iterations;
+    if (iterations % check_every == 0 || iterations == max_iterations) {
+      if (pending.event()())
+        stop = check(pending.get()[0]);
+      if (!stop)
+        pending = ws.ReadAsync(slot);
+    }
+  }
+  if (!stop && pending.event()())
+    check(pending.get()[0]);
+  return iterations;
+}
+
+/*!
+ * @brief Runs iterations of solver and checks residual norm read
+ * asynchronously.
+ *
+ * <i>step</i> enqueues one iteration and returns scalar slot of new r.r.
+ */
+template <typename T, typename Step>
+SolverResult Iterate(const KrylovWorkspace<T>& ws, T rr, T bb,
+                     const SolverOptions& options, Step step) {
+  SolverResult result;
+  double norm_b = bb > 0 ? std::sqrt(static_cast<double>(bb)) : 1.0;
+  auto check = [&](T value) {
+    result.residual = std::sqrt(static_cast<double>(value)) / norm_b;
+    result.converged = result.residual <= options.tolerance;
+    // NaN residual stops solver as not converged
+    return result.converged || result.residual != result.residual;
+  };
+  if (check(rr)) return result;
+  result.iterations = IterateLagged(ws, options.max_iterations,
+                                    options.check_every, step, check);
+  return result;
+}
+
+}  // namespace internal
+
+template <typename T>
+CsrOperator<T> CsrOperator<T>::FromHost(const std::vector<int>& row_ptr,
+                                        const std::vector<int>& col_idx,
+                                        const std::vector<T>& values) {
+  assert(row_ptr.size() > 1 && !values.empty() &&
+         col_idx.size() == values.size());
+  return CsrOperator(static_cast<int>(row_ptr.size()) - 1,
+                     internal::Upload(row_ptr), internal::Upload(col_idx),
+                     internal::Upload(values));
+}
+
+template <typename T>
+SolverResult ConjugateGradient(const LinearOperator<T>& a,
+                               const DMatrix<T>& b, DMatrix<T>* x,
+                               const SolverOptions& options) {
+  static_assert(std::is_floating_point<T>::value,
+                "solvers require floating point matrices");
+  // scalar slots (see solvers.cl): r.r (ping-pong), p.q, b.b
+  enum { kPq = 2, kBb = 3 };
+  int n = a.size();
+  assert(b.rows() == n && b.cols() == 1 && x->rows() == n && x->cols() == 1);
+  internal::KrylovWorkspace<T> ws(n);
+  cl::Buffer r = ws.Allocate(n), p = ws.Allocate(n), q = ws.Allocate(n);
+  ws.Residual(a, b.buffer(), x->buffer(), r, p, 0, kBb);
+  shared_array<T> init = ws.ReadAll();
+
+  int rr_slot = 0;
+  return internal::Iterate(ws, init[0], init[kBb], options, [&]() {
+    a.Apply(p, q);
+    ws.Dot(p, q, kPq);
+    ws.Run("cg_update", ws.partial_grid(), x->buffer(), r, p, q,
+           ws.scalars(), ws.partials(), rr_slot, n);
+    ws.Reduce(1 - rr_slot, -1);
+    ws.Run("cg_direction", ws.vector_grid(), p, r, ws.scalars(), rr_slot, n);
+    rr_slot = 1 - rr_slot;
+    return rr_slot;
+  });
+}
+
+template <typename T>
+SolverResult BiCgStab(const LinearOperator<T>& a, const DMatrix<T>& b,
+                      DMatrix<T>* x, const SolverOptions& options) {
+  static_assert(std::is_floating_point<T>::value,
+                "solvers require floating point matrices");
+  // scalar slots (see solvers.cl): rho (ping-pong), r0.v, t.s, t.t, r.r, b.b
+  enum { kR0v = 2, kTs = 3, kTt = 4, kRr = 5, kBb = 6 };
+  int n = a.size();
+  assert(b.rows() == n && b.cols() == 1 && x->rows() == n && x->cols() == 1);
+  internal::KrylovWorkspace<T> ws(n);
+  cl::Buffer r = ws.Allocate(n), r0 = ws.Allocate(n), p = ws.Allocate(n);
+  cl::Buffer v = ws.Allocate(n), s = ws.Allocate(n), t = ws.Allocate(n);
+  // rho = r0.r = r.r for r0 = r
+  ws.Residual(a, b.buffer(), x->buffer(), r, p, 0, kBb);
+  MatrixQueue::instance()->queue().enqueueCopyBuffer(r, r0, 0, 0,
+                                                     n * sizeof(T));
+  shared_array<T> init = ws.ReadAll();
+
+  int rho_slot = 0;
+  return internal::Iterate(ws, init[0], init[kBb], options, [&]() {
+    a.Apply(p, v);
+    ws.Dot(r0, v, kR0v);
+    ws.Run("bicgstab_s", ws.vector_grid(), r, v, s, ws.scalars(), rho_slot,
+           n);
+    a.Apply(s, t);
+    ws.Dot2(t, s, t, t, kTs, kTt);
+    ws.Run("bicgstab_update", ws.partial_grid(), x->buffer(), r, r0, p, s, t,
+           ws.scalars(), ws.partials(), rho_slot, n);
+    ws.Reduce(1 - rho_slot, kRr);
+    ws.Run("bicgstab_direction", ws.vector_grid(), p, r, v, ws.scalars(),
+           rho_slot, n);
+    rho_slot = 1 - rho_slot;
+    return static_cast<int>(kRr);
+  });
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_SOLVERS_H_
@@ -0,0 +1,118 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+// hack for highlighting syntax in OpenCL *.cl files without errors
+#ifndef __OPENCL_VERSION__
+#define __kernel
+#define __global
+#define __local
+#endif  // __OPENCL_VERSION__
+
+// Sparse matrix-vector products y = A x of CSR matrix (row_ptr has rows + 1
+// elements). Every row is processed by LANES work-items (ROWS_PER_GROUP =
+// GROUP_SIZE / LANES rows per work-group), partial sums of lanes are
+// combined in local memory. GROUP_SIZE and LANES are powers of two.
+
+#ifndef VAR_TYPE
+#define VAR_TYPE float
+#endif  // VAR_TYPE
+
+#ifndef GROUP_SIZE
+#define GROUP_SIZE 256
+#endif  // GROUP_SIZE
+
+#ifndef LANES
+#define LANES 32
+#endif  // LANES
+
+#define ROWS_PER_GROUP (GROUP_SIZE / LANES)
+
+// Sums lane values of row i in local memory and stores the sum to y[i].
+inline void store_row(__local VAR_TYPE *partial, VAR_TYPE sum,
+                      __global VAR_TYPE *y, int i, int rows) {
+  int lid = get_local_id(0);
+  int lane = lid % LANES;
+  partial[lid] = sum;
+  barrier(CLK_LOCAL_MEM_FENCE);
+  for (int s = LANES / 2; s > 0; s >>= 1) {
+    if (lane < s)
+      partial[lid] += partial[lid + s];
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+  if (lane == 0 && i < rows)
+    y[i] = partial[lid];
+  barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void csr_mv(__global const int *row_ptr, __global const int *col_idx,
+            __global const VAR_TYPE *values, __global const VAR_TYPE *x,
+            __global VAR_TYPE *y, const int rows) {
+  __local VAR_TYPE partial[GROUP_SIZE];
+  int lane = get_local_id(0) % LANES;
+  for (int r = get_group_id(0) * ROWS_PER_GROUP; r < rows;
+       r += get_num_groups(0) * ROWS_PER_GROUP) {
+    int i = r + get_local_id(0) / LANES;
+    VAR_TYPE sum = 0;
+    if (i < rows) {
+      for (int e = row_ptr[i] + lane; e < row_ptr[i + 1]; e += LANES)
+        sum += values[e] * x[col_idx[e]];
+    }
+    store_row(partial, sum, y, i, rows);
+  }
+}
+
+// Product of pattern of CSR matrix (all nonzero values are 1), e.g.
+// adjacency matrix of graph.
+__kernel __attribute__((reqd_work_group_size(GROUP_SIZE, 1, 1)))
+void csr_pattern_mv(__global const int *row_ptr, __global const int *col_idx,
+                    __global const VAR_TYPE *x, __global VAR_TYPE *y,
+                    const int rows) {
+  __local VAR_TYPE partial[GROUP_SIZE];
+  int lane = get_local_id(0) % LANES;
+  for (int r = get_group_id(0) * ROWS_PER_GROUP; r < rows;
+       r += get_num_groups(0) * ROWS_PER_GROUP) {
+    int i = r + get_local_id(0) / LANES;
+    VAR_TYPE sum = 0;
+    if (i < rows) {
+      for (int e = row_ptr[i] + lane; e < row_ptr[i + 1]; e += LANES)
+        sum += x[col_idx[e]];
+    }
+    store_row(partial, sum, y, i, rows);
+  }
+}
+
+#undef ROWS_PER_GROUP
+#undef LANES
+#undef GROUP_SIZE
+#undef VAR_TYPE
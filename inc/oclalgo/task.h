@@ -36,6 +36,11 @@
  *  @author Senin Dmitry <d.senin@samsung.com>
  *  @version 1.0
  *
+ *  @section Notes
+ *  Kinds of kernel arguments and the number of possible outputs are resolved
+ *  at compile time (see ArgTraits), so task construction doesn't allocate
+ *  memory.
+ *
  *  @section Copyright
  *  Copyright 2013 Samsung R&D Institute Russia
  */
@@ -46,7 +51,9 @@
 #define __CL_ENABLE_EXCEPTIONS
 #include <CL/cl.hpp>
 
+#include <array>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <oclalgo/kernel_arg.h>
@@ -56,48 +63,189 @@ namespace oclalgo {
 /*!
  * @brief Class to represent individual OpenCL task.
  *
- * Parses input and output OpenCL kernel arguments.
+ * Sets OpenCL kernel arguments and stores output buffers (arguments marked
+ * as OUT or IN_OUT).
  */
 class Task {
+  friend class TaskResult;
+
  public:
+  /** @brief Maximum number of buffer arguments which can be outputs. */
+  constexpr static size_t max_outputs = 8;
+
+  /*!
+   * @brief Creates task and sets kernel arguments in the same order as
+   * in OpenCL kernel.
+   *
+   * Arguments are BufferArg, SvmArg, LocalArg, KernelArg of scalar or scalars
+   * (POD types except pointers).
+   */
   template <typename... Args>
   Task(const cl::Kernel& kernel, const Args&... args)
-      : kernel_(kernel) {
-    SetArg(0, args...);
+      : kernel_(kernel),
+        outputs_(0) {
+    static_assert(OutputCapacity<Args...>::value <= max_outputs,
+                  "too many buffer arguments (see Task::max_outputs)");
+    SetArgs<0>(args...);
+  }
+
+  /*!
+   * @brief Creates task after compile-time check of arguments against kernel
+   * signature.
+   */
+  template <typename... Params, typename... Args>
+  Task(const cl::Kernel& kernel, KernelSignature<Params...>,
+       const Args&... args)
+      : Task(kernel, args...) {
+    static_assert(sizeof...(Params) == sizeof...(Args),
+                  "number of arguments differs from kernel signature");
+    static_assert(SignatureMatches<KernelSignature<Params...>,
+                                   Args...>::value,
+                  "arguments don't match kernel signature");
   }
 
   /** @brief Clears cl::Kernel object and all stored cl::Buffer objects. */
   void clear() noexcept {
     kernel_ = cl::Kernel();
-    output_.clear();
+    for (size_t i = 0; i < outputs_; ++i)
+      output_[i] = cl::Buffer();
+    outputs_ = 0;
   }
 
-  cl::Kernel kernel() const noexcept { return kernel_; }
-  std::vector<cl::Buffer> output() const noexcept { return output_; }
+  const cl::Kernel& kernel() const noexcept { return kernel_; }
+  /** @brief Returns copy of output buffers. */
+  std::vector<cl::Buffer> output() const {
+    return std::vector<cl::Buffer>(output_.begin(),
+                                   output_.begin() + outputs_);
+  }
+  /** @brief Returns array of output buffers (first output_count() are set). */
+  const std::array<cl::Buffer, max_outputs>& outputs() const noexcept {
+    return output_;
+  }
+  /** @brief Returns number of output buffers. */
+  size_t output_count() const noexcept { return outputs_; }
 
  private:
-  void SetArg(int /*index*/) {
+  typedef std::integral_constant<ArgKind, ArgKind::Buffer> BufferKind;
+  typedef std::integral_constant<ArgKind, ArgKind::Svm> SvmKind;
+  typedef std::integral_constant<ArgKind, ArgKind::Local> LocalKind;
+  typedef std::integral_constant<ArgKind, ArgKind::Scalar> ScalarKind;
+
+  template <cl_uint Index>
+  void SetArgs() {
+  }
+
+  template <cl_uint Index, typename First, typename... Tail>
+  void SetArgs(const First& first, const Tail&... tail) {
+    SetArg(Index, first,
+           std::integral_constant<ArgKind, ArgTraits<First>::kind>());
+    SetArgs<Index + 1>(tail...);
   }
 
   template <typename T>
-  void SetArg(int index, const T& arg) {
-    kernel_.setArg(index, arg.data());
-    if (std::is_same<T, BufferArg>::value) {
-      if (arg.arg_type() == ArgType::OUT || arg.arg_type() == ArgType::IN_OUT)
-        output_.push_back(arg.data());
+  void SetArg(cl_uint index, const T& arg, BufferKind) {
+    kernel_.setArg(index, ArgData(arg));
+    if (IsOutputArg(arg))
+      output_[outputs_++] = ArgData(arg);
+  }
+
+  void SetArg(cl_uint index, const SvmArg& arg, SvmKind) {
+#ifdef CL_VERSION_2_0
+    if (arg.data().ptr) {
+      cl_int err = clSetKernelArgSVMPointer(kernel_(), index, arg.data().ptr);
+      if (err != CL_SUCCESS)
+        throw cl::Error(err, "clSetKernelArgSVMPointer");
+      return;
     }
+#endif  // CL_VERSION_2_0
+    kernel_.setArg(index, arg.data().buffer);
+    if (IsOutputArg(arg))
+      output_[outputs_++] = arg.data().buffer;
+  }
+
+  template <typename T>
+  void SetArg(cl_uint index, const T& arg, LocalKind) {
+    kernel_.setArg(index, ArgData(arg));
   }
 
-  template <typename First, typename... Tail>
-  void SetArg(int index, const First& data, const Tail&... args) {
-    SetArg(index, data);
-    SetArg(++index, args...);
+  template <typename T>
+  void SetArg(cl_uint index, const T& arg, ScalarKind) {
+    kernel_.setArg(index, ArgData(arg));
   }
 
   cl::Kernel kernel_;
-  std::vector<cl::Buffer> output_;
+  std::array<cl::Buffer, max_outputs> output_;
+  size_t outputs_;
+};
+
+/*!
+ * @brief Output buffers of enqueued task.
+ *
+ * Buffers are stored inline (no heap allocations), result can only be moved.
+ */
+class TaskResult {
+ public:
+  TaskResult() noexcept : size_(0) {}
+  /** @brief Creates result with copies of task output buffers. */
+  explicit TaskResult(const Task& task);
+  /** @brief Creates result by moving output buffers out of task. */
+  explicit TaskResult(Task&& task);
+
+  TaskResult(const TaskResult&) = delete;
+  TaskResult& operator=(const TaskResult&) = delete;
+
+  TaskResult(TaskResult&& result);
+  TaskResult& operator=(TaskResult&& result);
+
+  /** @brief Returns output buffer number i (in order of task arguments). */
+  const cl::Buffer& operator[](size_t i) const noexcept { return buffers_[i]; }
+  cl::Buffer& operator[](size_t i) noexcept { return buffers_[i]; }
+
+  /** @brief Returns number of output buffers. */
+  size_t size() const noexcept { return size_; }
+  /** @brief Returns true if task has no output buffers. */
+  bool empty() const noexcept { return size_ == 0; }
+
+  const cl::Buffer* begin() const noexcept { return buffers_.data(); }
+  const cl::Buffer* end() const noexcept { return buffers_.data() + size_; }
+
+ private:
+  std::array<cl::Buffer, Task::max_outputs> buffers_;
+  size_t size_;
 };
 
+inline TaskResult::TaskResult(const Task& task)
+    : size_(task.outputs_) {
+  for (size_t i = 0; i < size_; ++i)
+    buffers_[i] = task.output_[i];
+}
+
+// buffers are swapped, so moved-from objects don't keep references
+inline TaskResult::TaskResult(Task&& task)
+    : size_(task.outputs_) {
+  for (size_t i = 0; i < size_; ++i)
+    std::swap(buffers_[i], task.output_[i]);
+  task.outputs_ = 0;
+}
+
+inline TaskResult::TaskResult(TaskResult&& result)
+    : size_(result.size_) {
+  for (size_t i = 0; i < size_; ++i)
+    std::swap(buffers_[i], result.buffers_[i]);
+  result.size_ = 0;
+}
+
+inline TaskResult& TaskResult::operator=(TaskResult&& result) {
+  if (this != &result) {
+    TaskResult old(std::move(*this));
+    size_ = result.size_;
+    for (size_t i = 0; i < size_; ++i)
+      std::swap(buffers_[i], result.buffers_[i]);
+    result.size_ = 0;
+  }
+  return *this;
+}
+
 }  // namespace oclalgo
 
 #endif  // INC_OCLALGO_TASK_H_
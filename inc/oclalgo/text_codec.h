@@ -0,0 +1,574 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file text_codec.h
+ *  @brief Contains functions to parse and format matrices in CSV/TSV text.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Text is split into line-aligned chunks (line ends are found by memchr(),
+ *  which is vectorized by libc) and chunks are parsed by threads of the
+ *  library pool. Numbers are parsed without locale by exact fast path
+ *  (mantissa and power of ten both exact in floating point type), other
+ *  numbers fall back to strtod(). Files are streamed by blocks, so text of
+ *  the whole file is never kept in memory.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_TEXT_CODEC_H_
+#define INC_OCLALGO_TEXT_CODEC_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <oclalgo/matrix.h>
+#include <oclalgo/matrix_view.h>
+#include <oclalgo/shared_array.h>
+#include <oclalgo/thread_pool.h>
+
+namespace oclalgo {
+
+/** @brief Format of matrix text. */
+struct TextFormat {
+  /*!
+   * @brief Separator of values in row (',' for CSV, '\\t' for TSV).
+   *
+   * Spaces around values are always skipped by parser.
+   */
+  char delimiter = ',';
+  /*!
+   * @brief Number of significant digits of floating point values written
+   * (0 - enough digits to read the same value back, larger values are
+   * limited by max_digits10 of value type).
+   */
+  int precision = 0;
+};
+
+namespace internal {
+
+/** @brief Size of blocks read from and written to file descriptors. */
+constexpr size_t text_block_size = 16 << 20;
+
+/*!
+ * @brief Parses number by strtod() in C locale (slow path of
+ * ParseNumber()), returns pointer after it or nullptr for malformed number.
+ */
+const char* ParseNumberSlow(const char* first, const char* last,
+                            double* value);
+const char* ParseNumberSlow(const char* first, const char* last,
+                            float* value);
+
+/*!
+ * @brief Formats number by snprintf() in C locale with <i>precision</i>
+ * significant digits to <i>out</i> (32 bytes), returns pointer after it.
+ */
+char* FormatNumberSlow(double value, int precision, char* out);
+
+/** @brief Reads up to <i>size</i> bytes, returns 0 at end of file. */
+size_t ReadBlock(int fd, char* data, size_t size);
+/** @brief Writes all bytes, throws std::system_error on failure. */
+void WriteBlock(int fd, const char* data, size_t size);
+
+/** @brief Powers of ten which are exact in double. */
+constexpr double exact_powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                   1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+                                   1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+                                   1e22};
+constexpr int max_exact_power = 22;
+/** @brief Integers up to this value are exact in double. */
+constexpr uint64_t max_exact_integer = uint64_t(1) << 53;
+
+inline bool IsSpace(char c) {
+  return c == ' ' || c == '\r';
+}
+
+/*!
+ * @brief Parses integer at <i>p</i> (before <i>last</i>), returns pointer
+ * after it or nullptr for malformed number.
+ */
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, const char*>::type
+ParseNumber(const char* p, const char* last, T* value) {
+  bool negative = false;
+  if (p < last && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  if (p == last || static_cast<unsigned>(*p - '0') > 9) return nullptr;
+  if (negative && !std::is_signed<T>::value) return nullptr;
+  typedef typename std::make_unsigned<T>::type U;
+  U limit = static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+  U result = 0;
+  for (; p < last && static_cast<unsigned>(*p - '0') <= 9; ++p) {
+    U digit = static_cast<U>(*p - '0');
+    if (result > (limit - digit) / 10) return nullptr;
+    result = static_cast<U>(result * 10 + digit);
+  }
+  *value = negative ? static_cast<T>(0 - result) : static_cast<T>(result);
+  return p;
+}
+
+/*!
+ * @brief Checks that rounding of correctly rounded double to T gives
+ * correctly rounded T.
+ *
+ * Double rounding to float is wrong only for doubles exactly halfway
+ * between two floats (the values here are far from float subnormals).
+ */
+inline bool RoundsExactly(double /*value*/, double* /*type*/) {
+  return true;
+}
+
+inline bool RoundsExactly(double value, float* /*type*/) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const int dropped = std::numeric_limits<double>::digits -
+                      std::numeric_limits<float>::digits;
+  const uint64_t mask = (uint64_t(1) << dropped) - 1;
+  return (bits & mask) != (uint64_t(1) << (dropped - 1));
+}
+
+/*!
+ * @brief Parses floating point number at <i>p</i> (before <i>last</i>),
+ * returns pointer after it or nullptr for malformed number.
+ *
+ * Decimal numbers with mantissa and power of ten exactly representable in
+ * double are computed by one multiplication or division, which is correctly
+ * rounded; other numbers (and inf, nan) are parsed by strtod().
+ */
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, const char*>::type
+ParseNumber(const char* p, const char* last, T* value) {
+  const char* first = p;
+  bool negative = false;
+  if (p < last && (*p == '-' || *p == '+')) negative = *p++ == '-';
+  uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  bool exact = true;
+  for (; p < last && static_cast<unsigned>(*p - '0') <= 9; ++p, ++digits)
+    if (digits < 19) mantissa = mantissa * 10 + (*p - '0'); else exact = false;
+  if (p < last && *p == '.') {
+    ++p;
+    for (; p < last && static_cast<unsigned>(*p - '0') <= 9; ++p, ++digits) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        --exponent;
+      } else {
+        exact = false;
+      }
+    }
+  }
+  if (digits == 0)  // inf, nan or malformed
+    return ParseNumberSlow(first, last, value);
+  if (p < last && (*p == 'e' || *p == 'E')) {
+    int e = 0;
+    p = ParseNumber(p + 1, last, &e);
+    if (p == nullptr || e > 100000 || e < -100000)
+      return ParseNumberSlow(first, last, value);
+    exponent += e;
+  }
+  if (!exact || mantissa > max_exact_integer || exponent > max_exact_power ||
+      exponent < -max_exact_power)
+    return ParseNumberSlow(first, last, value) == p ? p : nullptr;
+  double result = static_cast<double>(mantissa);
+  result = exponent < 0 ? result / exact_powers[-exponent] :
+                          result * exact_powers[exponent];
+  if (!RoundsExactly(result, value))
+    return ParseNumberSlow(first, last, value) == p ? p : nullptr;
+  *value = static_cast<T>(negative ? -result : result);
+  return p;
+}
+
+/*!
+ * @brief Parses lines [first, last) of text (every line ends with '\\n')
+ * and appends values to <i>values</i>.
+ *
+ * <i>cols</i> is number of values in line (if it's zero, it's taken from
+ * the first line). Returns number of parsed rows; empty lines are skipped.
+ * Throws std::runtime_error with line number (counted from
+ * <i>first_line</i>) for malformed text.
+ */
+template <typename T>
+size_t ParseLines(const char* first, const char* last, char delimiter,
+                  size_t first_line, int* cols, std::vector<T>* values) {
+  size_t rows = 0, line = first_line;
+  for (const char* p = first; p < last; ++line) {
+    const char* eol = static_cast<const char*>(
+        std::memchr(p, '\n', last - p));
+    if (eol == nullptr) eol = last;
+    int count = 0;
+    const char* q = p;
+    while (q < eol && IsSpace(*q)) ++q;
+    if (q == eol) {
+      p = eol + 1;
+      continue;
+    }
+    for (;;) {
+      while (q < eol && IsSpace(*q)) ++q;
+      T value;
+      const char* end = ParseNumber(q, eol, &value);
+      if (end == nullptr)
+        throw std::runtime_error("bad number at line " +
+                                 std::to_string(line + 1));
+      values->push_back(value);
+      ++count;
+      q = end;
+      while (q < eol && IsSpace(*q)) ++q;
+      if (q == eol) break;
+      if (*q != delimiter && delimiter != ' ')
+        throw std::runtime_error("unexpected character at line " +
+                                 std::to_string(line + 1));
+      if (*q == delimiter) ++q;
+    }
+    if (*cols == 0) *cols = count;
+    if (count != *cols)
+      throw std::runtime_error("line " + std::to_string(line + 1) + " has " +
+                               std::to_string(count) + " values instead of " +
+                               std::to_string(*cols));
+    ++rows;
+    p = eol + 1;
+  }
+  return rows;
+}
+
+/** @brief Parsed rows of matrix text. */
+template <typename T>
+struct TextRows {
+  std::shared_ptr<std::vector<T>> values =
+      std::make_shared<std::vector<T>>();
+  size_t rows = 0;
+  size_t lines = 0;
+  int cols = 0;
+};
+
+/*!
+ * @brief Parses complete lines [first, last) in parallel and appends them
+ * to <i>rows</i>.
+ */
+template <typename T>
+void ParseBlock(const char* first, const char* last, char delimiter,
+                TextRows<T>* rows) {
+  ThreadPool* pool = ThreadPool::instance();
+  size_t size = last - first;
+  size_t parts = size < (1 << 20) ? 1 : pool->size();
+  // line-aligned part boundaries
+  std::vector<const char*> bounds(parts + 1, last);
+  bounds[0] = first;
+  for (size_t k = 1; k < parts; ++k) {
+    const char* p = std::max(bounds[k - 1], first + size * k / parts);
+    const char* eol = static_cast<const char*>(
+        std::memchr(p, '\n', last - p));
+    bounds[k] = eol ? eol + 1 : last;
+  }
+  // lines of parts to number lines in error messages
+  std::vector<size_t> lines(parts, 0);
+  pool->ParallelFor(parts, [&](size_t a, size_t b) {
+    for (size_t k = a; k < b; ++k)
+      for (const char* p = bounds[k]; p < bounds[k + 1]; ++lines[k]) {
+        p = static_cast<const char*>(
+            std::memchr(p, '\n', bounds[k + 1] - p));
+        p = p ? p + 1 : bounds[k + 1];
+      }
+  });
+  // columns are taken from the first non-empty line of text
+  std::vector<T> head;
+  size_t line = rows->lines;
+  for (const char* p = first; rows->cols == 0 && p < last; ++line) {
+    const char* eol = static_cast<const char*>(
+        std::memchr(p, '\n', last - p));
+    eol = eol ? eol + 1 : last;
+    ParseLines(p, eol, delimiter, line, &rows->cols, &head);
+    p = eol;
+  }
+
+  std::vector<std::vector<T>> parsed(parts);
+  std::vector<size_t> parsed_rows(parts);
+  pool->ParallelFor(parts, [&](size_t a, size_t b) {
+    for (size_t k = a; k < b; ++k) {
+      size_t line = rows->lines;
+      for (size_t i = 0; i < k; ++i) line += lines[i];
+      int cols = rows->cols;
+      parsed[k].reserve(static_cast<size_t>(cols) * lines[k]);
+      parsed_rows[k] = ParseLines(bounds[k], bounds[k + 1], delimiter, line,
+                                  &cols, &parsed[k]);
+    }
+  });
+  for (size_t k = 0; k < parts; ++k) {
+    rows->values->insert(rows->values->end(), parsed[k].begin(),
+                         parsed[k].end());
+    rows->rows += parsed_rows[k];
+    rows->lines += lines[k];
+  }
+}
+
+/** @brief Wraps parsed values into matrix without copying. */
+template <typename T>
+Matrix<T> RowsToMatrix(const TextRows<T>& rows) {
+  if (rows.rows > static_cast<size_t>(std::numeric_limits<int>::max()))
+    throw std::runtime_error("too many rows");
+  // matrix shares storage of parsed values
+  std::shared_ptr<T> data(rows.values, rows.values->data());
+  return Matrix<T>(static_cast<int>(rows.rows), rows.cols,
+                   shared_array<T>(data, rows.values->size()));
+}
+
+/** @brief Formats integer to <i>out</i>, returns pointer after it. */
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, char*>::type
+FormatNumber(T value, int /*precision*/, char* out) {
+  typedef typename std::make_unsigned<T>::type U;
+  U magnitude = static_cast<U>(value);
+  if (value < 0) {
+    *out++ = '-';
+    magnitude = static_cast<U>(0 - magnitude);
+  }
+  char digits[24];
+  int n = 0;
+  do {
+    digits[n++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  while (n > 0) *out++ = digits[--n];
+  return out;
+}
+
+/*!
+ * @brief Formats floating point number as decimal with the fewest digits
+ * that is parsed back to the same value.
+ *
+ * Candidates are checked by exact arithmetic of ParseNumber(), so only
+ * numbers in [1e-4, 1e15) with short enough decimal are handled here.
+ * Returns nullptr if the number wasn't formatted.
+ */
+template <typename T>
+char* FormatShortest(T value, char* out) {
+  double magnitude = std::fabs(static_cast<double>(value));
+  if (!(magnitude >= 1e-4 && magnitude < 1e15)) return nullptr;
+  for (int decimals = 0; decimals <= max_exact_power; ++decimals) {
+    double scaled = magnitude * exact_powers[decimals];
+    if (scaled >= static_cast<double>(max_exact_integer)) return nullptr;
+    uint64_t mantissa = static_cast<uint64_t>(scaled + 0.5);
+    double parsed = mantissa / exact_powers[decimals];
+    T* type = nullptr;
+    if (static_cast<T>(parsed) != static_cast<T>(magnitude) ||
+        !RoundsExactly(parsed, type))
+      continue;
+    char digits[24];
+    char* end = FormatNumber(mantissa, 0, digits);
+    int size = static_cast<int>(end - digits);
+    if (value < 0) *out++ = '-';
+    if (size <= decimals) {
+      *out++ = '0';
+      *out++ = '.';
+      for (int i = size; i < decimals; ++i) *out++ = '0';
+      return std::copy(digits, end, out);
+    }
+    out = std::copy(digits, end - decimals, out);
+    if (decimals == 0) return out;
+    *out++ = '.';
+    return std::copy(end - decimals, end, out);
+  }
+  return nullptr;
+}
+
+/*!
+ * @brief Formats floating point number to <i>out</i> (32 bytes).
+ *
+ * Zero <i>precision</i> means the shortest text parsed back to the same
+ * value.
+ */
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, char*>::type
+FormatNumber(T value, int precision, char* out) {
+  if (precision <= 0) {
+    if (value == 0) {
+      if (std::signbit(value)) *out++ = '-';
+      *out++ = '0';
+      return out;
+    }
+    char* end = FormatShortest(value, out);
+    if (end != nullptr) return end;
+  }
+  // more digits don't change parsed value (and text fits in 32 bytes)
+  if (precision <= 0 || precision > std::numeric_limits<T>::max_digits10)
+    precision = std::numeric_limits<T>::max_digits10;
+  return FormatNumberSlow(static_cast<double>(value), precision, out);
+}
+
+/*!
+ * @brief Formats rows [first, last) of matrix and appends them to
+ * <i>out</i>.
+ */
+template <typename T>
+void FormatRows(const MatrixSpan<const T>& m, int first, int last,
+                const TextFormat& format, std::string* out) {
+  char buff[32];
+  for (int i = first; i < last; ++i) {
+    for (int j = 0; j < m.cols(); ++j) {
+      char* end = FormatNumber(m(i, j), format.precision, buff);
+      out->append(buff, end);
+      out->push_back(j + 1 < m.cols() ? format.delimiter : '\n');
+    }
+  }
+}
+
+/*!
+ * @brief Formats rows of matrix by blocks of about text_block_size bytes
+ * in parallel and passes text of every block to <i>sink</i>.
+ */
+template <typename T, typename Sink>
+void FormatBlocks(const MatrixSpan<const T>& m, const TextFormat& format,
+                  Sink sink) {
+  ThreadPool* pool = ThreadPool::instance();
+  size_t parts = pool->size();
+  // 12 bytes per value is a typical width
+  int block_rows = static_cast<int>(std::max<size_t>(
+      1, text_block_size / (12 * std::max(m.cols(), 1))));
+  std::vector<std::string> text(parts);
+  for (int first = 0; first < m.rows(); first += block_rows) {
+    int rows = std::min(block_rows, m.rows() - first);
+    size_t used = std::min<size_t>(parts, rows);
+    pool->ParallelFor(used, [&](size_t a, size_t b) {
+      for (size_t k = a; k < b; ++k) {
+        text[k].clear();
+        FormatRows(m, first + static_cast<int>(rows * k / used),
+                   first + static_cast<int>(rows * (k + 1) / used), format,
+                   &text[k]);
+      }
+    });
+    for (size_t k = 0; k < used; ++k)
+      sink(text[k]);
+  }
+}
+
+}  // namespace internal
+
+/*!
+ * @brief Parses matrix from CSV/TSV text (one row per line).
+ *
+ * Throws std::runtime_error for malformed text or rows of different
+ * lengths.
+ */
+template <typename T>
+Matrix<T> ParseText(const char* data, size_t size,
+                    const TextFormat& format = TextFormat()) {
+  internal::TextRows<T> rows;
+  internal::ParseBlock(data, data + size, format.delimiter, &rows);
+  return internal::RowsToMatrix(rows);
+}
+
+template <typename T>
+Matrix<T> ParseText(const std::string& text,
+                    const TextFormat& format = TextFormat()) {
+  return ParseText<T>(text.data(), text.size(), format);
+}
+
+/*!
+ * @brief Reads matrix text from file descriptor up to end of file.
+ *
+ * Text is read and parsed by blocks (see internal::text_block_size).
+ */
+template <typename T>
+Matrix<T> ReadText(int fd, const TextFormat& format = TextFormat()) {
+  internal::TextRows<T> rows;
+  std::vector<char> block(internal::text_block_size);
+  size_t used = 0;
+  for (;;) {
+    size_t n = internal::ReadBlock(fd, block.data() + used,
+                                   block.size() - used);
+    used += n;
+    if (n == 0) {
+      internal::ParseBlock(block.data(), block.data() + used,
+                           format.delimiter, &rows);
+      break;
+    }
+    if (used < block.size()) continue;
+    // complete lines are parsed, the tail is moved to block start
+    const char* data = block.data();
+    const char* tail = data + used;
+    while (tail > data && tail[-1] != '\n') --tail;
+    if (tail == data) {
+      block.resize(block.size() * 2);  // line is longer than block
+      continue;
+    }
+    internal::ParseBlock(data, tail, format.delimiter, &rows);
+    used = data + used - tail;
+    std::memmove(block.data(), tail, used);
+  }
+  return internal::RowsToMatrix(rows);
+}
+
+/** @brief Formats matrix as CSV/TSV text. */
+template <typename T>
+std::string FormatText(const MatrixSpan<const T>& m,
+                       const TextFormat& format = TextFormat()) {
+  std::string text;
+  internal::FormatBlocks(m, format, [&text](const std::string& block) {
+    text += block;
+  });
+  return text;
+}
+
+template <typename T>
+std::string FormatText(const Matrix<T>& m,
+                       const TextFormat& format = TextFormat()) {
+  return FormatText(MatrixSpan<const T>(m.view()), format);
+}
+
+/** @brief Writes matrix text to file descriptor. */
+template <typename T>
+void WriteText(int fd, const MatrixSpan<const T>& m,
+               const TextFormat& format = TextFormat()) {
+  internal::FormatBlocks(m, format, [fd](const std::string& block) {
+    internal::WriteBlock(fd, block.data(), block.size());
+  });
+}
+
+template <typename T>
+void WriteText(int fd, const Matrix<T>& m,
+               const TextFormat& format = TextFormat()) {
+  WriteText(fd, MatrixSpan<const T>(m.view()), format);
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_TEXT_CODEC_H_
@@ -0,0 +1,189 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file thread_pool.h
+ *  @brief Contains oclalgo::ThreadPool class for host parallel operations.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Number of threads of the library pool is taken from OCLALGO_NUM_THREADS
+ *  environment variable (number of hardware threads by default). Threads are
+ *  pinned to CPUs on NUMA systems or if OCLALGO_PIN_THREADS is 1.
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_THREAD_POOL_H_
+#define INC_OCLALGO_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace oclalgo {
+
+/*!
+ * @brief Pool of host threads for data parallel operations.
+ *
+ * ParallelFor() splits index range into contiguous chunks (one per thread).
+ * Chunk k is always run by the same thread, so data first touched by a thread
+ * is processed by it later. Without pinning the calling thread runs chunk 0.
+ * With pinning all chunks are run by pool threads, which are pinned to CPUs
+ * ordered by NUMA nodes (chunk k runs on CPU k * cpus / threads). Nested calls
+ * from pool threads and concurrent calls from other threads are run serially.
+ */
+class ThreadPool {
+ public:
+  /** @brief Creates pool with <i>threads</i> threads (including caller). */
+  explicit ThreadPool(size_t threads, bool pinned = false);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /** @brief Stops and joins pool threads. */
+  virtual ~ThreadPool();
+
+  /** @brief Provides library pool used by host matrix operations. */
+  static ThreadPool* instance();
+
+  /** @brief Returns number of threads (including calling thread). */
+  size_t size() const noexcept { return threads_; }
+
+  /** @brief Changes number of threads (including calling thread). */
+  void resize(size_t threads);
+
+  /** @brief Returns true if pool threads are pinned to CPUs. */
+  bool pinned() const noexcept { return pinned_; }
+
+  /** @brief Enables or disables pinning of pool threads to CPUs. */
+  void SetPinning(bool pinned);
+
+  /*!
+   * @brief Calls f(first, last) for contiguous chunks of [0, count).
+   *
+   * Chunk boundaries are multiples of <i>grain</i> shifted by <i>phase</i>
+   * (see ParallelChunks()). If <i>f</i> throws, the rest of chunks are
+   * still run and the first exception is rethrown to the caller.
+   */
+  template <typename F>
+  void ParallelFor(size_t count, const F& f, size_t grain = 1,
+                   size_t phase = 0);
+
+  /** @brief Size of cache line used to align chunks. */
+  constexpr static size_t cache_line = 64;
+  /** @brief Number of elements below which operations run serially. */
+  constexpr static size_t serial_cutoff = 1 << 16;
+
+ private:
+  void Run(size_t tasks, const std::function<void(size_t)>& job);
+  void Execute(size_t index);
+  void WorkerLoop(size_t index);
+  void Start(size_t threads);
+  void Stop();
+
+  std::vector<std::thread> workers_;
+  size_t threads_;
+  bool pinned_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(size_t)>* job_;
+  size_t tasks_;
+  std::atomic<size_t> pending_;
+  std::exception_ptr error_;  // the first exception of current job
+  size_t busy_;
+  uint64_t generation_;
+  bool stop_;
+};
+
+template <typename F>
+void ThreadPool::ParallelFor(size_t count, const F& f, size_t grain,
+                             size_t phase) {
+  size_t chunks = std::min(size(), (count + grain - 1) / grain);
+  if (chunks <= 1) {
+    if (count > 0) f(0, count);
+    return;
+  }
+  // boundary b is aligned if (b + phase) is a multiple of grain
+  auto bound = [=](size_t k) -> size_t {
+    if (k == 0) return 0;
+    if (k == chunks) return count;
+    size_t b = (k * count / chunks + phase + grain - 1) / grain * grain;
+    b = b > phase ? b - phase : 0;
+    return std::min(b, count);
+  };
+  std::function<void(size_t)> job = [&](size_t k) {
+    size_t first = bound(k), last = bound(k + 1);
+    if (first < last) f(first, last);
+  };
+  Run(chunks, job);
+}
+
+/*!
+ * @brief Calls f(first, last) for chunks of output array <i>out</i> with
+ * <i>size</i> elements using the library pool.
+ *
+ * Chunk boundaries are aligned to cache lines of <i>out</i>, so threads don't
+ * write to the same cache line. Runs serially if size is less than
+ * ThreadPool::serial_cutoff.
+ */
+template <typename T, typename F>
+void ParallelChunks(const T* out, size_t size, const F& f) {
+  ThreadPool* pool = ThreadPool::instance();
+  if (size < ThreadPool::serial_cutoff || pool->size() == 1) {
+    if (size > 0) f(0, size);
+    return;
+  }
+  size_t grain = 1, phase = 0;
+  if (ThreadPool::cache_line % sizeof(T) == 0) {
+    grain = ThreadPool::cache_line / sizeof(T);
+    size_t misalignment = reinterpret_cast<uintptr_t>(out) %
+                          ThreadPool::cache_line;
+    phase = misalignment / sizeof(T);
+  }
+  pool->ParallelFor(size, f, grain, phase);
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_THREAD_POOL_H_
@@ -0,0 +1,287 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file transfer_codec.h
+ *  @brief Contains oclalgo::TransferCodec class (host part of compressed
+ *  transfers).
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Encoded formats are decoded on device by kernels from codec.cl:
+ *  <ul>
+ *  <li>ZeroBitmap: [bitmap of non-zero words, one word per 32 elements]
+ *  [number of non-zero words before each group of 32 elements]
+ *  [non-zero words][one padding word]</li>
+ *  <li>BitPack: [minimum][bit width][(element - minimum) packed with bit
+ *  width into consecutive words][one padding word]</li>
+ *  </ul>
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_TRANSFER_CODEC_H_
+#define INC_OCLALGO_TRANSFER_CODEC_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#include <oclalgo/shared_array.h>
+
+namespace oclalgo {
+
+/** @brief Enum of encoding schemes used by compressed transfers. */
+enum class CodecScheme {
+  Auto,        ///< choose scheme by sample of data
+  Raw,         ///< data isn't encoded
+  ZeroBitmap,  ///< zero words are removed, non-zero words are kept
+  BitPack      ///< frame of reference with bit packing
+};
+
+/*!
+ * @brief Class for encoding and decoding arrays of 32-bit elements (int,
+ * unsigned int, float) on host.
+ *
+ * Loops don't have data dependent branches, so they are vectorized by
+ * compiler. Signed integers are packed relative to signed minimum, other
+ * types are packed as unsigned 32-bit words.
+ */
+template <typename T>
+class TransferCodec {
+  static_assert(sizeof(T) == sizeof(uint32_t),
+                "TransferCodec supports only 32-bit element types");
+
+ public:
+  /** @brief Type of words used for minimum and maximum search. */
+  typedef typename std::conditional<std::is_integral<T>::value &&
+                                    std::is_signed<T>::value,
+                                    int32_t, uint32_t>::type Word;
+
+  /** @brief Number of elements checked by Choose(). */
+  constexpr static size_t sample_size = 4096;
+
+  /*!
+   * @brief Chooses encoding scheme with the smallest estimated size by
+   * sample of data.
+   *
+   * Returns CodecScheme::Raw if encoding doesn't save at least a quarter of
+   * transferred bytes.
+   */
+  static CodecScheme Choose(const T* data, size_t size);
+
+  /** @brief Encodes data with corresponding scheme (except Auto and Raw). */
+  static shared_array<uint32_t> Encode(const T* data, size_t size,
+                                       CodecScheme scheme);
+
+  /*!
+   * @brief Decodes <i>size</i> elements encoded with corresponding scheme
+   * to <i>data</i>.
+   */
+  static void Decode(const uint32_t* encoded, size_t size, CodecScheme scheme,
+                     T* data);
+
+  /** @brief Returns bit width required to pack difference max - min. */
+  static unsigned BitWidth(Word min, Word max) {
+    uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min);
+    unsigned width = 0;
+    while (width < 32 && (range >> width) != 0) ++width;
+    return width;
+  }
+
+  /** @brief Returns number of words in BitPack encoded data. */
+  static size_t PackedSize(size_t size, unsigned width) {
+    return 2 + (static_cast<uint64_t>(size) * width + 31) / 32 + 1;
+  }
+
+  /** @brief Returns number of groups (32 elements) in ZeroBitmap data. */
+  static size_t Groups(size_t size) { return (size + 31) / 32; }
+
+ private:
+  static Word ToWord(const T& value) {
+    Word word;
+    std::memcpy(&word, &value, sizeof(word));
+    return word;
+  }
+
+  static T FromWord(uint32_t word) {
+    T value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+  }
+
+  static shared_array<uint32_t> EncodeZeroBitmap(const T* data, size_t size);
+  static shared_array<uint32_t> EncodeBitPack(const T* data, size_t size);
+};
+
+// definition of constant bound to reference (std::min)
+template <typename T> constexpr size_t TransferCodec<T>::sample_size;
+
+template <typename T>
+CodecScheme TransferCodec<T>::Choose(const T* data, size_t size) {
+  if (size == 0) return CodecScheme::Raw;
+  size_t samples = std::min(size, sample_size);
+  size_t stride = size / samples;
+  size_t zeros = 0;
+  Word min = ToWord(data[0]), max = min;
+  for (size_t i = 0; i < samples; ++i) {
+    Word word = ToWord(data[i * stride]);
+    zeros += word == 0;
+    min = std::min(min, word);
+    max = std::max(max, word);
+  }
+
+  double zero_ratio = static_cast<double>(zeros) / samples;
+  double bitmap_size = 2.0 * Groups(size) + (1.0 - zero_ratio) * size;
+  double packed_size = static_cast<double>(PackedSize(size, BitWidth(min,
+                                                                     max)));
+  double best_size = std::min(bitmap_size, packed_size);
+  if (best_size > 0.75 * size) return CodecScheme::Raw;
+  return bitmap_size < packed_size ? CodecScheme::ZeroBitmap :
+                                     CodecScheme::BitPack;
+}
+
+template <typename T>
+shared_array<uint32_t> TransferCodec<T>::Encode(const T* data, size_t size,
+                                                CodecScheme scheme) {
+  switch (scheme) {
+    case CodecScheme::ZeroBitmap:
+      return EncodeZeroBitmap(data, size);
+    case CodecScheme::BitPack:
+      return EncodeBitPack(data, size);
+    default:
+      throw std::invalid_argument("can't encode data with this scheme");
+  }
+}
+
+template <typename T>
+shared_array<uint32_t> TransferCodec<T>::EncodeZeroBitmap(const T* data,
+                                                          size_t size) {
+  size_t groups = Groups(size);
+  // the first pass counts non-zero words to find size of encoded data
+  shared_array<uint32_t> header(2 * groups);
+  uint32_t* bitmap = header.get_raw();
+  uint32_t* offsets = bitmap + groups;
+  uint32_t nonzeros = 0;
+  for (size_t g = 0; g < groups; ++g) {
+    size_t count = std::min<size_t>(32, size - g * 32);
+    uint32_t bits = 0;
+    for (size_t b = 0; b < count; ++b)
+      bits |= static_cast<uint32_t>(ToWord(data[g * 32 + b]) != 0) << b;
+    bitmap[g] = bits;
+    offsets[g] = nonzeros;
+    nonzeros += __builtin_popcount(bits);
+  }
+
+  // one extra word is written by the branchless compaction loop below
+  shared_array<uint32_t> encoded(2 * groups + nonzeros + 1);
+  std::copy(bitmap, bitmap + 2 * groups, encoded.get_raw());
+  uint32_t* values = encoded.get_raw() + 2 * groups;
+  size_t k = 0;
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t word = static_cast<uint32_t>(ToWord(data[i]));
+    values[k] = word;
+    k += word != 0;
+  }
+  return encoded;
+}
+
+template <typename T>
+shared_array<uint32_t> TransferCodec<T>::EncodeBitPack(const T* data,
+                                                       size_t size) {
+  Word min = std::numeric_limits<Word>::max();
+  Word max = std::numeric_limits<Word>::min();
+  for (size_t i = 0; i < size; ++i) {
+    Word word = ToWord(data[i]);
+    min = std::min(min, word);
+    max = std::max(max, word);
+  }
+  if (size == 0) min = max = 0;
+  unsigned width = BitWidth(min, max);
+
+  shared_array<uint32_t> encoded(PackedSize(size, width));
+  std::fill(encoded.get_raw(), encoded.get_raw() + encoded.size(), 0);
+  encoded[0] = static_cast<uint32_t>(min);
+  encoded[1] = width;
+  if (width == 0) return encoded;
+  uint32_t* packed = encoded.get_raw() + 2;
+  for (size_t i = 0; i < size; ++i) {
+    uint32_t value = static_cast<uint32_t>(ToWord(data[i])) -
+                     static_cast<uint32_t>(min);
+    uint64_t bit = static_cast<uint64_t>(i) * width;
+    size_t word = bit >> 5;
+    unsigned shift = bit & 31;
+    packed[word] |= value << shift;
+    if (shift + width > 32) packed[word + 1] |= value >> (32 - shift);
+  }
+  return encoded;
+}
+
+template <typename T>
+void TransferCodec<T>::Decode(const uint32_t* encoded, size_t size,
+                              CodecScheme scheme, T* data) {
+  if (scheme == CodecScheme::ZeroBitmap) {
+    size_t groups = Groups(size);
+    const uint32_t* bitmap = encoded;
+    const uint32_t* values = encoded + 2 * groups;
+    size_t k = 0;
+    for (size_t i = 0; i < size; ++i) {
+      uint32_t nonzero = (bitmap[i >> 5] >> (i & 31)) & 1;
+      data[i] = FromWord(nonzero ? values[k] : 0);
+      k += nonzero;
+    }
+  } else if (scheme == CodecScheme::BitPack) {
+    uint32_t min = encoded[0];
+    unsigned width = encoded[1];
+    const uint32_t* packed = encoded + 2;
+    uint32_t mask = width == 32 ? ~0U : (1U << width) - 1;
+    for (size_t i = 0; i < size; ++i) {
+      uint64_t bit = static_cast<uint64_t>(i) * width;
+      size_t word = bit >> 5;
+      unsigned shift = bit & 31;
+      uint32_t value = packed[word] >> shift;
+      if (shift + width > 32) value |= packed[word + 1] << (32 - shift);
+      data[i] = FromWord((value & mask) + min);
+    }
+  } else {
+    throw std::invalid_argument("can't decode data with this scheme");
+  }
+}
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_TRANSFER_CODEC_H_
@@ -0,0 +1,190 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file typed_kernel.h
+ *  @brief Contains oclalgo::TypedKernel class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Notes
+ *  Typed kernel is created once by Queue::Kernel() and called like a
+ *  function: program lookup and kernel creation are done only once, every
+ *  call is one setArg() sequence and one clEnqueueNDRangeKernel().
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#ifndef INC_OCLALGO_TYPED_KERNEL_H_
+#define INC_OCLALGO_TYPED_KERNEL_H_
+
+#define __CL_ENABLE_EXCEPTIONS
+#include <CL/cl.hpp>
+
+#include <cstdint>
+#include <utility>
+
+#include <oclalgo/future.h>
+#include <oclalgo/grid.h>
+#include <oclalgo/kernel_arg.h>
+#include <oclalgo/task.h>
+
+namespace oclalgo {
+
+/*!
+ * @brief Enqueues kernel with current arguments to OpenCL queue after
+ * events of wait list.
+ */
+cl::Event EnqueueKernel(const cl::CommandQueue& queue,
+                        const cl::Kernel& kernel, const Grid& grid,
+                        const WaitList& events);
+
+/*!
+ * @brief Checks that kernel parameters correspond to argument kinds and
+ * OpenCL type names of scalars (nullptr if type isn't checked).
+ *
+ * Number of parameters is checked always, kinds and type names only if
+ * kernel argument info is available (OpenCL 1.2 and program built with
+ * "-cl-kernel-arg-info" option on some platforms). Scalars of builtin types
+ * are compared by size and kind (integer or floating point), so int and uint
+ * are interchangeable; typedef'd kernel parameters aren't type checked.
+ * Throws cl::Error(CL_INVALID_KERNEL_ARGS) on mismatch.
+ */
+void CheckKernelArgs(const cl::Kernel& kernel, const ArgKind* kinds,
+                     const char* const* type_names, size_t count);
+
+/*!
+ * @brief OpenCL type name of scalar kernel argument type (nullptr for
+ * structures and unknown types).
+ */
+template <typename T>
+struct ClTypeName {
+  constexpr static const char* value() { return nullptr; }
+};
+
+#define OCLALGO_CL_TYPE_NAME(type, name)                 \
+  template <>                                            \
+  struct ClTypeName<type> {                              \
+    constexpr static const char* value() { return name; } \
+  };
+
+OCLALGO_CL_TYPE_NAME(char, "char")
+OCLALGO_CL_TYPE_NAME(signed char, "char")
+OCLALGO_CL_TYPE_NAME(unsigned char, "uchar")
+OCLALGO_CL_TYPE_NAME(int16_t, "short")
+OCLALGO_CL_TYPE_NAME(uint16_t, "ushort")
+OCLALGO_CL_TYPE_NAME(int32_t, "int")
+OCLALGO_CL_TYPE_NAME(uint32_t, "uint")
+OCLALGO_CL_TYPE_NAME(int64_t, "long")
+OCLALGO_CL_TYPE_NAME(uint64_t, "ulong")
+OCLALGO_CL_TYPE_NAME(float, "float")
+OCLALGO_CL_TYPE_NAME(double, "double")
+
+#undef OCLALGO_CL_TYPE_NAME
+
+/*!
+ * @brief Reusable OpenCL kernel with compile-time signature <i>Params</i>.
+ *
+ * Parameters are BufferArg (or cl::Buffer), SvmArg, LocalArg and scalar
+ * types in the same order as in OpenCL kernel. Arguments of every call are
+ * checked against the signature at compile time.
+ *
+ * Kernel arguments are set on the shared cl::Kernel object, so one typed
+ * kernel mustn't be called from several threads simultaneously (copies
+ * share the kernel too).
+ *
+ * <i>Code example:</i>
+ * @code{.cpp}
+ * auto add = queue.Kernel<BufferArg, int, BufferArg>("vector.cl",
+ *                                                    "vector_add_value");
+ * auto future = add(Grid(cl::NDRange(size)), a_arg, 101, c_arg);
+ * queue.memcpy(c, future.get()[0]);
+ * @endcode
+ */
+template <typename... Params>
+class TypedKernel {
+ public:
+  typedef KernelSignature<Params...> signature;
+
+  TypedKernel() = default;
+
+  /*!
+   * @brief Creates typed kernel for <i>kernel</i> enqueued to
+   * <i>queue</i>.
+   *
+   * @param check_args check signature against kernel argument info
+   * (see CheckKernelArgs())
+   */
+  TypedKernel(const cl::CommandQueue& queue, const cl::Kernel& kernel,
+              bool check_args = true)
+      : queue_(queue),
+        kernel_(kernel) {
+    if (check_args) {
+      const ArgKind kinds[] = { ArgTraits<Params>::kind..., ArgKind::Scalar };
+      const char* const type_names[] = {
+        ClTypeName<typename ArgTraits<Params>::value_type>::value()...,
+        nullptr
+      };
+      CheckKernelArgs(kernel_, kinds, type_names, sizeof...(Params));
+    }
+  }
+
+  /** @brief Sets arguments and enqueues kernel. */
+  template <typename... Args>
+  oclalgo::future<TaskResult> operator()(const Grid& grid,
+                                         const Args&... args) const {
+    Task task = this->task(args...);
+    cl::Event event = EnqueueKernel(queue_, kernel_, grid, WaitList());
+    return oclalgo::future<TaskResult>(TaskResult(std::move(task)), event);
+  }
+
+  /*!
+   * @brief Creates task with checked arguments (to pass it to
+   * Queue::EnqueueTask() with dependencies).
+   */
+  template <typename... Args>
+  Task task(const Args&... args) const {
+    return Task(kernel_, signature(), args...);
+  }
+
+  const cl::Kernel& kernel() const noexcept { return kernel_; }
+  const cl::CommandQueue& queue() const noexcept { return queue_; }
+
+ private:
+  cl::CommandQueue queue_;
+  cl::Kernel kernel_;
+};
+
+}  // namespace oclalgo
+
+#endif  // INC_OCLALGO_TYPED_KERNEL_H_
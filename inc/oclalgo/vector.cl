@@ -43,3 +43,18 @@ __kernel void vector_add(__global const int *A, __global const int *B,
   int i = get_global_id(0);
   C[i] = A[i] + B[i];
 }
+
+__kernel void vector_add_value(__global const int *A, const int value,
+                               __global int *C) {
+  int i = get_global_id(0);
+  C[i] = A[i] + value;
+}
+
+typedef int value_t;
+
+// argument info reports "value_t" as type name of typedef'd parameter
+__kernel void vector_sub_value(__global const int *A, const value_t value,
+                               __global int *C) {
+  int i = get_global_id(0);
+  C[i] = A[i] - value;
+}
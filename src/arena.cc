@@ -0,0 +1,128 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file arena.cc
+ *  @brief ScopedArena class implementation.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/arena.h"
+
+#include <algorithm>
+
+namespace oclalgo {
+
+namespace {
+
+thread_local ScopedArena* active_arena = nullptr;
+
+// the largest block of the last destroyed arena is kept for the next one,
+// so its pages don't have to be mapped and faulted again
+thread_local std::unique_ptr<char[]> spare_block;
+thread_local size_t spare_size = 0;
+
+}  // namespace
+
+ScopedArena::ScopedArena(size_t block_size)
+    : previous_(active_arena),
+      block_size_(std::max<size_t>(block_size, 64)),
+      current_(0),
+      offset_(0),
+      used_(0),
+      reserved_(0),
+      live_(0) {
+  if (spare_block && spare_size >= block_size_) {
+    blocks_.push_back(Block{std::move(spare_block), spare_size});
+    reserved_ = spare_size;
+    spare_size = 0;
+  }
+  active_arena = this;
+}
+
+ScopedArena::~ScopedArena() {
+  assert(live_ == 0 && "arrays allocated from arena outlive it");
+  assert(active_arena == this && "arenas should be destroyed in LIFO order");
+  active_arena = previous_;
+  if (!blocks_.empty() && blocks_.back().size > spare_size) {
+    spare_block = std::move(blocks_.back().data);
+    spare_size = blocks_.back().size;
+  }
+}
+
+ScopedArena* ScopedArena::active() noexcept {
+  return active_arena;
+}
+
+void* ScopedArena::Allocate(size_t bytes, size_t align) {
+  for (;;) {
+    if (current_ < blocks_.size()) {
+      Block& block = blocks_[current_];
+      uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+      size_t aligned = (base + offset_ + align - 1) / align * align - base;
+      if (aligned + bytes <= block.size) {
+        offset_ = aligned + bytes;
+        used_ += bytes;
+        return block.data.get() + aligned;
+      }
+      // blocks kept after Reset() are reused before new ones are added
+      if (current_ + 1 < blocks_.size()) {
+        ++current_;
+        offset_ = 0;
+        continue;
+      }
+    }
+    AddBlock(bytes + align);
+  }
+}
+
+void ScopedArena::Reset() noexcept {
+  current_ = 0;
+  offset_ = 0;
+  used_ = 0;
+}
+
+void ScopedArena::AddBlock(size_t min_size) {
+  // every new block is twice larger than the previous one
+  size_t size = blocks_.empty() ? block_size_ : 2 * blocks_.back().size;
+  size = std::max(size, min_size);
+  blocks_.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+  reserved_ += size;
+  current_ = blocks_.size() - 1;
+  offset_ = 0;
+}
+
+}  // namespace oclalgo
@@ -0,0 +1,196 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file cost_model.cc
+ *  @brief Implementation of oclalgo::CostModel class and profile files.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/cost_model.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace oclalgo {
+
+namespace {
+
+const char* const operation_names[operation_kinds] = {"multiply",
+                                                       "elementwise"};
+
+/** @brief Moves average towards observed value. */
+void Smooth(double observed, double weight, double* average) {
+  *average += weight * (observed - *average);
+}
+
+}  // namespace
+
+bool LoadProfile(const std::string& path, DeviceProfile* profile) {
+  std::ifstream in(path);
+  if (!in) return false;
+  DeviceProfile result;
+  int fields = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields_in(line);
+    std::string key;
+    fields_in >> key;
+    if (key == "device") {
+      std::getline(fields_in >> std::ws, result.device);
+      ++fields;
+      continue;
+    }
+    double value = 0;
+    if (!(fields_in >> value) || !(value > 0)) return false;
+    if (key == "upload_bandwidth") {
+      result.upload_bandwidth = value;
+    } else if (key == "download_bandwidth") {
+      result.download_bandwidth = value;
+    } else if (key == "launch_latency") {
+      result.launch_latency = value;
+    } else {
+      bool known = false;
+      for (int op = 0; op < operation_kinds; ++op) {
+        if (key == std::string("device_") + operation_names[op]) {
+          result.device_rate[op] = value;
+          known = true;
+        } else if (key == std::string("host_") + operation_names[op]) {
+          result.host_rate[op] = value;
+          known = true;
+        }
+      }
+      if (!known) continue;  // written by newer version
+    }
+    ++fields;
+  }
+  if (fields != 4 + 2 * operation_kinds) return false;
+  *profile = result;
+  return true;
+}
+
+bool SaveProfile(const std::string& path, const DeviceProfile& profile) {
+  if (path.empty()) return false;
+  // written to temporary file and renamed, so readers never see a part
+  std::string temp = path + ".tmp";
+  {
+    std::ofstream out(temp);
+    out.precision(17);
+    out << "device " << profile.device << "\n"
+        << "upload_bandwidth " << profile.upload_bandwidth << "\n"
+        << "download_bandwidth " << profile.download_bandwidth << "\n"
+        << "launch_latency " << profile.launch_latency << "\n";
+    for (int op = 0; op < operation_kinds; ++op) {
+      out << "device_" << operation_names[op] << " "
+          << profile.device_rate[op] << "\n"
+          << "host_" << operation_names[op] << " "
+          << profile.host_rate[op] << "\n";
+    }
+    if (!out.flush()) return false;
+  }
+  return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+std::string DefaultProfilePath() {
+  const char* env = std::getenv("OCLALGO_PROFILE");
+  if (env != nullptr) return env;
+  const char* home = std::getenv("HOME");
+  if (home != nullptr) return std::string(home) + "/.oclalgo_profile";
+  return std::string();
+}
+
+CostModel::CostModel(const DeviceProfile& profile, double smoothing)
+    : profile_(profile), smoothing_(smoothing) {
+}
+
+double CostModel::Predict(Target target, Operation op,
+                          const OperationCost& cost) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return PredictLocked(target, op, cost);
+}
+
+Target CostModel::Choose(Operation op, const OperationCost& cost) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return PredictLocked(Target::Device, op, cost) <
+         PredictLocked(Target::Host, op, cost) ? Target::Device :
+                                                 Target::Host;
+}
+
+void CostModel::Record(Target target, Operation op,
+                       const OperationCost& cost, double seconds) {
+  if (!(seconds > 0) || !(cost.work > 0)) return;
+  int kind = static_cast<int>(op);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (target == Target::Host) {
+    Smooth(cost.work / seconds, smoothing_, &profile_.host_rate[kind]);
+    return;
+  }
+  double overhead = profile_.launch_latency + Transfer(cost);
+  double kernel = cost.work / profile_.device_rate[kind];
+  if (kernel >= overhead) {
+    // the rest of time is spent by kernel
+    double observed = seconds - overhead;
+    if (observed > 0)
+      Smooth(cost.work / observed, smoothing_, &profile_.device_rate[kind]);
+  } else {
+    double observed = seconds - Transfer(cost) - kernel;
+    if (observed > 0)
+      Smooth(observed, smoothing_, &profile_.launch_latency);
+  }
+}
+
+DeviceProfile CostModel::profile() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return profile_;
+}
+
+double CostModel::PredictLocked(Target target, Operation op,
+                                const OperationCost& cost) const {
+  int kind = static_cast<int>(op);
+  if (target == Target::Host)
+    return cost.work / profile_.host_rate[kind];
+  return profile_.launch_latency + Transfer(cost) +
+         cost.work / profile_.device_rate[kind];
+}
+
+double CostModel::Transfer(const OperationCost& cost) const {
+  return cost.bytes_in / profile_.upload_bandwidth +
+         cost.bytes_out / profile_.download_bandwidth;
+}
+
+}  // namespace oclalgo
@@ -0,0 +1,327 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file file_loader.cc
+ *  @brief FileLoader class implementation.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/file_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oclalgo {
+
+namespace internal {
+
+/** @brief State of one load shared by loader threads and FileLoad. */
+struct LoadState {
+  LoadState() : fd(-1), uploaded(0), remaining(0), failed(false) {}
+  ~LoadState() { if (fd >= 0) close(fd); }
+
+  // sets status of chunk event (and of the whole load after the last chunk)
+  void Finish(int chunk, size_t bytes, bool ok) {
+    if (ok) {
+      uploaded += bytes;
+    } else {
+      failed = true;
+    }
+    chunk_events[chunk].setStatus(ok ? CL_COMPLETE : -1);
+    if (--remaining == 0)
+      done.setStatus(failed ? -1 : CL_COMPLETE);
+  }
+
+  void SetError(const std::string& message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (error.empty()) error = message;
+  }
+
+  int fd;
+  size_t size;
+  size_t file_offset;
+  size_t buffer_offset;
+  size_t chunk_size;
+  cl::Buffer buffer;
+  std::vector<cl::UserEvent> chunk_events;
+  cl::UserEvent done;
+  std::atomic<size_t> uploaded;
+  std::atomic<int> remaining;
+  std::atomic<bool> failed;
+  std::mutex mutex;
+  std::string error;
+};
+
+}  // namespace internal
+
+namespace {
+
+struct Upload {
+  std::shared_ptr<internal::LoadState> state;
+  int chunk;
+  size_t bytes;
+};
+
+void CL_CALLBACK OnUploaded(cl_event /*event*/, cl_int status,
+                            void* user_data) {
+  Upload* upload = static_cast<Upload*>(user_data);
+  if (status != CL_COMPLETE)
+    upload->state->SetError("upload of chunk failed");
+  upload->state->Finish(upload->chunk, upload->bytes, status == CL_COMPLETE);
+  delete upload;
+}
+
+// reads <size> bytes at <offset> (pread can return less than requested)
+bool ReadFully(int fd, char* ptr, size_t size, size_t offset,
+               std::string* error) {
+  while (size > 0) {
+    ssize_t n = pread(fd, ptr, size, static_cast<off_t>(offset));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      *error = n < 0 ? std::strerror(errno) : "unexpected end of file";
+      return false;
+    }
+    ptr += n;
+    size -= n;
+    offset += n;
+  }
+  return true;
+}
+
+}  // namespace
+
+size_t FileLoad::size() const {
+  return state_->size;
+}
+
+size_t FileLoad::uploaded() const {
+  return state_->uploaded;
+}
+
+int FileLoad::chunks() const {
+  return static_cast<int>(state_->chunk_events.size());
+}
+
+size_t FileLoad::chunk_offset(int chunk) const {
+  return state_->buffer_offset + chunk * state_->chunk_size;
+}
+
+oclalgo::future<cl::Buffer> FileLoad::done() const {
+  return oclalgo::future<cl::Buffer>(cl::Buffer(state_->buffer),
+                                     state_->done);
+}
+
+oclalgo::future<cl::Buffer> FileLoad::chunk(int chunk) const {
+  return oclalgo::future<cl::Buffer>(cl::Buffer(state_->buffer),
+                                     state_->chunk_events.at(chunk));
+}
+
+std::string FileLoad::error() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->error;
+}
+
+FileLoader::FileLoader(const Queue* queue, const FileLoaderOptions& options)
+    : queue_(queue),
+      transfer_queue_(queue->context(), queue->device()),
+      options_(options),
+      stop_(false) {
+  options_.chunk_size = std::max<size_t>(options_.chunk_size, 1);
+  options_.threads = std::max(options_.threads, 1);
+  options_.staging_buffers = std::max(options_.staging_buffers,
+                                      options_.threads);
+  for (int i = 0; i < options_.staging_buffers; ++i) {
+    Slot slot;
+    slot.pinned = queue_->CreateBuffer<char>(
+        options_.chunk_size, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR,
+        "FileLoader");
+    slot.ptr = transfer_queue_.enqueueMapBuffer(slot.pinned, CL_TRUE,
+                                                CL_MAP_WRITE, 0,
+                                                options_.chunk_size);
+    slots_.push_back(slot);
+    free_slots_.push_back(i);
+  }
+  for (int i = 0; i < options_.threads; ++i)
+    workers_.emplace_back(&FileLoader::WorkerLoop, this);
+}
+
+FileLoader::~FileLoader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  jobs_ready_.notify_all();
+  for (std::thread& worker : workers_)
+    worker.join();
+  for (Slot& slot : slots_)
+    transfer_queue_.enqueueUnmapMemObject(slot.pinned, slot.ptr);
+  transfer_queue_.finish();
+}
+
+FileLoad FileLoader::Load(const std::string& path, const cl::Buffer& buffer,
+                          size_t size, size_t file_offset,
+                          size_t buffer_offset) {
+  auto state = std::make_shared<internal::LoadState>();
+  state->fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (state->fd < 0)
+    throw std::system_error(errno, std::generic_category(), path);
+  struct stat info;
+  if (fstat(state->fd, &info) != 0)
+    throw std::system_error(errno, std::generic_category(), path);
+  if (static_cast<size_t>(info.st_size) < file_offset + size)
+    throw std::system_error(EINVAL, std::generic_category(),
+                            path + " is too short");
+#ifdef POSIX_FADV_SEQUENTIAL
+  posix_fadvise(state->fd, file_offset, size, POSIX_FADV_SEQUENTIAL);
+#endif  // POSIX_FADV_SEQUENTIAL
+
+  state->size = size;
+  state->file_offset = file_offset;
+  state->buffer_offset = buffer_offset;
+  state->chunk_size = options_.chunk_size;
+  state->buffer = buffer;
+  int chunks = static_cast<int>((size + options_.chunk_size - 1) /
+                                options_.chunk_size);
+  cl::Context context = queue_->context();
+  for (int i = 0; i < chunks; ++i)
+    state->chunk_events.push_back(cl::UserEvent(context));
+  state->done = cl::UserEvent(context);
+  state->remaining = chunks;
+  if (chunks == 0) {
+    state->done.setStatus(CL_COMPLETE);
+    return FileLoad(state);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < chunks; ++i)
+      jobs_.push_back(Job{state, i});
+  }
+  jobs_ready_.notify_all();
+  return FileLoad(state);
+}
+
+void FileLoader::WorkerLoop() {
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      jobs_ready_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+      // started loads are finished before stop
+      if (jobs_.empty()) return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    ReadChunk(job);
+  }
+}
+
+void FileLoader::ReadChunk(const Job& job) {
+  internal::LoadState& state = *job.state;
+  size_t offset = job.chunk * state.chunk_size;
+  size_t bytes = std::min(state.chunk_size, state.size - offset);
+  if (state.failed) {
+    state.Finish(job.chunk, bytes, false);
+    return;
+  }
+
+  int index = AcquireSlot();
+  Slot& slot = slots_[index];
+  std::string error;
+  if (!ReadFully(state.fd, static_cast<char*>(slot.ptr), bytes,
+                 state.file_offset + offset, &error)) {
+    ReleaseSlot(index);
+    state.SetError(error);
+    state.Finish(job.chunk, bytes, false);
+    return;
+  }
+  try {
+    // uploads don't go to in-order queue of Queue: tasks enqueued there
+    // with chunk events as dependencies would block them
+    transfer_queue_.enqueueWriteBuffer(state.buffer, CL_FALSE,
+                                       state.buffer_offset + offset, bytes,
+                                       slot.ptr, nullptr, &slot.upload);
+    slot.upload.setCallback(CL_COMPLETE, &OnUploaded,
+                            new Upload{job.state, job.chunk, bytes});
+    transfer_queue_.flush();
+  } catch (const cl::Error& e) {
+    // chunk isn't finished by callback, staging buffer is free
+    slot.upload = cl::Event();
+    ReleaseSlot(index);
+    state.SetError(std::string(e.what()) + " (" +
+                   Queue::StatusStr(e.err()) + ")");
+    state.Finish(job.chunk, bytes, false);
+    return;
+  }
+  ReleaseSlot(index);
+}
+
+int FileLoader::AcquireSlot() {
+  int index;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_ready_.wait(lock, [this] { return !free_slots_.empty(); });
+    index = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  // staging buffer is overwritten only after its previous upload (failed
+  // upload is reported by OnUploaded())
+  if (slots_[index].upload()) {
+    try {
+      slots_[index].upload.wait();
+    } catch (const cl::Error&) {
+    }
+  }
+  return index;
+}
+
+void FileLoader::ReleaseSlot(int slot) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_slots_.push_back(slot);
+  }
+  slot_ready_.notify_one();
+}
+
+}  // namespace oclalgo
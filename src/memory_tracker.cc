@@ -0,0 +1,377 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file memory_tracker.cc
+ *  @brief MemoryTracker class implementation.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/memory_tracker.h"
+
+#include <algorithm>
+#include <string>
+
+namespace oclalgo {
+
+namespace {
+
+const char kUntagged[] = "untagged";
+
+}  // namespace
+
+MemoryTracker::MemoryTracker(const cl::Context& context)
+    : context_(context),
+      budget_(std::numeric_limits<size_t>::max()),
+      policy_(BudgetPolicy::FailFast),
+      spilled_(0),
+      cached_(0),
+      reserved_(0) {
+}
+
+cl::Buffer MemoryTracker::Allocate(cl_mem_flags flags, size_t size,
+                                   void* host_ptr, const char* tag) {
+  if (tag == nullptr) tag = kUntagged;
+  cl::Buffer buffer;
+  BudgetPolicy policy;
+  bool spill = false;
+  size_t reserved = 0;
+  // evicted buffers are released outside the lock: OpenCL may call
+  // destructor callback (which locks mutex) directly from clReleaseMemObject
+  std::list<CacheEntry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (host_ptr == nullptr && TakeFromCache(size, flags, tag, &buffer))
+      return buffer;
+    policy = policy_;
+    spill = CheckBudget(size, &evicted);
+    // device bytes are reserved until the buffer is accounted, so that
+    // concurrent allocations can't exceed the budget together
+    if (!spill) reserved = size;
+    reserved_ += reserved;
+  }
+  evicted.clear();
+
+  cl_mem_flags alloc_flags = flags;
+  if (spill && !(flags & CL_MEM_USE_HOST_PTR))
+    alloc_flags |= CL_MEM_ALLOC_HOST_PTR;
+  try {
+    try {
+      buffer = cl::Buffer(context_, alloc_flags, size, host_ptr);
+    } catch (const cl::Error& e) {
+      // device can't allocate memory by itself: apply policy once more
+      if (e.err() != CL_MEM_OBJECT_ALLOCATION_FAILURE || spill ||
+          policy == BudgetPolicy::FailFast)
+        throw;
+      if (policy == BudgetPolicy::EvictCache) {
+        ClearCache();
+      } else {
+        spill = true;
+        Unreserve(reserved);
+        reserved = 0;
+        if (!(flags & CL_MEM_USE_HOST_PTR))
+          alloc_flags |= CL_MEM_ALLOC_HOST_PTR;
+      }
+      buffer = cl::Buffer(context_, alloc_flags, size, host_ptr);
+    }
+  } catch (const cl::Error&) {
+    Unreserve(reserved);
+    throw;
+  }
+  return Register(buffer, size, flags, spill, tag, reserved);
+}
+
+void MemoryTracker::Recycle(const cl::Buffer& buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = records_.find(buffer());
+  if (it == records_.end() || (it->second->flags & CL_MEM_USE_HOST_PTR))
+    return;
+  Record* record = it->second;
+  for (const auto& entry : cache_)
+    if (entry.record == record) return;
+  cache_.push_back({ buffer, record });
+  cached_ += record->size;
+}
+
+void MemoryTracker::ClearCache() {
+  // buffers are unaccounted by OnRelease() when the last reference to them
+  // is released (recycled buffer can still be referenced)
+  std::list<CacheEntry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cached_ = 0;
+    evicted.swap(cache_);
+  }
+}
+
+void* MemoryTracker::AllocateSvm(cl_mem_flags flags, size_t size,
+                                 const char* tag) {
+#ifdef CL_VERSION_2_0
+  if (tag == nullptr) tag = kUntagged;
+  std::list<CacheEntry> evicted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (CheckBudget(size, &evicted)) return nullptr;
+    reserved_ += size;
+  }
+  evicted.clear();
+
+  void* ptr = clSVMAlloc(context_(), flags, size, 0);
+  if (ptr == nullptr) {
+    Unreserve(size);
+    throw cl::Error(CL_MEM_OBJECT_ALLOCATION_FAILURE, "clSVMAlloc");
+  }
+  Record* record = new Record();
+  record->size = size;
+  record->flags = flags;
+  record->spilled = false;
+  record->counted = false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  reserved_ -= size;
+  Account(record, tag);
+  svm_records_[ptr] = record;
+  return ptr;
+#else
+  (void)flags, (void)size, (void)tag;
+  return nullptr;
+#endif  // CL_VERSION_2_0
+}
+
+void MemoryTracker::FreeSvm(void* ptr) {
+#ifdef CL_VERSION_2_0
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = svm_records_.find(ptr);
+    if (it == svm_records_.end()) return;
+    Unaccount(it->second);
+    delete it->second;
+    svm_records_.erase(it);
+  }
+  clSVMFree(context_(), ptr);
+#else
+  (void)ptr;
+#endif  // CL_VERSION_2_0
+}
+
+bool MemoryTracker::IsSvmPointer(const void* ptr, cl_mem_flags* flags) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = svm_records_.find(ptr);
+  if (it == svm_records_.end()) return false;
+  if (flags) *flags = it->second->flags;
+  return true;
+}
+
+void MemoryTracker::SetBudget(size_t budget, BudgetPolicy policy) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budget_ = budget;
+  policy_ = policy;
+}
+
+size_t MemoryTracker::budget() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return budget_;
+}
+
+BudgetPolicy MemoryTracker::policy() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return policy_;
+}
+
+size_t MemoryTracker::live_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_.live;
+}
+
+size_t MemoryTracker::peak_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_.peak;
+}
+
+size_t MemoryTracker::cached_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cached_;
+}
+
+size_t MemoryTracker::spilled_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return spilled_;
+}
+
+MemoryUsage MemoryTracker::usage(const std::string& tag) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tags_.find(tag);
+  return it != tags_.end() ? it->second : MemoryUsage();
+}
+
+std::map<std::string, MemoryUsage> MemoryTracker::usage() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tags_;
+}
+
+void MemoryTracker::ResetPeak() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  total_.peak = total_.live;
+  for (auto& tag : tags_)
+    tag.second.peak = tag.second.live;
+}
+
+void CL_CALLBACK MemoryTracker::OnRelease(cl_mem memobj, void* user_data) {
+  Record* record = static_cast<Record*>(user_data);
+  std::shared_ptr<MemoryTracker> tracker = record->tracker;
+  {
+    std::lock_guard<std::mutex> lock(tracker->mutex_);
+    tracker->Unaccount(record);
+    // cl_mem handle can be reused by the next allocation before this callback
+    auto it = tracker->records_.find(memobj);
+    if (it != tracker->records_.end() && it->second == record)
+      tracker->records_.erase(it);
+  }
+  delete record;
+}
+
+// returns true if allocation should be placed in host memory
+bool MemoryTracker::CheckBudget(size_t size,
+                                std::list<CacheEntry>* evicted) {
+  // allocations of other threads are counted by their reservations
+  size_t used = total_.live + reserved_;
+  if (size <= budget_ && used <= budget_ - size) return false;
+  switch (policy_) {
+    case BudgetPolicy::FailFast:
+      throw cl::Error(CL_MEM_OBJECT_ALLOCATION_FAILURE,
+                      "device memory budget is exceeded");
+    case BudgetPolicy::EvictCache:
+      EvictUntilFits(size, &used, evicted);
+      if (size > budget_ || used > budget_ - size)
+        throw cl::Error(CL_MEM_OBJECT_ALLOCATION_FAILURE,
+                        "device memory budget is exceeded after eviction");
+      return false;
+    case BudgetPolicy::SpillToHost:
+      return true;
+  }
+  return false;
+}
+
+cl::Buffer MemoryTracker::Register(cl::Buffer buffer, size_t size,
+                                   cl_mem_flags flags, bool spilled,
+                                   const char* tag, size_t reserved) {
+  Record* record = new Record();
+  record->tracker = shared_from_this();
+  record->size = size;
+  record->flags = flags;
+  record->spilled = spilled;
+  record->counted = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reserved_ -= reserved;
+    Account(record, tag);
+    records_[buffer()] = record;
+  }
+  cl_int err = clSetMemObjectDestructorCallback(buffer(),
+                                                &MemoryTracker::OnRelease,
+                                                record);
+  if (err != CL_SUCCESS) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Unaccount(record);
+      records_.erase(buffer());
+    }
+    delete record;
+    throw cl::Error(err, "clSetMemObjectDestructorCallback");
+  }
+  return buffer;
+}
+
+void MemoryTracker::Account(Record* record, const std::string& tag) {
+  record->tag = tag;
+  record->counted = true;
+  MemoryUsage& usage = tags_[tag];
+  usage.live += record->size;
+  usage.peak = std::max(usage.peak, usage.live);
+  ++usage.allocations;
+  if (record->spilled) {
+    spilled_ += record->size;
+  } else {
+    total_.live += record->size;
+    total_.peak = std::max(total_.peak, total_.live);
+    ++total_.allocations;
+  }
+}
+
+void MemoryTracker::Unaccount(Record* record) {
+  if (!record->counted) return;
+  record->counted = false;
+  tags_[record->tag].live -= record->size;
+  if (record->spilled)
+    spilled_ -= record->size;
+  else
+    total_.live -= record->size;
+}
+
+bool MemoryTracker::TakeFromCache(size_t size, cl_mem_flags flags,
+                                  const char* tag, cl::Buffer* buffer) {
+  // the most recently recycled buffers are reused first
+  for (auto it = cache_.rbegin(); it != cache_.rend(); ++it) {
+    if (it->record->size == size && it->record->flags == flags) {
+      *buffer = it->buffer;
+      cached_ -= size;
+      Unaccount(it->record);
+      Account(it->record, tag);
+      cache_.erase(std::next(it).base());
+      return true;
+    }
+  }
+  return false;
+}
+
+void MemoryTracker::EvictUntilFits(size_t size, size_t* used,
+                                   std::list<CacheEntry>* evicted) {
+  // the oldest cached buffers are evicted first; they are expected to be
+  // released with their cache references, but stay accounted until
+  // OnRelease()
+  while (!cache_.empty() && (size > budget_ || *used > budget_ - size)) {
+    size_t bytes = cache_.front().record->size;
+    cached_ -= bytes;
+    *used -= std::min(*used, bytes);
+    evicted->splice(evicted->end(), cache_, cache_.begin());
+  }
+}
+
+void MemoryTracker::Unreserve(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  reserved_ -= bytes;
+}
+
+}  // namespace oclalgo
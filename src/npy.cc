@@ -0,0 +1,477 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file npy.cc
+ *  @brief Implementation of .npy and .npz reading and writing.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/npy.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oclalgo {
+
+namespace {
+
+const char npy_magic[] = "\x93NUMPY";
+const size_t npy_magic_size = 6;
+const size_t npy_alignment = 64;
+
+// ZIP records
+const uint32_t zip_local_header = 0x04034b50;
+const uint32_t zip_central_header = 0x02014b50;
+const uint32_t zip_end = 0x06054b50;
+const uint32_t zip64_end = 0x06064b50;
+const uint32_t zip64_locator = 0x07064b50;
+const uint16_t zip64_extra = 0x0001;
+const uint32_t zip_max32 = 0xFFFFFFFF;
+const uint16_t zip_max16 = 0xFFFF;
+const size_t zip_local_size = 30;
+const size_t zip_central_size = 46;
+const size_t zip_end_size = 22;
+const size_t zip64_end_size = 56;
+const size_t zip64_locator_size = 20;
+
+uint64_t ReadLE(const char* p, int bytes) {
+  uint64_t value = 0;
+  for (int i = bytes - 1; i >= 0; --i)
+    value = (value << 8) | static_cast<unsigned char>(p[i]);
+  return value;
+}
+
+void AppendLE(std::string* out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i)
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+// position after "key": in header dictionary (npos if key is absent)
+size_t FindValue(const std::string& dict, const std::string& key) {
+  for (const char* quote : {"'", "\""}) {
+    size_t pos = dict.find(quote + key + quote);
+    if (pos == std::string::npos) continue;
+    pos = dict.find(':', pos + key.size() + 2);
+    if (pos == std::string::npos) return pos;
+    return dict.find_first_not_of(' ', pos + 1);
+  }
+  return std::string::npos;
+}
+
+void Check(bool condition, const std::string& source,
+           const std::string& message) {
+  if (!condition)
+    throw std::runtime_error(source + ": " + message);
+}
+
+void WriteOrThrow(std::ofstream* out, const std::string& path,
+                  const void* data, size_t bytes) {
+  out->write(static_cast<const char*>(data),
+             static_cast<std::streamsize>(bytes));
+  if (!*out)
+    throw std::system_error(errno, std::generic_category(), path);
+}
+
+}  // namespace
+
+namespace internal {
+
+NpyHeader ParseNpyHeader(const char* data, size_t size,
+                         const std::string& source) {
+  Check(size >= 10 && std::memcmp(data, npy_magic, npy_magic_size) == 0,
+        source, "not a .npy array");
+  int major = static_cast<unsigned char>(data[6]);
+  Check(major >= 1 && major <= 3, source, "unsupported .npy version");
+  size_t length_size = major == 1 ? 2 : 4;
+  Check(size >= 8 + length_size, source, "truncated .npy header");
+  size_t length = ReadLE(data + 8, static_cast<int>(length_size));
+  NpyHeader header;
+  header.data_offset = 8 + length_size + length;
+  Check(header.data_offset <= size, source, "truncated .npy header");
+  std::string dict(data + 8 + length_size, length);
+
+  size_t pos = FindValue(dict, "descr");
+  Check(pos != std::string::npos && (dict[pos] == '\'' || dict[pos] == '"'),
+        source, "no descr in .npy header");
+  size_t end = dict.find(dict[pos], pos + 1);
+  Check(end != std::string::npos, source, "bad descr in .npy header");
+  header.descr = dict.substr(pos + 1, end - pos - 1);
+
+  pos = FindValue(dict, "fortran_order");
+  Check(pos != std::string::npos, source, "no fortran_order in .npy header");
+  header.fortran_order = dict.compare(pos, 4, "True") == 0;
+
+  pos = FindValue(dict, "shape");
+  Check(pos != std::string::npos && dict[pos] == '(', source,
+        "no shape in .npy header");
+  end = dict.find(')', pos);
+  Check(end != std::string::npos, source, "bad shape in .npy header");
+  for (size_t i = pos + 1; i < end;) {
+    i = dict.find_first_not_of(", ", i);
+    if (i >= end) break;
+    char* next = nullptr;
+    unsigned long long dim = std::strtoull(dict.c_str() + i, &next, 10);
+    Check(next != dict.c_str() + i, source, "bad shape in .npy header");
+    header.shape.push_back(static_cast<size_t>(dim));
+    i = next - dict.c_str();
+  }
+  return header;
+}
+
+std::string FormatNpyHeader(const std::string& descr, bool fortran_order,
+                            const std::vector<size_t>& shape) {
+  std::string dict = "{'descr': '" + descr + "', 'fortran_order': " +
+                     (fortran_order ? "True" : "False") + ", 'shape': (";
+  for (size_t i = 0; i < shape.size(); ++i) {
+    dict += std::to_string(shape[i]);
+    if (i + 1 < shape.size() || shape.size() == 1) dict += ",";
+    if (i + 1 < shape.size()) dict += " ";
+  }
+  dict += "), }";
+  // version 1.0 has 2-byte header length, 2.0 - 4-byte
+  size_t prefix = 10;
+  if (dict.size() + 1 + npy_alignment > 0xFFFF) prefix = 12;
+  size_t total = (prefix + dict.size() + 1 + npy_alignment - 1) /
+                 npy_alignment * npy_alignment;
+  dict.append(total - prefix - dict.size() - 1, ' ');
+  dict += '\n';
+
+  std::string header(npy_magic, npy_magic_size);
+  header.push_back(static_cast<char>(prefix == 10 ? 1 : 2));
+  header.push_back(0);
+  AppendLE(&header, dict.size(), prefix == 10 ? 2 : 4);
+  return header + dict;
+}
+
+std::pair<int, int> NpyMatrixShape(const NpyHeader& header,
+                                   const std::string& source) {
+  size_t rows = 1, cols = 1;
+  if (header.shape.size() == 1) {
+    rows = header.shape[0];
+  } else if (header.shape.size() == 2) {
+    rows = header.shape[0];
+    cols = header.shape[1];
+  } else if (header.shape.size() > 2) {
+    Check(!header.fortran_order, source,
+          "arrays of more than 2 dimensions in Fortran order aren't "
+          "supported");
+    rows = header.shape[0];
+    for (size_t i = 1; i < header.shape.size(); ++i)
+      cols *= header.shape[i];
+  }
+  Check(rows <= INT_MAX && cols <= INT_MAX &&
+        (rows == 0 || cols <= SIZE_MAX / rows), source, "array is too large");
+  return std::make_pair(static_cast<int>(rows), static_cast<int>(cols));
+}
+
+bool NpyDescrMatches(const std::string& descr, const std::string& expected) {
+  // byte order of native little-endian data can be '<', '=' or '|'
+  return descr.size() == expected.size() && descr.size() > 1 &&
+         descr[0] != '>' && descr.compare(1, std::string::npos, expected,
+                                          1, std::string::npos) == 0;
+}
+
+MappedFile MapFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(), path);
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    int err = errno;
+    close(fd);
+    throw std::system_error(err, std::generic_category(), path);
+  }
+  MappedFile file;
+  file.size = static_cast<size_t>(info.st_size);
+  if (file.size == 0) {
+    close(fd);
+    file.data = std::shared_ptr<char>(new char[1],
+                                      std::default_delete<char[]>());
+    return file;
+  }
+  // private mapping: elements can be changed without changing file
+  void* ptr = mmap(nullptr, file.size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                   fd, 0);
+  int err = errno;
+  close(fd);
+  if (ptr == MAP_FAILED)
+    throw std::system_error(err, std::generic_category(), path);
+  madvise(ptr, file.size, MADV_SEQUENTIAL);
+  size_t size = file.size;
+  file.data = std::shared_ptr<char>(static_cast<char*>(ptr),
+                                    [size](char* p) { munmap(p, size); });
+  return file;
+}
+
+uint32_t Crc32(const void* data, size_t size, uint32_t crc) {
+  static const std::vector<uint32_t> table = [] {
+    std::vector<uint32_t> t(256);
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k)
+        c = (c & 1) ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+      t[i] = c;
+    }
+    return t;
+  }();
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+    crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+void WriteNpy(const std::string& path, const std::string& header,
+              const void* data, size_t bytes) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw std::system_error(errno, std::generic_category(), path);
+  WriteOrThrow(&out, path, header.data(), header.size());
+  WriteOrThrow(&out, path, data, bytes);
+}
+
+}  // namespace internal
+
+NpzFile::NpzFile(const std::string& path)
+    : path_(path),
+      file_(internal::MapFile(path)) {
+  const char* data = file_.data.get();
+  size_t size = file_.size;
+  Check(size >= zip_end_size, path, "not a .npz archive");
+  // end of central directory record is followed by comment (< 64 KB)
+  size_t end = size - zip_end_size;
+  size_t lowest = size > zip_end_size + zip_max16 ?
+      size - zip_end_size - zip_max16 : 0;
+  while (ReadLE(data + end, 4) != zip_end) {
+    Check(end > lowest, path, "not a .npz archive");
+    --end;
+  }
+  uint64_t count = ReadLE(data + end + 10, 2);
+  uint64_t directory = ReadLE(data + end + 16, 4);
+  if ((count == zip_max16 || directory == zip_max32) &&
+      end >= zip64_locator_size &&
+      ReadLE(data + end - zip64_locator_size, 4) == zip64_locator) {
+    uint64_t record = ReadLE(data + end - zip64_locator_size + 8, 8);
+    Check(record + zip64_end_size <= size &&
+          ReadLE(data + record, 4) == zip64_end, path, "bad ZIP64 record");
+    count = ReadLE(data + record + 32, 8);
+    directory = ReadLE(data + record + 48, 8);
+  }
+
+  size_t pos = directory;
+  for (uint64_t i = 0; i < count; ++i) {
+    Check(pos + zip_central_size <= size &&
+          ReadLE(data + pos, 4) == zip_central_header, path,
+          "bad .npz directory");
+    int method = static_cast<int>(ReadLE(data + pos + 10, 2));
+    uint64_t stored = ReadLE(data + pos + 20, 4);
+    uint64_t length = ReadLE(data + pos + 24, 4);
+    size_t name_size = ReadLE(data + pos + 28, 2);
+    size_t extra_size = ReadLE(data + pos + 30, 2);
+    size_t comment_size = ReadLE(data + pos + 32, 2);
+    uint64_t offset = ReadLE(data + pos + 42, 4);
+    Check(pos + zip_central_size + name_size + extra_size <= size, path,
+          "bad .npz directory");
+    std::string name(data + pos + zip_central_size, name_size);
+    // ZIP64 extra field has 8-byte values of fields set to 0xFFFFFFFF
+    const char* extra = data + pos + zip_central_size + name_size;
+    for (size_t e = 0; e + 4 <= extra_size;) {
+      size_t field_size = ReadLE(extra + e + 2, 2);
+      if (ReadLE(extra + e, 2) == zip64_extra) {
+        const char* field = extra + e + 4;
+        if (length == zip_max32) { length = ReadLE(field, 8); field += 8; }
+        if (stored == zip_max32) { stored = ReadLE(field, 8); field += 8; }
+        if (offset == zip_max32) offset = ReadLE(field, 8);
+      }
+      e += 4 + field_size;
+    }
+    Check(method == 0, path, name + " is compressed (only stored .npz "
+          "archives are supported)");
+    Check(offset + zip_local_size <= size &&
+          ReadLE(data + offset, 4) == zip_local_header, path,
+          "bad local header of " + name);
+    size_t start = offset + zip_local_size + ReadLE(data + offset + 26, 2) +
+                   ReadLE(data + offset + 28, 2);
+    Check(start + stored <= size, path, name + " is truncated");
+
+    const std::string suffix = ".npy";
+    if (name.size() > suffix.size() &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+      name.resize(name.size() - suffix.size());
+    names_.push_back(name);
+    entries_[name] = std::make_pair(start, static_cast<size_t>(stored));
+    pos += zip_central_size + name_size + extra_size + comment_size;
+  }
+}
+
+std::pair<size_t, size_t> NpzFile::Find(const std::string& name) const {
+  auto it = entries_.find(name);
+  Check(it != entries_.end(), path_, "no array " + name);
+  return it->second;
+}
+
+NpzWriter::NpzWriter(const std::string& path)
+    : path_(path),
+      out_(path, std::ios::binary | std::ios::trunc) {
+  if (!out_)
+    throw std::system_error(errno, std::generic_category(), path);
+}
+
+NpzWriter::~NpzWriter() {
+  if (out_.is_open()) {
+    try {
+      Close();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+void NpzWriter::AddEntry(const std::string& name, const std::string& header,
+                         const void* data, size_t bytes) {
+  Entry entry;
+  entry.name = name + ".npy";
+  entry.size = header.size() + bytes;
+  entry.offset = static_cast<uint64_t>(out_.tellp());
+  entry.crc = internal::Crc32(data, bytes,
+                              internal::Crc32(header.data(), header.size()));
+  bool zip64 = entry.size >= zip_max32;
+
+  std::string local;
+  AppendLE(&local, zip_local_header, 4);
+  AppendLE(&local, zip64 ? 45 : 20, 2);  // version needed
+  AppendLE(&local, 0, 2);                // flags
+  AppendLE(&local, 0, 2);                // stored
+  AppendLE(&local, 0, 2);                // time
+  AppendLE(&local, 0x21, 2);             // date (1980-01-01)
+  AppendLE(&local, entry.crc, 4);
+  AppendLE(&local, zip64 ? zip_max32 : entry.size, 4);
+  AppendLE(&local, zip64 ? zip_max32 : entry.size, 4);
+  AppendLE(&local, entry.name.size(), 2);
+  AppendLE(&local, zip64 ? 20 : 0, 2);
+  local += entry.name;
+  if (zip64) {
+    AppendLE(&local, zip64_extra, 2);
+    AppendLE(&local, 16, 2);
+    AppendLE(&local, entry.size, 8);
+    AppendLE(&local, entry.size, 8);
+  }
+  WriteOrThrow(&out_, path_, local.data(), local.size());
+  WriteOrThrow(&out_, path_, header.data(), header.size());
+  WriteOrThrow(&out_, path_, data, bytes);
+  entries_.push_back(entry);
+}
+
+void NpzWriter::Close() {
+  uint64_t directory = static_cast<uint64_t>(out_.tellp());
+  std::string central;
+  for (const Entry& entry : entries_) {
+    bool large = entry.size >= zip_max32;
+    bool far = entry.offset >= zip_max32;
+    std::string extra;
+    if (large || far) {
+      AppendLE(&extra, zip64_extra, 2);
+      AppendLE(&extra, (large ? 16 : 0) + (far ? 8 : 0), 2);
+      if (large) {
+        AppendLE(&extra, entry.size, 8);
+        AppendLE(&extra, entry.size, 8);
+      }
+      if (far) AppendLE(&extra, entry.offset, 8);
+    }
+    AppendLE(&central, zip_central_header, 4);
+    AppendLE(&central, extra.empty() ? 20 : 45, 2);  // version made by
+    AppendLE(&central, extra.empty() ? 20 : 45, 2);  // version needed
+    AppendLE(&central, 0, 2);
+    AppendLE(&central, 0, 2);
+    AppendLE(&central, 0, 2);
+    AppendLE(&central, 0x21, 2);
+    AppendLE(&central, entry.crc, 4);
+    AppendLE(&central, large ? zip_max32 : entry.size, 4);
+    AppendLE(&central, large ? zip_max32 : entry.size, 4);
+    AppendLE(&central, entry.name.size(), 2);
+    AppendLE(&central, extra.size(), 2);
+    AppendLE(&central, 0, 2);  // comment
+    AppendLE(&central, 0, 2);  // disk
+    AppendLE(&central, 0, 2);  // internal attributes
+    AppendLE(&central, 0, 4);  // external attributes
+    AppendLE(&central, far ? zip_max32 : entry.offset, 4);
+    central += entry.name + extra;
+  }
+
+  uint64_t count = entries_.size();
+  std::string end;
+  bool zip64 = count >= zip_max16 || directory >= zip_max32 ||
+               central.size() >= zip_max32;
+  if (zip64) {
+    uint64_t record = directory + central.size();
+    AppendLE(&end, zip64_end, 4);
+    AppendLE(&end, zip64_end_size - 12, 8);
+    AppendLE(&end, 45, 2);
+    AppendLE(&end, 45, 2);
+    AppendLE(&end, 0, 4);
+    AppendLE(&end, 0, 4);
+    AppendLE(&end, count, 8);
+    AppendLE(&end, count, 8);
+    AppendLE(&end, central.size(), 8);
+    AppendLE(&end, directory, 8);
+    AppendLE(&end, zip64_locator, 4);
+    AppendLE(&end, 0, 4);
+    AppendLE(&end, record, 8);
+    AppendLE(&end, 1, 4);
+  }
+  AppendLE(&end, zip_end, 4);
+  AppendLE(&end, 0, 2);
+  AppendLE(&end, 0, 2);
+  AppendLE(&end, zip64 ? zip_max16 : count, 2);
+  AppendLE(&end, zip64 ? zip_max16 : count, 2);
+  AppendLE(&end, zip64 ? zip_max32 : central.size(), 4);
+  AppendLE(&end, zip64 ? zip_max32 : directory, 4);
+  AppendLE(&end, 0, 2);
+  WriteOrThrow(&out_, path_, central.data(), central.size());
+  WriteOrThrow(&out_, path_, end.data(), end.size());
+  out_.close();
+  if (!out_)
+    throw std::system_error(errno, std::generic_category(), path_);
+}
+
+}  // namespace oclalgo
@@ -0,0 +1,180 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file numa.cc
+ *  @brief Numa class implementation.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/numa.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // __linux__
+
+namespace oclalgo {
+
+namespace {
+
+struct Topology {
+  Topology() {
+    for (int node = 0; ; ++node) {
+      std::ifstream file("/sys/devices/system/node/node" +
+                         std::to_string(node) + "/cpulist");
+      if (!file) break;
+      std::string list;
+      std::getline(file, list);
+      cpus.push_back(Numa::ParseCpuList(list));
+    }
+    if (cpus.empty()) {
+      int count = std::max(1U, std::thread::hardware_concurrency());
+      cpus.push_back(std::vector<int>());
+      for (int cpu = 0; cpu < count; ++cpu)
+        cpus[0].push_back(cpu);
+    }
+  }
+
+  std::vector<std::vector<int>> cpus;
+};
+
+const Topology& topology() {
+  static Topology topology;
+  return topology;
+}
+
+#ifdef __linux__
+long mbind(void* addr, unsigned long len, int mode,
+           const unsigned long* nodemask, unsigned long maxnode) {
+  return syscall(SYS_mbind, addr, len, mode, nodemask, maxnode, 0);
+}
+#endif  // __linux__
+
+}  // namespace
+
+int Numa::nodes() {
+  return topology().cpus.size();
+}
+
+const std::vector<int>& Numa::cpus(int node) {
+  return topology().cpus.at(node);
+}
+
+std::vector<int> Numa::NodeOrderedCpus() {
+  std::vector<int> result;
+  for (const auto& node_cpus : topology().cpus)
+    result.insert(result.end(), node_cpus.begin(), node_cpus.end());
+  return result;
+}
+
+int Numa::NodeOfCpu(int cpu) {
+  for (int node = 0; node < nodes(); ++node) {
+    const std::vector<int>& node_cpus = cpus(node);
+    if (std::find(node_cpus.begin(), node_cpus.end(), cpu) != node_cpus.end())
+      return node;
+  }
+  return 0;
+}
+
+int Numa::PciDeviceNode(const std::string& address) {
+  std::ifstream file("/sys/bus/pci/devices/" + address + "/numa_node");
+  int node = -1;
+  if (!(file >> node) || node >= nodes()) return -1;
+  return node;
+}
+
+void* Numa::Allocate(size_t bytes, NumaPolicy policy, int node) {
+#ifdef __linux__
+  void* ptr = mmap(nullptr, std::max<size_t>(bytes, 1),
+                   PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) throw std::bad_alloc();
+  if (nodes() > 1 && bytes > 0) {
+    // failed mbind() leaves default policy, it isn't an allocation error
+    const unsigned long bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(nodes() / bits + 1, 0);
+    if (policy == NumaPolicy::Interleave) {
+      for (int n = 0; n < nodes(); ++n)
+        mask[n / bits] |= 1UL << (n % bits);
+      mbind(ptr, bytes, MPOL_INTERLEAVE, mask.data(), mask.size() * bits);
+    } else if (policy == NumaPolicy::Bind && node >= 0 && node < nodes()) {
+      mask[node / bits] |= 1UL << (node % bits);
+      mbind(ptr, bytes, MPOL_BIND, mask.data(), mask.size() * bits);
+    }
+  }
+  return ptr;
+#else
+  (void)policy, (void)node;
+  void* ptr = std::calloc(std::max<size_t>(bytes, 1), 1);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+#endif  // __linux__
+}
+
+void Numa::Free(void* ptr, size_t bytes) {
+#ifdef __linux__
+  munmap(ptr, std::max<size_t>(bytes, 1));
+#else
+  (void)bytes;
+  std::free(ptr);
+#endif  // __linux__
+}
+
+std::vector<int> Numa::ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) continue;
+    size_t dash = range.find('-');
+    int first = std::atoi(range.c_str());
+    int last = dash == std::string::npos ? first :
+                                           std::atoi(range.c_str() + dash + 1);
+    for (int cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+}  // namespace oclalgo
@@ -43,6 +43,10 @@
 #include "inc/oclalgo/queue.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
 #include <string>
 
 namespace oclalgo {
@@ -93,6 +97,9 @@ Queue::Queue(const std::string& platformPartName,
   }
 
   queue_ = cl::CommandQueue(context_, device_);
+  tracker_ = std::make_shared<MemoryTracker>(context_);
+  svm_mode_ = QuerySvmMode(device_);
+  numa_node_ = QueryNumaNode(device_);
 }
 
 Queue::Queue(int platformId, int deviceId) {
@@ -120,6 +127,14 @@ Queue::Queue(int platformId, int deviceId) {
   device_ = devices[device_id_];
 
   queue_ = cl::CommandQueue(context_, device_);
+  tracker_ = std::make_shared<MemoryTracker>(context_);
+  svm_mode_ = QuerySvmMode(device_);
+  numa_node_ = QueryNumaNode(device_);
+}
+
+Queue::~Queue() {
+  // cached buffers hold the tracker alive through destructor callbacks
+  tracker_->ClearCache();
 }
 
 std::string Queue::StatusStr(cl_int code) {
@@ -228,15 +243,85 @@ std::string Queue::StatusStr(cl_int code) {
   }
 }
 
-std::vector<cl::Event> ExtractEvents() { return std::vector<cl::Event>(); }
-
-std::vector<cl::Event> ExtractEvents(const cl::Event& event) {
-  return std::vector<cl::Event>({ event });
+SvmMode Queue::QuerySvmMode(const cl::Device& device) {
+#ifdef CL_VERSION_2_0
+  // device version string has format "OpenCL <major>.<minor> <vendor info>"
+  int major = 1, minor = 0;
+  std::string version = device.getInfo<CL_DEVICE_VERSION>();
+  if (std::sscanf(version.c_str(), "OpenCL %d.%d", &major, &minor) != 2 ||
+      major < 2)
+    return SvmMode::None;
+  cl_device_svm_capabilities caps = 0;
+  cl_int err = clGetDeviceInfo(device(), CL_DEVICE_SVM_CAPABILITIES,
+                               sizeof(caps), &caps, nullptr);
+  if (err != CL_SUCCESS) return SvmMode::None;
+  if (caps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER) return SvmMode::FineGrain;
+  if (caps & CL_DEVICE_SVM_COARSE_GRAIN_BUFFER) return SvmMode::CoarseGrain;
+#else
+  (void)device;
+#endif  // CL_VERSION_2_0
+  return SvmMode::None;
 }
 
-std::vector<cl::Event> ExtractEvents(const std::vector<cl::Event>& events) {
-  return events;
+int Queue::QueryNumaNode(const cl::Device& device) {
+  // PCI address is reported by vendor extensions: cl_khr_pci_bus_info,
+  // cl_nv_device_attribute_query and cl_amd_device_attribute_query
+  const cl_uint kPciBusInfoKhr = 0x410F, kPciBusIdNv = 0x4008,
+                kPciSlotIdNv = 0x4009, kTopologyAmd = 0x4037;
+  struct { cl_uint domain, bus, device, function; } khr;
+  struct { cl_uint type; char unused[17]; char bus, device, function; } amd;
+  cl_uint nv_bus = 0, nv_slot = 0;
+  unsigned domain = 0, bus = 0, dev = 0, function = 0;
+  if (clGetDeviceInfo(device(), kPciBusInfoKhr, sizeof(khr), &khr,
+                      nullptr) == CL_SUCCESS) {
+    domain = khr.domain, bus = khr.bus, dev = khr.device;
+    function = khr.function;
+  } else if (clGetDeviceInfo(device(), kPciBusIdNv, sizeof(nv_bus), &nv_bus,
+                             nullptr) == CL_SUCCESS &&
+             clGetDeviceInfo(device(), kPciSlotIdNv, sizeof(nv_slot),
+                             &nv_slot, nullptr) == CL_SUCCESS) {
+    // slot id is packed as (device << 3) | function
+    bus = nv_bus, dev = nv_slot >> 3, function = nv_slot & 7;
+  } else if (clGetDeviceInfo(device(), kTopologyAmd, sizeof(amd), &amd,
+                             nullptr) == CL_SUCCESS && amd.type == 1) {
+    bus = static_cast<unsigned char>(amd.bus);
+    dev = static_cast<unsigned char>(amd.device);
+    function = static_cast<unsigned char>(amd.function);
+  } else {
+    return -1;
+  }
+  char address[32];
+  std::snprintf(address, sizeof(address), "%04x:%02x:%02x.%x", domain, bus,
+                dev, function);
+  return Numa::PciDeviceNode(address);
 }
 
+cl::Program Queue::GetProgram(const std::string& programName,
+                              const std::string& options) const {
+  char buff[512] = {0};
+  std::snprintf(buff, sizeof(buff), "program=\"%s\"\noptions=\"%s\"",
+                programName.c_str(), options.c_str());
+  std::string program_id(buff);
+  auto it = programs_.find(program_id);
+  if (it != programs_.end())
+    return it->second;
+
+  std::ifstream source_file(programName);
+  std::string source_code(std::istreambuf_iterator<char>(source_file),
+                          (std::istreambuf_iterator<char>()));
+  cl::Program::Sources cl_source(1, std::make_pair(source_code.c_str(),
+                                                   source_code.length() + 1));
+  // build program from source code
+  cl::Program program = cl::Program(context_, cl_source);
+  try {
+    program.build({ device_ }, options.c_str());
+  } catch (const cl::Error& e) {
+    std::printf("Build log:\n%s\n",
+                program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device_).c_str());
+    throw(e);
+  }
+  programs_[program_id] = program;
+  return program;
+}
 
 }  // namespace oclalgo
@@ -0,0 +1,118 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file scratch_pool.cc
+ *  @brief ScopedScratch class implementation.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/scratch_pool.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace oclalgo {
+
+namespace {
+
+thread_local ScopedScratch* active_scratch = nullptr;
+
+void CL_CALLBACK OnSubBufferRelease(cl_mem /*memobj*/, void* user_data) {
+  auto live = static_cast<std::shared_ptr<std::atomic<int>>*>(user_data);
+  --**live;
+  delete live;
+}
+
+}  // namespace
+
+ScopedScratch::ScopedScratch(const Queue* queue, size_t capacity)
+    : queue_(queue),
+      previous_(active_scratch),
+      live_sub_buffers_(std::make_shared<std::atomic<int>>(0)),
+      capacity_(capacity),
+      offset_(0),
+      used_(0),
+      overflow_(0) {
+  // sub-buffer origins should be aligned to CL_DEVICE_MEM_BASE_ADDR_ALIGN
+  cl_uint bits = queue_->device().getInfo<CL_DEVICE_MEM_BASE_ADDR_ALIGN>();
+  align_ = std::max<size_t>(bits / 8, 1);
+  if (capacity_ > 0)
+    buffer_ = queue_->CreateBuffer<char>(capacity_, CL_MEM_READ_WRITE,
+                                         "ScopedScratch");
+  active_scratch = this;
+}
+
+ScopedScratch::~ScopedScratch() {
+  assert(active_scratch == this &&
+         "scratch pools should be destroyed in LIFO order");
+  active_scratch = previous_;
+  // live sub-buffers alias reserved buffer, so it can't be handed out again
+  // and is just released
+  if (capacity_ > 0 && *live_sub_buffers_ == 0)
+    queue_->RecycleBuffer(buffer_);
+}
+
+ScopedScratch* ScopedScratch::active(const Queue* queue) noexcept {
+  for (ScopedScratch* s = active_scratch; s != nullptr; s = s->previous_)
+    if (s->queue_ == queue) return s;
+  return nullptr;
+}
+
+cl::Buffer ScopedScratch::Allocate(size_t bytes, cl_mem_flags flags) {
+  if (bytes == 0) return cl::Buffer();
+  size_t origin = (offset_ + align_ - 1) / align_ * align_;
+  if (origin + bytes > capacity_) {
+    overflow_ += bytes;
+    return queue_->CreateBuffer<char>(bytes, flags, "ScopedScratch");
+  }
+  cl_buffer_region region = { origin, bytes };
+  cl::Buffer buffer = buffer_.createSubBuffer(
+      flags & (CL_MEM_READ_WRITE | CL_MEM_READ_ONLY | CL_MEM_WRITE_ONLY),
+      CL_BUFFER_CREATE_TYPE_REGION, &region);
+  // if callback isn't set, the counter isn't decremented and reserved
+  // buffer isn't recycled
+  ++*live_sub_buffers_;
+  auto live = new std::shared_ptr<std::atomic<int>>(live_sub_buffers_);
+  if (clSetMemObjectDestructorCallback(buffer(), &OnSubBufferRelease,
+                                       live) != CL_SUCCESS)
+    delete live;
+  offset_ = origin + bytes;
+  used_ += bytes;
+  return buffer;
+}
+
+}  // namespace oclalgo
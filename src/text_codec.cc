@@ -0,0 +1,128 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file text_codec.cc
+ *  @brief Implementation of matrix text I/O.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/text_codec.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <system_error>
+
+#include <locale.h>
+#include <unistd.h>
+
+namespace oclalgo {
+
+namespace internal {
+
+namespace {
+
+/** @brief Longest token passed to strtod(). */
+const size_t max_number_size = 512;
+
+/*!
+ * @brief Copies token starting at <i>first</i> to zero-terminated buffer
+ * (text isn't zero-terminated), returns its size.
+ */
+size_t CopyToken(const char* first, const char* last, char* buff) {
+  size_t size = std::min<size_t>(last - first, max_number_size - 1);
+  std::memcpy(buff, first, size);
+  buff[size] = '\0';
+  return size;
+}
+
+/** @brief Returns C locale, numbers don't depend on locale of process. */
+locale_t CLocale() {
+  static locale_t locale = newlocale(LC_ALL_MASK, "C", locale_t());
+  return locale;
+}
+
+}  // namespace
+
+const char* ParseNumberSlow(const char* first, const char* last,
+                            double* value) {
+  char buff[max_number_size];
+  CopyToken(first, last, buff);
+  char* end = nullptr;
+  *value = strtod_l(buff, &end, CLocale());
+  return end == buff ? nullptr : first + (end - buff);
+}
+
+const char* ParseNumberSlow(const char* first, const char* last,
+                            float* value) {
+  char buff[max_number_size];
+  CopyToken(first, last, buff);
+  char* end = nullptr;
+  *value = strtof_l(buff, &end, CLocale());
+  return end == buff ? nullptr : first + (end - buff);
+}
+
+char* FormatNumberSlow(double value, int precision, char* out) {
+  locale_t previous = uselocale(CLocale());
+  int size = std::snprintf(out, 32, "%.*g", precision, value);
+  uselocale(previous);
+  return out + std::min(std::max(size, 0), 31);
+}
+
+size_t ReadBlock(int fd, char* data, size_t size) {
+  for (;;) {
+    ssize_t n = ::read(fd, data, size);
+    if (n >= 0) return static_cast<size_t>(n);
+    if (errno != EINTR)
+      throw std::system_error(errno, std::generic_category(), "read");
+  }
+}
+
+void WriteBlock(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t n = ::write(fd, data, size);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::system_error(errno, std::generic_category(), "write");
+    }
+    data += n;
+    size -= static_cast<size_t>(n);
+  }
+}
+
+}  // namespace internal
+
+}  // namespace oclalgo
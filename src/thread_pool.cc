@@ -0,0 +1,214 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file thread_pool.cc
+ *  @brief ThreadPool class implementation.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/thread_pool.h"
+
+#include <cstdlib>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif  // __linux__
+
+#include "inc/oclalgo/numa.h"
+
+namespace oclalgo {
+
+namespace {
+
+// pool threads (and caller during Run()) execute nested calls serially
+thread_local bool in_pool = false;
+
+size_t DefaultThreads() {
+  const char* env = std::getenv("OCLALGO_NUM_THREADS");
+  if (env != nullptr && std::atoi(env) > 0) return std::atoi(env);
+  size_t threads = std::thread::hardware_concurrency();
+  return threads > 0 ? threads : 1;
+}
+
+bool DefaultPinning() {
+  const char* env = std::getenv("OCLALGO_PIN_THREADS");
+  if (env != nullptr) return std::atoi(env) != 0;
+  return Numa::nodes() > 1;
+}
+
+void PinThread(std::thread* thread, int cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(thread->native_handle(), sizeof(set), &set);
+#else
+  (void)thread, (void)cpu;
+#endif  // __linux__
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threads, bool pinned)
+    : threads_(0),
+      pinned_(pinned),
+      job_(nullptr),
+      tasks_(0),
+      pending_(0),
+      busy_(0),
+      generation_(0),
+      stop_(false) {
+  Start(threads);
+}
+
+ThreadPool::~ThreadPool() {
+  Stop();
+}
+
+ThreadPool* ThreadPool::instance() {
+  static ThreadPool pool(DefaultThreads(), DefaultPinning());
+  return &pool;
+}
+
+void ThreadPool::resize(size_t threads) {
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+  Stop();
+  Start(threads);
+}
+
+void ThreadPool::SetPinning(bool pinned) {
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+  Stop();
+  pinned_ = pinned;
+  Start(threads_);
+}
+
+void ThreadPool::Start(size_t threads) {
+  stop_ = false;
+  threads_ = std::max<size_t>(threads, 1);
+  std::vector<int> cpus = Numa::NodeOrderedCpus();
+  // with pinning the calling thread doesn't run chunks
+  for (size_t index = pinned_ ? 0 : 1; index < threads_; ++index) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, index);
+    if (pinned_)
+      PinThread(&workers_.back(), cpus[index * cpus.size() / threads_]);
+  }
+}
+
+void ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+  workers_.clear();
+}
+
+void ThreadPool::Run(size_t tasks, const std::function<void(size_t)>& job) {
+  std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+  if (in_pool || !run_lock.owns_lock()) {
+    for (size_t k = 0; k < tasks; ++k)
+      job(k);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = &job;
+    tasks_ = tasks;
+    pending_ = tasks;
+    error_ = nullptr;
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  if (!pinned_) {
+    in_pool = true;
+    Execute(0);
+    in_pool = false;
+  }
+
+  // the next job can't be set while pool threads are running this one
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return pending_ == 0 && busy_ == 0; });
+  job_ = nullptr;
+  std::exception_ptr error = error_;
+  error_ = nullptr;
+  lock.unlock();
+  if (error) std::rethrow_exception(error);
+}
+
+void ThreadPool::Execute(size_t index) {
+  if (index >= tasks_) return;
+  // task is completed even if job throws, Run() rethrows the first error
+  try {
+    (*job_)(index);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_) error_ = std::current_exception();
+  }
+  if (--pending_ == 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_.notify_all();
+  }
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+  in_pool = true;
+  uint64_t generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+      if (stop_) return;
+      generation = generation_;
+      if (job_ == nullptr) continue;
+      ++busy_;
+    }
+    Execute(index);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --busy_;
+    }
+    done_.notify_all();
+  }
+}
+
+}  // namespace oclalgo
@@ -0,0 +1,149 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file typed_kernel.cc
+ *  @brief Kernel enqueue and kernel argument checks implementation.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include "inc/oclalgo/typed_kernel.h"
+
+#include <cstring>
+
+namespace oclalgo {
+
+namespace {
+
+/** @brief Size and kind of OpenCL builtin scalar type. */
+struct ScalarType {
+  const char* name;
+  size_t size;
+  bool floating;
+};
+
+const ScalarType kScalarTypes[] = {
+  { "char", 1, false }, { "uchar", 1, false }, { "unsigned char", 1, false },
+  { "short", 2, false }, { "ushort", 2, false },
+  { "unsigned short", 2, false },
+  { "int", 4, false }, { "uint", 4, false }, { "unsigned int", 4, false },
+  { "long", 8, false }, { "ulong", 8, false }, { "unsigned long", 8, false },
+  { "half", 2, true }, { "float", 4, true }, { "double", 8, true }
+};
+
+// nullptr for typedefs and other types which can't be resolved here
+const ScalarType* FindScalarType(const char* name) {
+  for (const ScalarType& type : kScalarTypes) {
+    if (std::strcmp(type.name, name) == 0) return &type;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+cl::Event EnqueueKernel(const cl::CommandQueue& queue,
+                        const cl::Kernel& kernel, const Grid& grid,
+                        const WaitList& events) {
+  // the same call as cl::CommandQueue::enqueueNDRangeKernel() without
+  // std::vector wait list
+  const cl::NDRange& offset = grid.offset();
+  const cl::NDRange& local = grid.local();
+  cl::Event event;
+  cl_int err = clEnqueueNDRangeKernel(
+      queue(), kernel(), grid.global().dimensions(),
+      offset.dimensions() != 0 ? static_cast<const size_t*>(offset) : nullptr,
+      static_cast<const size_t*>(grid.global()),
+      local.dimensions() != 0 ? static_cast<const size_t*>(local) : nullptr,
+      events.size(), events.data(), &event());
+  if (err != CL_SUCCESS) throw cl::Error(err, "clEnqueueNDRangeKernel");
+  return event;
+}
+
+void CheckKernelArgs(const cl::Kernel& kernel, const ArgKind* kinds,
+                     const char* const* type_names, size_t count) {
+  if (kernel.getInfo<CL_KERNEL_NUM_ARGS>() != count)
+    throw cl::Error(CL_INVALID_KERNEL_ARGS,
+                    "CheckKernelArgs: wrong number of kernel arguments");
+#ifdef CL_VERSION_1_2
+  for (size_t i = 0; i < count; ++i) {
+    cl_uint index = static_cast<cl_uint>(i);
+    cl_kernel_arg_address_qualifier address = 0;
+    cl_int err = clGetKernelArgInfo(kernel(), index,
+                                    CL_KERNEL_ARG_ADDRESS_QUALIFIER,
+                                    sizeof(address), &address, nullptr);
+    // argument info isn't kept by program or isn't supported by device
+    if (err != CL_SUCCESS) return;
+
+    bool matches = false;
+    switch (kinds[i]) {
+      case ArgKind::Buffer:
+      case ArgKind::Svm:
+        matches = address == CL_KERNEL_ARG_ADDRESS_GLOBAL ||
+                  address == CL_KERNEL_ARG_ADDRESS_CONSTANT;
+        break;
+      case ArgKind::Local:
+        matches = address == CL_KERNEL_ARG_ADDRESS_LOCAL;
+        break;
+      case ArgKind::Scalar:
+        matches = address == CL_KERNEL_ARG_ADDRESS_PRIVATE;
+        break;
+    }
+    if (!matches)
+      throw cl::Error(CL_INVALID_KERNEL_ARGS,
+                      "CheckKernelArgs: wrong address space of argument");
+
+    if (kinds[i] != ArgKind::Scalar || type_names[i] == nullptr) continue;
+    char type_name[64] = {0};
+    err = clGetKernelArgInfo(kernel(), index, CL_KERNEL_ARG_TYPE_NAME,
+                             sizeof(type_name) - 1, type_name, nullptr);
+    if (err != CL_SUCCESS) continue;
+    // type name of typedef'd parameter (e.g. real_t) isn't resolved by
+    // argument info, so only builtin types are compared by size and kind
+    const ScalarType* expected = FindScalarType(type_names[i]);
+    const ScalarType* actual = FindScalarType(type_name);
+    if (expected != nullptr && actual != nullptr &&
+        (expected->size != actual->size ||
+         expected->floating != actual->floating))
+      throw cl::Error(CL_INVALID_KERNEL_ARGS,
+                      "CheckKernelArgs: wrong type of scalar argument");
+  }
+#else
+  (void)kinds;
+  (void)type_names;
+#endif  // CL_VERSION_1_2
+}
+
+}  // namespace oclalgo
@@ -0,0 +1,100 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file arena.cc
+ *  @brief Unit tests for oclalgo::ScopedArena class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/arena.h"
+#include "inc/oclalgo/matrix.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::Matrix;
+using oclalgo::ScopedArena;
+
+TEST(ScopedArena, Allocate) {
+  ScopedArena arena(256);
+  EXPECT_EQ(&arena, ScopedArena::active());
+  char* a = static_cast<char*>(arena.Allocate(100, 64));
+  char* b = static_cast<char*>(arena.Allocate(1000, 64));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a) % 64);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(b) % 64);
+  EXPECT_EQ(1100u, arena.used_bytes());
+  size_t reserved = arena.reserved_bytes();
+
+  // memory is reused after reset
+  arena.Reset();
+  arena.Allocate(100, 64);
+  arena.Allocate(1000, 64);
+  EXPECT_EQ(reserved, arena.reserved_bytes());
+  {
+    ScopedArena nested;
+    EXPECT_EQ(&nested, ScopedArena::active());
+  }
+  EXPECT_EQ(&arena, ScopedArena::active());
+}
+
+TEST(ScopedArena, MatrixOperators) {
+  int rows = 64, cols = 32;
+  Matrix<int> m1(rows, cols), m2(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m1(i, j) = i * cols + j;
+      m2(i, j) = i - j;
+    }
+  }
+
+  Matrix<int> res;
+  {
+    ScopedArena arena;
+    Matrix<int> sum = m1 + m2;
+    Matrix<int> diff = sum - m2;
+    diff.transpose();
+    Matrix<int> prod = m1 * diff;
+    // data of diff before transposition is already released
+    EXPECT_EQ(3u, arena.live_arrays());
+    EXPECT_LE(4 * rows * cols * sizeof(int), arena.used_bytes());
+    diff.transpose();
+    res = diff;
+  }
+  EXPECT_EQ(nullptr, ScopedArena::active());
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      ASSERT_EQ(m1(i, j), res(i, j));
+}
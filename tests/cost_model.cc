@@ -0,0 +1,130 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file cost_model.cc
+ *  @brief Unit tests for oclalgo::CostModel class and profile files.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/cost_model.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::CostModel;
+using oclalgo::DeviceProfile;
+using oclalgo::Operation;
+using oclalgo::OperationCost;
+using oclalgo::Target;
+
+namespace {
+
+DeviceProfile Profile() {
+  DeviceProfile profile;
+  profile.device = "Test Device";
+  profile.upload_bandwidth = 4e9;
+  profile.download_bandwidth = 2e9;
+  profile.launch_latency = 1e-4;
+  profile.device_rate[0] = 1e11;
+  profile.host_rate[0] = 1e9;
+  return profile;
+}
+
+OperationCost Product(int n) {
+  OperationCost cost = {1.0 * n * n * n, 8UL * n * n, 4UL * n * n};
+  return cost;
+}
+
+}  // namespace
+
+TEST(CostModel, Choose) {
+  CostModel model(Profile());
+  // 8^3 multiply-adds take 0.5 us on host, latency alone is 100 us
+  EXPECT_EQ(Target::Host, model.Choose(Operation::Multiply, Product(8)));
+  EXPECT_EQ(Target::Device, model.Choose(Operation::Multiply, Product(512)));
+  EXPECT_DOUBLE_EQ(1e-4 + 8.0 * 64 / 4e9 + 4.0 * 64 / 2e9 + 512 / 1e11,
+                   model.Predict(Target::Device, Operation::Multiply,
+                                 Product(8)));
+  EXPECT_DOUBLE_EQ(512 / 1e9, model.Predict(Target::Host, Operation::Multiply,
+                                            Product(8)));
+}
+
+TEST(CostModel, Record) {
+  CostModel model(Profile(), 0.5);
+  // host is twice as fast as profile says
+  model.Record(Target::Host, Operation::Multiply, Product(100), 0.5e-3);
+  EXPECT_DOUBLE_EQ(1.5e9, model.profile().host_rate[0]);
+
+  // large product refines device rate
+  OperationCost large = Product(2048);
+  double overhead = 1e-4 + large.bytes_in / 4e9 + large.bytes_out / 2e9;
+  model.Record(Target::Device, Operation::Multiply, large,
+               overhead + large.work / 3e11);
+  EXPECT_DOUBLE_EQ(2e11, model.profile().device_rate[0]);
+
+  // small product refines latency
+  OperationCost small = Product(4);
+  double transfer = small.bytes_in / 4e9 + small.bytes_out / 2e9;
+  model.Record(Target::Device, Operation::Multiply, small,
+               3e-4 + transfer + small.work / 2e11);
+  EXPECT_NEAR(2e-4, model.profile().launch_latency, 1e-12);
+
+  // bad timings are ignored
+  model.Record(Target::Host, Operation::Multiply, Product(10), 0);
+  EXPECT_DOUBLE_EQ(1.5e9, model.profile().host_rate[0]);
+}
+
+TEST(CostModel, Profile) {
+  std::string path = "/tmp/oclalgo_test_profile";
+  DeviceProfile profile = Profile();
+  ASSERT_TRUE(oclalgo::SaveProfile(path, profile));
+  DeviceProfile loaded;
+  ASSERT_TRUE(oclalgo::LoadProfile(path, &loaded));
+  EXPECT_EQ("Test Device", loaded.device);
+  EXPECT_EQ(profile.upload_bandwidth, loaded.upload_bandwidth);
+  EXPECT_EQ(profile.launch_latency, loaded.launch_latency);
+  EXPECT_EQ(profile.device_rate[0], loaded.device_rate[0]);
+  EXPECT_EQ(profile.host_rate[1], loaded.host_rate[1]);
+
+  std::ofstream(path) << "device Test Device\nlaunch_latency -1\n";
+  EXPECT_FALSE(oclalgo::LoadProfile(path, &loaded));
+  std::remove(path.c_str());
+  EXPECT_FALSE(oclalgo::LoadProfile(path, &loaded));
+}
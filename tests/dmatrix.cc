@@ -40,6 +40,9 @@
  *  Copyright 2013 Samsung R&D Institute Russia
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include <gtest/gtest.h>
 #include "inc/oclalgo/dmatrix.h"
 #include "inc/oclalgo/matrix.h"
@@ -152,6 +155,45 @@ TEST(DMatrix, UpdateData) {
       ASSERT_EQ(m2(i, j), res2(i, j));
 }
 
+TEST(DMatrix, UpdateFromView) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  int rows = 512, cols = 256;
+  Matrix<int> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = i * cols + j;
+
+  // strided rows, contiguous rows and column-major view
+  DMatrix<int> dm(m.block(8, 16, 100, 200));
+  Matrix<int> res1 = dm.ToHost();
+  dm = dm.UpdateData(m.block(100, 0, 50, cols),
+                     oclalgo::BlockingType::Unblock).get();
+  Matrix<int> res2 = dm.ToHost();
+  dm.UpdateData(m.view().transposed());
+  Matrix<int> res3 = dm.ToHost();
+
+  ASSERT_EQ(100, res1.rows());
+  for (int i = 0; i < res1.rows(); ++i)
+    for (int j = 0; j < res1.cols(); ++j)
+      ASSERT_EQ(m(i + 8, j + 16), res1(i, j));
+  ASSERT_EQ(50, res2.rows());
+  for (int i = 0; i < res2.rows(); ++i)
+    for (int j = 0; j < res2.cols(); ++j)
+      ASSERT_EQ(m(i + 100, j), res2(i, j));
+  ASSERT_EQ(cols, res3.rows());
+  for (int i = 0; i < res3.rows(); ++i)
+    for (int j = 0; j < res3.cols(); ++j)
+      ASSERT_EQ(m(j, i), res3(i, j));
+
+  // empty spans are uploaded without commands
+  DMatrix<int> empty(m.block(0, 0, 0, cols));
+  empty = empty.UpdateData(m.block(7, 0, 1, 0),
+                           oclalgo::BlockingType::Unblock).get();
+  EXPECT_EQ(1, empty.rows());
+  EXPECT_EQ(0, empty.cols());
+}
+
 TEST(DMatrix, Add) {
   using oclalgo::Matrix;
   using oclalgo::DMatrix;
@@ -261,3 +303,248 @@ TEST(DMatrix, MulFloat) {
     for (int j = 0; j < res.cols(); ++j)
       ASSERT_EQ(gold_res[i * res.cols() + j], res(i, j));
 }
+
+TEST(DMatrix, MulDevice) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  using oclalgo::KernelShape;
+  // dimensions aren't multiples of work-group size
+  Matrix<int> m1(37, 50), m2(50, 45);
+  for (int i = 0; i < m1.rows(); ++i)
+    for (int j = 0; j < m1.cols(); ++j)
+      m1(i, j) = (i + 2 * j) % 7 - 3;
+  for (int i = 0; i < m2.rows(); ++i)
+    for (int j = 0; j < m2.cols(); ++j)
+      m2(i, j) = (3 * i + j) % 5 - 2;
+  Matrix<int> gold = m1 * m2;
+
+  DMatrix<int> dm1(m1), dm2(m2);
+  Matrix<int> res = (dm1 * dm2).get().ToHost();
+  Matrix<int> res_fixed = Multiply(dm1, dm2, KernelShape::Fixed).get().ToHost();
+  ASSERT_EQ(gold.rows(), res.rows());
+  ASSERT_EQ(gold.cols(), res.cols());
+  for (int i = 0; i < gold.rows(); ++i) {
+    for (int j = 0; j < gold.cols(); ++j) {
+      ASSERT_EQ(gold(i, j), res(i, j));
+      ASSERT_EQ(gold(i, j), res_fixed(i, j));
+    }
+  }
+}
+
+TEST(DMatrix, Elementwise) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  // number of elements isn't a multiple of vector width
+  int rows = 37, cols = 29;
+  Matrix<float> m1(rows, cols), m2(rows, cols), m3(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m1(i, j) = i - j * 0.5F;
+      m2(i, j) = j + 1.0F;
+      m3(i, j) = i * 0.25F;
+    }
+  }
+  DMatrix<float> dm1(m1), dm2(m2), dm3(m3);
+  Matrix<float> scale = Scale(dm1, 2.0F).get().ToHost();
+  Matrix<float> axpy = Axpy(3.0F, dm1, dm2).get().ToHost();
+  Matrix<float> mul = ElementwiseMul(dm1, dm2).get().ToHost();
+  Matrix<float> div = ElementwiseDiv(dm1, dm2).get().ToHost();
+  Matrix<float> min = ElementwiseMin(dm1, dm2).get().ToHost();
+  Matrix<float> max = ElementwiseMax(dm1, dm2).get().ToHost();
+  Matrix<float> muladd = MulAdd(dm1, dm2, dm3).get().ToHost();
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      float a = m1(i, j), b = m2(i, j), c = m3(i, j);
+      ASSERT_FLOAT_EQ(2.0F * a, scale(i, j));
+      ASSERT_FLOAT_EQ(3.0F * a + b, axpy(i, j));
+      ASSERT_FLOAT_EQ(a * b, mul(i, j));
+      ASSERT_FLOAT_EQ(a / b, div(i, j));
+      ASSERT_FLOAT_EQ(std::min(a, b), min(i, j));
+      ASSERT_FLOAT_EQ(std::max(a, b), max(i, j));
+      ASSERT_FLOAT_EQ(a * b + c, muladd(i, j));
+    }
+  }
+}
+
+TEST(DMatrix, Broadcast) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  using oclalgo::ElementOp;
+  int rows = 67, cols = 300;
+  Matrix<int> m(rows, cols), row(1, cols), col(rows, 1);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = i * cols + j;
+  for (int j = 0; j < cols; ++j)
+    row(0, j) = j % 13;
+  for (int i = 0; i < rows; ++i)
+    col(i, 0) = i + 1;
+
+  DMatrix<int> dm(m), drow(row), dcol(col);
+  Matrix<int> add_row =
+      MapBroadcast(ElementOp::Add, 0, dm, drow).get().ToHost();
+  Matrix<int> mul_col =
+      MapBroadcast(ElementOp::Mul, 0, dm, dcol).get().ToHost();
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      ASSERT_EQ(m(i, j) + row(0, j), add_row(i, j));
+      ASSERT_EQ(m(i, j) * col(i, 0), mul_col(i, j));
+    }
+  }
+}
+
+TEST(DMatrix, Reduce) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  using oclalgo::ReduceOp;
+  int rows = 45, cols = 700;
+  Matrix<float> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = ((i * 7 + j * 3) % 19) - 9.0F;
+  DMatrix<float> dm(m);
+
+  Matrix<float> row_sum = ReduceRows(dm, ReduceOp::Sum).get().ToHost();
+  Matrix<float> row_max = ReduceRows(dm, ReduceOp::Max).get().ToHost();
+  Matrix<float> row_norm = ReduceRows(dm, ReduceOp::Norm).get().ToHost();
+  ASSERT_EQ(rows, row_sum.rows());
+  ASSERT_EQ(1, row_sum.cols());
+  for (int i = 0; i < rows; ++i) {
+    float sum = 0.0F, max = m(i, 0), sq = 0.0F;
+    for (int j = 0; j < cols; ++j) {
+      sum += m(i, j);
+      max = std::max(max, m(i, j));
+      sq += m(i, j) * m(i, j);
+    }
+    EXPECT_NEAR(sum, row_sum(i, 0), 1e-2);
+    EXPECT_EQ(max, row_max(i, 0));
+    EXPECT_NEAR(std::sqrt(sq), row_norm(i, 0), 1e-2);
+  }
+
+  Matrix<float> col_mean = ReduceCols(dm, ReduceOp::Mean).get().ToHost();
+  Matrix<float> col_min = ReduceCols(dm, ReduceOp::Min).get().ToHost();
+  ASSERT_EQ(1, col_mean.rows());
+  ASSERT_EQ(cols, col_mean.cols());
+  for (int j = 0; j < cols; ++j) {
+    float sum = 0.0F, min = m(0, j);
+    for (int i = 0; i < rows; ++i) {
+      sum += m(i, j);
+      min = std::min(min, m(i, j));
+    }
+    EXPECT_NEAR(sum / rows, col_mean(0, j), 1e-4);
+    EXPECT_EQ(min, col_min(0, j));
+  }
+}
+
+TEST(DMatrix, Softmax) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  // short rows are packed into one work-group, long rows aren't
+  int shapes[][2] = { { 50, 10 }, { 7, 1000 } };
+  for (auto shape : shapes) {
+    int rows = shape[0], cols = shape[1];
+    Matrix<float> m(rows, cols);
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j)
+        m(i, j) = ((i * 5 + j * 3) % 23) * 4.0F - 40.0F;
+    DMatrix<float> dm(m);
+    Matrix<float> sm = Softmax(dm).get().ToHost();
+    Matrix<float> lsm = LogSoftmax(dm).get().ToHost();
+    for (int i = 0; i < rows; ++i) {
+      float max = m(i, 0), sum = 0.0F;
+      for (int j = 0; j < cols; ++j)
+        max = std::max(max, m(i, j));
+      for (int j = 0; j < cols; ++j)
+        sum += std::exp(m(i, j) - max);
+      for (int j = 0; j < cols; ++j) {
+        ASSERT_NEAR(std::exp(m(i, j) - max) / sum, sm(i, j), 1e-5);
+        ASSERT_NEAR(m(i, j) - max - std::log(sum), lsm(i, j), 1e-3);
+      }
+    }
+  }
+}
+
+TEST(DMatrix, LayerNorm) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  int shapes[][2] = { { 33, 24 }, { 5, 777 } };
+  for (auto shape : shapes) {
+    int rows = shape[0], cols = shape[1];
+    Matrix<float> m(rows, cols), gamma(1, cols), beta(1, cols);
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j)
+        m(i, j) = ((i * 7 + j * 11) % 17) * 0.5F + i;
+    for (int j = 0; j < cols; ++j) {
+      gamma(0, j) = 1.0F + (j % 3) * 0.5F;
+      beta(0, j) = (j % 5) * 0.1F;
+    }
+    DMatrix<float> dm(m), dgamma(gamma), dbeta(beta);
+    Matrix<float> res = LayerNorm(dm, dgamma, dbeta, 1e-5F).get().ToHost();
+    for (int i = 0; i < rows; ++i) {
+      double mean = 0.0, var = 0.0;
+      for (int j = 0; j < cols; ++j)
+        mean += m(i, j);
+      mean /= cols;
+      for (int j = 0; j < cols; ++j)
+        var += (m(i, j) - mean) * (m(i, j) - mean);
+      var /= cols;
+      for (int j = 0; j < cols; ++j) {
+        double gold = (m(i, j) - mean) / std::sqrt(var + 1e-5) * gamma(0, j) +
+                      beta(0, j);
+        ASSERT_NEAR(gold, res(i, j), 1e-4);
+      }
+    }
+  }
+}
+
+TEST(DMatrix, Empty) {
+  using oclalgo::DMatrix;
+  using oclalgo::ElementOp;
+  using oclalgo::ReduceOp;
+  // results of empty matrices are ready without enqueued kernels
+  DMatrix<float> m(0, 3), row(1, 3), gamma(1, 3), beta(1, 3);
+  DMatrix<float> sum = (m + m).get();
+  EXPECT_EQ(0, sum.rows());
+  EXPECT_EQ(3, sum.cols());
+  EXPECT_EQ(0, MapBroadcast(ElementOp::Add, 0.0F, m, row).get().rows());
+  DMatrix<float> row_sum = ReduceRows(m, ReduceOp::Sum).get();
+  EXPECT_EQ(0, row_sum.rows());
+  EXPECT_EQ(1, row_sum.cols());
+  DMatrix<float> transposed(3, 0);
+  DMatrix<float> col_sum = ReduceCols(transposed, ReduceOp::Sum).get();
+  EXPECT_EQ(1, col_sum.rows());
+  EXPECT_EQ(0, col_sum.cols());
+  EXPECT_EQ(0, Softmax(m).get().rows());
+  EXPECT_EQ(0, LayerNorm(m, gamma, beta).get().rows());
+  DMatrix<float> product = (m * transposed).get();
+  EXPECT_EQ(0, product.rows());
+  EXPECT_EQ(0, product.cols());
+}
+
+TEST(DMatrix, ScratchPool) {
+  using oclalgo::Matrix;
+  using oclalgo::DMatrix;
+  using oclalgo::ScopedScratch;
+  int rows = 256, cols = 128;
+  Matrix<int> m1(rows, cols), m2(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m1(i, j) = i * cols + j;
+      m2(i, j) = cols * rows - i * cols - j;
+    }
+  }
+
+  DMatrix<int> dm1(m1), dm2(m2);
+  Matrix<int> res;
+  {
+    ScopedScratch scratch(oclalgo::MatrixQueue::instance(), 1 << 20);
+    DMatrix<int> dsum = (dm1 + dm2).get();
+    DMatrix<int> ddiff = (dsum - dm2).get();
+    EXPECT_EQ(2 * rows * cols * sizeof(int), scratch.used_bytes());
+    EXPECT_EQ(0u, scratch.overflow_bytes());
+    res = ddiff.ToHost();
+  }
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      ASSERT_EQ(m1(i, j), res(i, j));
+}
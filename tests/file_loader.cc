@@ -0,0 +1,113 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file file_loader.cc
+ *  @brief Unit tests for oclalgo::FileLoader class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/dmatrix.h"
+#include "inc/oclalgo/file_loader.h"
+#include "src/gtest_main.cc"
+
+namespace {
+
+// writes <count> floats i * 0.5 to temporary file
+std::string WriteFile(size_t count) {
+  char path[] = "/tmp/oclalgo_loaderXXXXXX";
+  int fd = mkstemp(path);
+  std::vector<float> data(count);
+  for (size_t i = 0; i < count; ++i)
+    data[i] = i * 0.5F;
+  EXPECT_EQ(static_cast<ssize_t>(count * sizeof(float)),
+            write(fd, data.data(), count * sizeof(float)));
+  close(fd);
+  return path;
+}
+
+}  // namespace
+
+TEST(FileLoader, Matrix) {
+  int rows = 123, cols = 77;
+  std::string path = WriteFile(rows * cols + 10);
+  oclalgo::Queue* queue = oclalgo::MatrixQueue::instance();
+  oclalgo::FileLoaderOptions options;
+  options.chunk_size = 1000;  // chunks split floats
+  options.staging_buffers = 3;
+  options.threads = 3;
+  oclalgo::FileLoader loader(queue, options);
+
+  oclalgo::DMatrix<float> m(rows, cols);
+  oclalgo::FileLoad load = loader.Load(path, m, 10 * sizeof(float));
+  EXPECT_EQ(rows * cols * sizeof(float), load.size());
+  EXPECT_EQ(static_cast<int>((load.size() + 999) / 1000), load.chunks());
+  load.chunk(0).wait();
+  EXPECT_GE(load.uploaded(), 1000U);
+  load.done().get();
+  EXPECT_EQ(load.size(), load.uploaded());
+  EXPECT_TRUE(load.error().empty());
+
+  oclalgo::Matrix<float> host = m.ToHost();
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      ASSERT_FLOAT_EQ((i * cols + j + 10) * 0.5F, host(i, j));
+  std::remove(path.c_str());
+}
+
+TEST(FileLoader, Errors) {
+  oclalgo::Queue* queue = oclalgo::MatrixQueue::instance();
+  oclalgo::FileLoader loader(queue);
+  oclalgo::DMatrix<float> m(10, 10);
+  EXPECT_THROW(loader.Load("/nonexistent/oclalgo.bin", m),
+               std::system_error);
+  std::string path = WriteFile(50);
+  EXPECT_THROW(loader.Load(path, m), std::system_error);
+
+  // empty load is done immediately
+  oclalgo::FileLoad load = loader.Load(path, m.buffer(), 0);
+  EXPECT_EQ(0, load.chunks());
+  load.done().wait();
+  std::remove(path.c_str());
+}
@@ -0,0 +1,98 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file fixed_matrix.cc
+ *  @brief Unit tests for oclalgo::FixedMatrix class.
+ *  @author Dmitry Senin <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "inc/oclalgo/fixed_matrix.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::FixedMatrix;
+using oclalgo::Matrix;
+
+TEST(FixedMatrix, Operations) {
+  typedef FixedMatrix<int, 3, 4> Matrix3x4;
+  typedef FixedMatrix<int, 4, 3> Matrix4x3;
+  typedef FixedMatrix<int, 3, 2> Matrix3x2;
+  Matrix3x4 a;
+  FixedMatrix<int, 4, 2> b;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+      a(i, j) = i * 4 + j;
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 2; ++j)
+      b(i, j) = i - 2 * j;
+
+  // results are compared with dynamic matrix operations
+  Matrix<int> ma = a.ToMatrix(), mb = b.ToMatrix();
+  Matrix3x2 prod = a * b;
+  Matrix<int> gold_prod = ma * mb;
+  EXPECT_EQ(Matrix3x2(gold_prod), prod);
+  EXPECT_EQ(Matrix3x4(ma + ma), a + a);
+  EXPECT_EQ(Matrix3x4(0), a - a);
+  EXPECT_EQ(a + a, 2 * a);
+  EXPECT_EQ(Matrix4x3(ma.view().transposed()), a.transposed());
+
+  FixedMatrix<float, 4, 4> eye = FixedMatrix<float, 4, 4>::Identity();
+  FixedMatrix<float, 4, 4> m(0.5f);
+  EXPECT_EQ(m, m * eye);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(m.data()) % 16);
+  static_assert(sizeof(FixedMatrix<float, 3, 3>) == 9 * sizeof(float),
+                "fixed matrix mustn't have overhead");
+}
+
+TEST(FixedMatrix, Batch) {
+  size_t count = 1000;
+  std::vector<FixedMatrix<float, 3, 3>> batch(count);
+  for (size_t n = 0; n < count; ++n)
+    for (int k = 0; k < 9; ++k)
+      batch[n].data()[k] = n * 9 + k;
+
+  Matrix<float> packed(oclalgo::BatchSpan(batch.data(), count));
+  ASSERT_EQ(static_cast<int>(count), packed.rows());
+  ASSERT_EQ(9, packed.cols());
+  EXPECT_EQ(batch[17](2, 1), packed(17, 7));
+
+  std::vector<FixedMatrix<float, 3, 3>> unpacked(count);
+  oclalgo::UnpackBatch(packed.view(), unpacked.data());
+  for (size_t n = 0; n < count; ++n)
+    ASSERT_EQ(batch[n], unpacked[n]);
+}
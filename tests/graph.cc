@@ -0,0 +1,168 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file graph.cc
+ *  @brief Unit tests for oclalgo::CsrGraph, BFS and PageRank.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/graph.h"
+#include "src/gtest_main.cc"
+
+namespace {
+
+typedef std::vector<std::pair<int, int>> Edges;
+
+// undirected n x n grid with a few long edges and an isolated last vertex
+Edges Grid2D(int n) {
+  Edges edges;
+  auto add = [&edges](int a, int b) {
+    edges.emplace_back(a, b);
+    edges.emplace_back(b, a);
+  };
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      if (j + 1 < n) add(i * n + j, i * n + j + 1);
+      if (i + 1 < n) add(i * n + j, (i + 1) * n + j);
+    }
+  }
+  for (int v = 0; v + 97 < n * n; v += 97)
+    add(v, v + 97);
+  return edges;
+}
+
+std::vector<int> HostBfs(int vertices, const Edges& edges, int source) {
+  std::vector<std::vector<int>> adjacency(vertices);
+  for (const auto& e : edges)
+    adjacency[e.first].push_back(e.second);
+  std::vector<int> levels(vertices, -1);
+  std::queue<int> frontier;
+  levels[source] = 0;
+  frontier.push(source);
+  while (!frontier.empty()) {
+    int v = frontier.front();
+    frontier.pop();
+    for (int u : adjacency[v]) {
+      if (levels[u] == -1) {
+        levels[u] = levels[v] + 1;
+        frontier.push(u);
+      }
+    }
+  }
+  return levels;
+}
+
+void CheckBfs(oclalgo::BfsDirection direction) {
+  int n = 40, vertices = n * n + 1;
+  Edges edges = Grid2D(n);
+  oclalgo::CsrGraph graph = oclalgo::CsrGraph::FromEdges(vertices, edges);
+  oclalgo::BfsOptions options;
+  options.direction = direction;
+  oclalgo::BfsResult result = oclalgo::BreadthFirstSearch(graph, 5, options);
+
+  std::vector<int> expected = HostBfs(vertices, edges, 5);
+  std::vector<int> levels(vertices);
+  oclalgo::MatrixQueue::instance()->queue().enqueueReadBuffer(
+      result.levels, CL_TRUE, 0, vertices * sizeof(int), levels.data());
+  EXPECT_EQ(expected, levels);
+  EXPECT_EQ(vertices - 1, result.reached);
+  EXPECT_EQ(*std::max_element(expected.begin(), expected.end()) + 1,
+            result.depth);
+  if (direction == oclalgo::BfsDirection::TopDown) {
+    EXPECT_EQ(0, result.bottom_up_steps);
+  } else if (direction == oclalgo::BfsDirection::BottomUp) {
+    EXPECT_EQ(0, result.top_down_steps);
+  }
+}
+
+}  // namespace
+
+TEST(Graph, BfsTopDown) {
+  CheckBfs(oclalgo::BfsDirection::TopDown);
+}
+
+TEST(Graph, BfsBottomUp) {
+  CheckBfs(oclalgo::BfsDirection::BottomUp);
+}
+
+TEST(Graph, BfsAuto) {
+  CheckBfs(oclalgo::BfsDirection::Auto);
+}
+
+TEST(Graph, PageRank) {
+  // directed graph with a dangling vertex 4
+  int vertices = 5;
+  Edges edges = {{0, 1}, {0, 2}, {1, 2}, {2, 0}, {3, 2}, {3, 4}, {1, 4}};
+  oclalgo::CsrGraph graph = oclalgo::CsrGraph::FromEdges(vertices, edges);
+  oclalgo::PageRankOptions options;
+  options.tolerance = 1e-10;
+  options.max_iterations = 500;
+  oclalgo::PageRankResult<double> result =
+      oclalgo::PageRank<double>(graph, options);
+  EXPECT_TRUE(result.converged);
+
+  // power iteration on host
+  std::vector<int> degree(vertices, 0);
+  for (const auto& e : edges)
+    ++degree[e.first];
+  std::vector<double> rank(vertices, 1.0 / vertices);
+  for (int it = 0; it < 500; ++it) {
+    double dangling = 0.0;
+    for (int v = 0; v < vertices; ++v)
+      if (degree[v] == 0) dangling += rank[v];
+    std::vector<double> next(vertices, (1.0 - options.damping +
+                                        options.damping * dangling) /
+                                       vertices);
+    for (const auto& e : edges)
+      next[e.second] += options.damping * rank[e.first] / degree[e.first];
+    rank = next;
+  }
+  oclalgo::Matrix<double> ranks = result.ranks.ToHost();
+  double sum = 0.0;
+  for (int v = 0; v < vertices; ++v) {
+    EXPECT_NEAR(rank[v], ranks(v, 0), 1e-8);
+    sum += ranks(v, 0);
+  }
+  EXPECT_NEAR(1.0, sum, 1e-9);
+}
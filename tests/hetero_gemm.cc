@@ -0,0 +1,132 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file hetero_gemm.cc
+ *  @brief Unit tests for oclalgo::HeteroGemm class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/hetero_gemm.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::DMatrix;
+using oclalgo::HeteroGemm;
+using oclalgo::Matrix;
+
+namespace {
+
+Matrix<float> Sample(int rows, int cols, int seed) {
+  Matrix<float> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = static_cast<float>((i * 7 + j * 3 + seed) % 11) - 5.0f;
+  return m;
+}
+
+// products of small integers are exact in float
+void ExpectProduct(const Matrix<float>& a, const Matrix<float>& b,
+                   const Matrix<float>& c) {
+  Matrix<float> expected = a * b;
+  ASSERT_EQ(expected.rows(), c.rows());
+  ASSERT_EQ(expected.cols(), c.cols());
+  for (int i = 0; i < c.rows(); ++i)
+    for (int j = 0; j < c.cols(); ++j)
+      ASSERT_EQ(expected(i, j), c(i, j)) << i << ", " << j;
+}
+
+}  // namespace
+
+TEST(HeteroGemm, HostGemm) {
+  Matrix<float> a = Sample(37, 53, 1), b = Sample(53, 29, 2);
+  Matrix<float> c(37, 29);
+  oclalgo::internal::HostGemm(a.data().get_raw(), b.data().get_raw(),
+                              c.data().get_raw(), 37, 53, 29);
+  ExpectProduct(a, b, c);
+}
+
+TEST(HeteroGemm, Split) {
+  // all shares including host-only and device-only products
+  for (double share : std::vector<double>{0.0, 0.3, 0.7, 1.0}) {
+    HeteroGemm<float> gemm(share);
+    Matrix<float> a = Sample(200, 70, 3), b = Sample(70, 90, 4);
+    ExpectProduct(a, b, gemm.Multiply(a, b).get());
+    DMatrix<float> da(a), db(b);
+    ExpectProduct(a, b, gemm.Multiply(da, db).get().ToHost());
+  }
+  // device panel is rounded to work-group rows
+  HeteroGemm<float> gemm(0.5);
+  EXPECT_EQ(100 - 2 * oclalgo::MatrixQueue::block_size, gemm.HostRows(100));
+  EXPECT_EQ(10, gemm.HostRows(10));
+}
+
+TEST(HeteroGemm, Adapts) {
+  // host panel is 3 times faster: share moves toward 0.75 by smoothing
+  auto split = std::make_shared<oclalgo::internal::GemmSplit>();
+  split->host_share = 0.5;
+  split->smoothing = 0.5;
+  for (double expected : { 0.625, 0.6875 }) {
+    oclalgo::internal::GemmCall<float> call(split, 3.0, 1.0);
+    call.Finish(oclalgo::Target::Host, 1.0);
+    call.Finish(oclalgo::Target::Device, 1.0);
+    EXPECT_DOUBLE_EQ(expected, split->host_share);
+  }
+  // failed or empty panel doesn't change split
+  oclalgo::internal::GemmCall<float> call(split, 1.0, 1.0);
+  call.Finish(oclalgo::Target::Host, 1.0);
+  call.Finish(oclalgo::Target::Device, 0.0);
+  EXPECT_DOUBLE_EQ(0.6875, split->host_share);
+
+  HeteroGemm<float> gemm(0.5);
+  Matrix<float> a = Sample(512, 256, 5), b = Sample(256, 256, 6);
+  for (int i = 0; i < 4; ++i)
+    gemm.Multiply(a, b).get();
+  EXPECT_GE(gemm.host_share(), 0.0);
+  EXPECT_LE(gemm.host_share(), 1.0);
+}
+
+TEST(HeteroGemm, Empty) {
+  HeteroGemm<float> gemm(0.5);
+  Matrix<float> a(0, 16), b = Sample(16, 8, 7);
+  EXPECT_EQ(0, gemm.Multiply(a, b).get().rows());
+  DMatrix<float> da(0, 16), db(b);
+  DMatrix<float> product = gemm.Multiply(da, db).get();
+  EXPECT_EQ(0, product.rows());
+  EXPECT_EQ(8, product.cols());
+}
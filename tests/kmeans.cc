@@ -0,0 +1,129 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file kmeans.cc
+ *  @brief Unit tests for oclalgo::KMeans class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/kmeans.h"
+#include "src/gtest_main.cc"
+
+namespace {
+
+// points of <clusters> well separated blobs, point i belongs to blob
+// i % clusters
+oclalgo::Matrix<float> Blobs(int n, int d, int clusters) {
+  oclalgo::Matrix<float> m(n, d);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < d; ++j)
+      m(i, j) = (i % clusters) * 100.0F + ((i * 31 + j * 17) % 11) * 0.1F;
+  return m;
+}
+
+void CheckClusters(const oclalgo::KMeans<float>& kmeans, int n, int d,
+                   int clusters) {
+  std::vector<int> labels(n);
+  oclalgo::MatrixQueue::instance()->queue().enqueueReadBuffer(
+      kmeans.labels(), CL_TRUE, 0, n * sizeof(int), labels.data());
+  // points of one blob have one label, different blobs - different labels
+  for (int i = 0; i < n; ++i)
+    ASSERT_EQ(labels[i % clusters], labels[i]);
+  for (int a = 0; a < clusters; ++a)
+    for (int b = a + 1; b < clusters; ++b)
+      ASSERT_NE(labels[a], labels[b]);
+
+  oclalgo::Matrix<float> centroids = kmeans.centroids().ToHost();
+  for (int c = 0; c < clusters; ++c)
+    for (int j = 0; j < d; ++j)
+      EXPECT_NEAR(c * 100.0F + 0.5F, centroids(labels[c], j), 0.5F);
+  EXPECT_LT(kmeans.inertia(), n * d * 0.5F);
+}
+
+}  // namespace
+
+TEST(KMeans, PlusPlus) {
+  int n = 3000, d = 20, clusters = 5;
+  oclalgo::Matrix<float> points = Blobs(n, d, clusters);
+  oclalgo::DMatrix<float> x(points);
+  oclalgo::KMeans<float> kmeans(clusters);
+  int iterations = kmeans.Fit(x);
+  EXPECT_GT(iterations, 0);
+  EXPECT_LE(iterations, oclalgo::KMeansOptions().max_iterations);
+  CheckClusters(kmeans, n, d, clusters);
+}
+
+TEST(KMeans, SampledPlusPlus) {
+  int n = 5000, d = 7, clusters = 4;
+  oclalgo::Matrix<float> points = Blobs(n, d, clusters);
+  oclalgo::DMatrix<float> x(points);
+  oclalgo::KMeansOptions options;
+  options.init_sample = 500;
+  options.seed = 7;
+  oclalgo::KMeans<float> kmeans(clusters, options);
+  kmeans.Fit(x);
+  CheckClusters(kmeans, n, d, clusters);
+}
+
+TEST(KMeans, Random) {
+  int n = 1000, d = 3, clusters = 3;
+  oclalgo::Matrix<float> points = Blobs(n, d, clusters);
+  oclalgo::DMatrix<float> x(points);
+  oclalgo::KMeansOptions options;
+  options.init = oclalgo::KMeansInit::Random;
+  oclalgo::KMeans<float> kmeans(clusters, options);
+  kmeans.Fit(x);
+  // random seeding can merge blobs, but inertia is consistent with labels
+  std::vector<int> labels(n);
+  oclalgo::MatrixQueue::instance()->queue().enqueueReadBuffer(
+      kmeans.labels(), CL_TRUE, 0, n * sizeof(int), labels.data());
+  oclalgo::Matrix<float> centroids = kmeans.centroids().ToHost();
+  double inertia = 0.0;
+  for (int i = 0; i < n; ++i) {
+    ASSERT_GE(labels[i], 0);
+    ASSERT_LT(labels[i], clusters);
+    for (int j = 0; j < d; ++j) {
+      double diff = points(i, j) - centroids(labels[i], j);
+      inertia += diff * diff;
+    }
+  }
+  EXPECT_NEAR(inertia, kmeans.inertia(), inertia * 1e-3 + 1e-2);
+}
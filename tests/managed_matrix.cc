@@ -0,0 +1,103 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file managed_matrix.cc
+ *  @brief Unit tests for oclalgo::ManagedMatrix class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/managed_matrix.h"
+#include "src/gtest_main.cc"
+
+TEST(ManagedMatrix, LazyTransfers) {
+  using oclalgo::Matrix;
+  using oclalgo::ManagedMatrix;
+  int rows = 256, cols = 128;
+  Matrix<int> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = i * cols + j;
+
+  ManagedMatrix<int> mm(m);
+  EXPECT_TRUE(mm.host_valid());
+  EXPECT_FALSE(mm.device_valid());
+
+  // unchanged data is uploaded only once
+  mm.device();
+  mm.device();
+  EXPECT_EQ(1U, mm.uploads());
+  EXPECT_EQ(0U, mm.downloads());
+
+  // host modification makes device copy dirty
+  mm.mutable_host()(0, 0) = -1;
+  EXPECT_FALSE(mm.device_valid());
+  Matrix<int> res = mm.device().ToHost();
+  EXPECT_EQ(2U, mm.uploads());
+  EXPECT_EQ(0U, mm.downloads());
+  EXPECT_EQ(-1, res(0, 0));
+  for (int i = 1; i < rows * cols; ++i)
+    ASSERT_EQ(m.data()[i], res.data()[i]);
+}
+
+TEST(ManagedMatrix, Add) {
+  using oclalgo::Matrix;
+  using oclalgo::ManagedMatrix;
+  using oclalgo::Residency;
+  int rows = 256, cols = 128;
+  Matrix<int> m1(rows, cols), m2(rows, cols);
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      m1(i, j) = i * cols + j;
+      m2(i, j) = cols * rows - i * cols - j;
+    }
+  }
+
+  ManagedMatrix<int> mm1(m1), mm2(m2);
+  ManagedMatrix<int> sum = mm1 + mm2;
+  ManagedMatrix<int> res = sum + mm2;
+  EXPECT_FALSE(sum.host_valid());
+  EXPECT_EQ(1U, mm2.uploads());
+
+  // only the matrix which is read on host is downloaded
+  res.Prefetch(Residency::Host);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      ASSERT_EQ(cols * rows + m2(i, j), res(i, j));
+  EXPECT_EQ(1U, res.downloads());
+  EXPECT_EQ(0U, sum.downloads());
+}
@@ -44,6 +44,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
 #include "inc/oclalgo/matrix.h"
 #include "src/gtest_main.cc"
 
@@ -215,3 +218,110 @@ TEST(Matrix, Transpose) {
     for (int j = 0; j < m1.cols(); ++j)
       ASSERT_EQ(m2(i, j), m1(i, j));
 }
+
+TEST(Matrix, ParallelOperations) {
+  using oclalgo::Matrix;
+  using oclalgo::ThreadPool;
+  // odd sizes check chunk boundaries and tails of transposition tiles
+  Matrix<int> m1(1001, 771), m2(1001, 771);
+  for (int i = 0; i < m1.rows(); ++i) {
+    for (int j = 0; j < m1.cols(); ++j) {
+      m1(i, j) = i * m1.cols() + j;
+      m2(i, j) = 3 * j - i;
+    }
+  }
+
+  // restores pool size even if an assertion returns from the test
+  struct PoolSizeGuard {
+    size_t size = ThreadPool::instance()->size();
+    ~PoolSizeGuard() { ThreadPool::instance()->resize(size); }
+  } guard;
+  for (size_t threads : { 1, 3, 8 }) {
+    ThreadPool::instance()->resize(threads);
+    Matrix<int> sum = m1 + m2, diff = m1 - m2, copy(m1);
+    copy.transpose();
+    for (int i = 0; i < m1.rows(); ++i) {
+      for (int j = 0; j < m1.cols(); ++j) {
+        ASSERT_EQ(m1(i, j) + m2(i, j), sum(i, j));
+        ASSERT_EQ(m1(i, j) - m2(i, j), diff(i, j));
+        ASSERT_EQ(m1(i, j), copy(j, i));
+      }
+    }
+  }
+}
+
+TEST(Matrix, ParallelException) {
+  using oclalgo::ThreadPool;
+  ThreadPool pool(4);
+  // every chunk throws, the pool is usable after rethrow to caller
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    EXPECT_THROW(pool.ParallelFor(4, [](size_t, size_t) {
+      throw std::runtime_error("chunk failed");
+    }), std::runtime_error);
+  }
+  std::atomic<size_t> sum(0);
+  pool.ParallelFor(1000, [&sum](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) sum += i;
+  });
+  EXPECT_EQ(999u * 1000 / 2, sum);
+}
+
+TEST(Matrix, Views) {
+  using oclalgo::Matrix;
+  using oclalgo::MatrixSpan;
+  using oclalgo::MatrixView;
+  int rows = 300, cols = 400;
+  Matrix<int> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = i * cols + j;
+
+  // blocks share matrix data
+  MatrixView<int> a = m.block(10, 20, 250, 300);
+  MatrixView<int> b = m.block(40, 90, 250, 300);
+  EXPECT_EQ(10u * cols + 20, a.offset());
+  EXPECT_EQ(cols, a.ld());
+  EXPECT_FALSE(a.contiguous());
+  a(0, 0) = -1;
+  EXPECT_EQ(-1, m(10, 20));
+  m(10, 20) = 10 * cols + 20;
+
+  Matrix<int> sum = a + b, diff = a - b, copy(a);
+  for (int i = 0; i < a.rows(); ++i) {
+    for (int j = 0; j < a.cols(); ++j) {
+      ASSERT_EQ(m(i + 10, j + 20) + m(i + 40, j + 90), sum(i, j));
+      ASSERT_EQ(m(i + 10, j + 20) - m(i + 40, j + 90), diff(i, j));
+      ASSERT_EQ(m(i + 10, j + 20), copy(i, j));
+    }
+  }
+
+  // column-major external memory and zero-copy transposition
+  std::vector<int> external(cols * rows);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      external[j * rows + i] = i * cols + j;
+  MatrixSpan<const int> col_major(external.data(), rows, cols, 0,
+                                  oclalgo::COL);
+  Matrix<int> packed(col_major.block(5, 7, 200, 100));
+  Matrix<int> transposed(m.view().transposed());
+  MatrixSpan<const int> whole(m.view());
+  Matrix<int> zero = whole - col_major;
+  for (int i = 0; i < packed.rows(); ++i)
+    for (int j = 0; j < packed.cols(); ++j)
+      ASSERT_EQ(m(i + 5, j + 7), packed(i, j));
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      ASSERT_EQ(m(i, j), transposed(j, i));
+      ASSERT_EQ(0, zero(i, j));
+    }
+  }
+
+  Matrix<int> eye(4, 4);
+  for (int i = 0; i < 4; ++i)
+    for (int j = 0; j < 4; ++j)
+      eye(i, j) = i == j;
+  Matrix<int> prod = m.block(1, 2, 3, 4) * eye.view();
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+      ASSERT_EQ(m(i + 1, j + 2), prod(i, j));
+}
@@ -0,0 +1,176 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file npy.cc
+ *  @brief Unit tests for .npy and .npz reading and writing.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/npy.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::Matrix;
+using oclalgo::MatrixView;
+
+namespace {
+
+std::string TempPath(const char* name) {
+  return std::string("/tmp/oclalgo_test_") + name;
+}
+
+Matrix<float> Sample(int rows, int cols) {
+  Matrix<float> m(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      m(i, j) = i * 10.0F + j;
+  return m;
+}
+
+}  // namespace
+
+TEST(Npy, SaveLoad) {
+  std::string path = TempPath("c.npy");
+  Matrix<float> m = Sample(5, 7);
+  oclalgo::SaveNpy(path, m);
+
+  MatrixView<float> view = oclalgo::MapNpy<float>(path);
+  EXPECT_EQ(oclalgo::ROW, view.packing());
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(view.data()) % 64);
+  Matrix<float> loaded = oclalgo::LoadNpy<float>(path);
+  ASSERT_EQ(5, loaded.rows());
+  ASSERT_EQ(7, loaded.cols());
+  for (int i = 0; i < 5; ++i)
+    for (int j = 0; j < 7; ++j) {
+      EXPECT_EQ(m(i, j), view(i, j));
+      EXPECT_EQ(m(i, j), loaded(i, j));
+    }
+  EXPECT_THROW(oclalgo::LoadNpy<double>(path), std::runtime_error);
+  EXPECT_THROW(oclalgo::LoadNpy<float>(TempPath("missing.npy")),
+               std::system_error);
+  std::remove(path.c_str());
+}
+
+TEST(Npy, FortranOrder) {
+  // array written by numpy.save(np.asfortranarray(a)) for 2 x 3 int32 a
+  std::string dict = "{'descr': '<i4', 'fortran_order': True, "
+                     "'shape': (2, 3), }";
+  dict.append(128 - 10 - dict.size() - 1, ' ');
+  dict += '\n';
+  std::string file = std::string("\x93NUMPY\x01\x00", 8);
+  file.push_back(static_cast<char>(dict.size()));
+  file.push_back(0);
+  file += dict;
+  const int data[] = {0, 3, 1, 4, 2, 5};  // columns of [[0 1 2] [3 4 5]]
+  file.append(reinterpret_cast<const char*>(data), sizeof(data));
+  std::string path = TempPath("f.npy");
+  std::ofstream(path, std::ios::binary) << file;
+
+  MatrixView<int> view = oclalgo::MapNpy<int>(path);
+  EXPECT_EQ(oclalgo::COL, view.packing());
+  Matrix<int> m = oclalgo::LoadNpy<int>(path);
+  for (int i = 0; i < 2; ++i)
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(i * 3 + j, view(i, j));
+      EXPECT_EQ(i * 3 + j, m(i, j));
+    }
+
+  // contiguous column-major span is written in Fortran order (file of
+  // mapped view isn't overwritten)
+  std::string copy = TempPath("f2.npy");
+  oclalgo::SaveNpy(copy, oclalgo::MatrixSpan<const int>(view));
+  EXPECT_EQ(oclalgo::COL, oclalgo::MapNpy<int>(copy).packing());
+  // transposed block isn't contiguous and is written in C order
+  oclalgo::SaveNpy(copy, oclalgo::MatrixSpan<const int>(
+      m.view().transposed().block(1, 0, 2, 2)));
+  MatrixView<int> block = oclalgo::MapNpy<int>(copy);
+  EXPECT_EQ(oclalgo::ROW, block.packing());
+  EXPECT_EQ(1, block(0, 0));
+  EXPECT_EQ(4, block(0, 1));
+  EXPECT_EQ(2, block(1, 0));
+  std::remove(path.c_str());
+  std::remove(copy.c_str());
+}
+
+TEST(Npy, Header) {
+  std::string header = oclalgo::internal::FormatNpyHeader("<f8", false,
+                                                          {17});
+  EXPECT_EQ(0U, header.size() % 64);
+  oclalgo::internal::NpyHeader parsed = oclalgo::internal::ParseNpyHeader(
+      header.data(), header.size(), "test");
+  EXPECT_EQ("<f8", parsed.descr);
+  EXPECT_FALSE(parsed.fortran_order);
+  ASSERT_EQ(1U, parsed.shape.size());
+  EXPECT_EQ(17U, parsed.shape[0]);
+  EXPECT_EQ(header.size(), parsed.data_offset);
+  EXPECT_EQ(std::make_pair(17, 1),
+            oclalgo::internal::NpyMatrixShape(parsed, "test"));
+  EXPECT_THROW(oclalgo::internal::ParseNpyHeader("NUMPY", 5, "test"),
+               std::runtime_error);
+  // CRC-32 check value
+  EXPECT_EQ(0xCBF43926U, oclalgo::internal::Crc32("123456789", 9));
+}
+
+TEST(Npy, Npz) {
+  std::string path = TempPath("a.npz");
+  Matrix<float> a = Sample(3, 4);
+  Matrix<double> b(2, 2);
+  b(0, 0) = 1.0; b(0, 1) = 2.0; b(1, 0) = 3.0; b(1, 1) = 4.0;
+  {
+    oclalgo::NpzWriter writer(path);
+    writer.Add("a", a);
+    writer.Add("b", b);
+  }
+  oclalgo::NpzFile npz(path);
+  ASSERT_EQ(2U, npz.names().size());
+  EXPECT_EQ("a", npz.names()[0]);
+  EXPECT_TRUE(npz.contains("b"));
+  Matrix<float> a2 = npz.Load<float>("a");
+  Matrix<double> b2 = npz.Load<double>("b");
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_EQ(a(i, j), a2(i, j));
+  EXPECT_EQ(4.0, b2(1, 1));
+  EXPECT_THROW(npz.Load<float>("c"), std::runtime_error);
+  std::remove(path.c_str());
+}
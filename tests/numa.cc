@@ -0,0 +1,92 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file numa.cc
+ *  @brief Unit tests for NUMA-aware allocation and thread placement.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/matrix.h"
+#include "inc/oclalgo/numa.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::Numa;
+using oclalgo::NumaPolicy;
+
+TEST(Numa, ParseCpuList) {
+  std::vector<int> gold = { 0, 1, 2, 3, 8, 10, 11 };
+  EXPECT_EQ(gold, Numa::ParseCpuList("0-3,8,10-11\n"));
+  EXPECT_TRUE(Numa::ParseCpuList("").empty());
+}
+
+TEST(Numa, Topology) {
+  ASSERT_GE(Numa::nodes(), 1);
+  std::vector<int> cpus = Numa::NodeOrderedCpus();
+  ASSERT_FALSE(cpus.empty());
+  EXPECT_EQ(0, Numa::NodeOfCpu(Numa::cpus(0)[0]));
+  EXPECT_EQ(-1, Numa::PciDeviceNode("ffff:ff:ff.f"));
+}
+
+TEST(Numa, Allocation) {
+  using oclalgo::Matrix;
+  int rows = 700, cols = 300;
+  NumaPolicy policies[] = { NumaPolicy::Default, NumaPolicy::Interleave,
+                            NumaPolicy::FirstTouch, NumaPolicy::Bind };
+  for (bool pinned : { false, true }) {
+    oclalgo::ThreadPool::instance()->SetPinning(pinned);
+    for (NumaPolicy policy : policies) {
+      Matrix<float> m1(rows, cols, oclalgo::MakeNumaArray<float>(
+          rows * cols, policy, 0));
+      Matrix<float> m2(rows, cols, oclalgo::MakeNumaArray<float>(
+          rows * cols, policy, 0));
+      for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+          ASSERT_EQ(0.0F, m1(i, j));
+          m1(i, j) = i;
+          m2(i, j) = j;
+        }
+      }
+      Matrix<float> sum = m1 + m2;
+      for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+          ASSERT_EQ(static_cast<float>(i + j), sum(i, j));
+    }
+  }
+}
@@ -46,9 +46,12 @@
 #include <algorithm>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "src/gtest_main.cc"
+#include "inc/oclalgo/compressed_transfer.h"
 #include "inc/oclalgo/queue.h"
 
 std::string platform_name = "NVIDIA";
@@ -105,6 +108,125 @@ TEST(Queue, VectorAdd) {
   }
 }
 
+TEST(Queue, ScalarArgs) {
+  using oclalgo::ArgType;
+  using oclalgo::BufferArg;
+  using oclalgo::KernelSignature;
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    int size = 256;
+    oclalgo::shared_array<int> a(size);
+    for (int i = 0; i < size; ++i)
+      a[i] = i;
+
+    // scalars are passed directly, signature is checked at compile time
+    BufferArg a_arg = queue.CreateKernelArg(a, ArgType::IN);
+    BufferArg c_arg = queue.CreateKernelArg<int>(size, ArgType::OUT);
+    oclalgo::Task task = queue.CreateTask("vector.cl", "vector_add_value", "",
+                                          a_arg, 101, c_arg);
+    EXPECT_EQ(1u, task.output_count());
+    oclalgo::Task checked(task.kernel(),
+                          KernelSignature<BufferArg, int, BufferArg>(),
+                          a_arg, 7, c_arg);
+    EXPECT_EQ(1u, checked.output_count());
+    queue.memcpy(a, queue.EnqueueTask(task, oclalgo::Grid(
+        cl::NDRange(size))).get()[0]);
+    for (int i = 0; i < size; ++i)
+      ASSERT_EQ(i + 101, a[i]);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
+
+TEST(Queue, TypedKernel) {
+  using oclalgo::ArgType;
+  using oclalgo::BufferArg;
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    int size = 256;
+    oclalgo::shared_array<int> a(size), c(size);
+    for (int i = 0; i < size; ++i)
+      a[i] = i;
+    BufferArg a_arg = queue.CreateKernelArg(a, ArgType::IN);
+    BufferArg c_arg = queue.CreateKernelArg<int>(size, ArgType::OUT);
+    oclalgo::Grid grid = oclalgo::Grid(cl::NDRange(size));
+
+    auto add = queue.Kernel<BufferArg, int, BufferArg>("vector.cl",
+                                                       "vector_add_value");
+    for (int k = 0; k < 3; ++k) {
+      queue.memcpy(c, add(grid, a_arg, k, c_arg).get()[0]);
+      for (int i = 0; i < size; ++i)
+        ASSERT_EQ(i + k, c[i]);
+    }
+    auto prev = add(grid, a_arg, 1, c_arg);
+    queue.memcpy(c, queue.EnqueueTask(add.task(a_arg, 2, c_arg), grid,
+                                      prev).get()[0]);
+    for (int i = 0; i < size; ++i)
+      ASSERT_EQ(i + 2, c[i]);
+
+    // typedef'd scalar parameter
+    auto sub = queue.Kernel<BufferArg, int, BufferArg>("vector.cl",
+                                                       "vector_sub_value");
+    queue.memcpy(c, sub(grid, a_arg, 3, c_arg).get()[0]);
+    for (int i = 0; i < size; ++i)
+      ASSERT_EQ(i - 3, c[i]);
+
+    // signature doesn't correspond to kernel
+    EXPECT_THROW((queue.Kernel<BufferArg, BufferArg>("vector.cl",
+                                                     "vector_add_value")),
+                 cl::Error);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
+
+TEST(Queue, TaskDependencies) {
+  using oclalgo::ArgType;
+  using oclalgo::BufferArg;
+  typedef oclalgo::future<oclalgo::TaskResult> TaskFuture;
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    int size = 256;
+    oclalgo::shared_array<int> a(size);
+    for (int i = 0; i < size; ++i)
+      a[i] = i;
+    BufferArg a_arg = queue.CreateKernelArg(a, ArgType::IN);
+    oclalgo::Grid grid = oclalgo::Grid(cl::NDRange(size));
+
+    // more dependencies than WaitList keeps inline
+    std::vector<TaskFuture> deps;
+    for (int k = 0; k < 10; ++k) {
+      BufferArg c_arg = queue.CreateKernelArg<int>(size, ArgType::OUT);
+      deps.push_back(queue.EnqueueTask(queue.CreateTask(
+          "vector.cl", "vector_add_value", "", a_arg, k, c_arg), grid));
+    }
+    BufferArg c_arg = queue.CreateKernelArg<int>(size, ArgType::OUT);
+    oclalgo::Task task = queue.CreateTask("vector.cl", "vector_add_value", "",
+                                          a_arg, 10, c_arg);
+    TaskFuture last = queue.EnqueueTask(std::move(task), grid, deps,
+                                        deps.front().event());
+    EXPECT_EQ(0u, task.output_count());
+    deps.push_back(std::move(last));
+
+    oclalgo::shared_array<int> c(size);
+    for (int k = 0; k < 11; ++k) {
+      oclalgo::TaskResult output = deps[k].get();
+      ASSERT_EQ(1u, output.size());
+      queue.memcpy(c, output[0]);
+      for (int i = 0; i < size; ++i)
+        ASSERT_EQ(i + k, c[i]);
+    }
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
+
 TEST(Queue, MatrixAdd) {
   using oclalgo::BufferType;
   using oclalgo::BufferArg;
@@ -260,3 +382,173 @@ TEST(Queue, MatrixMul_Col) {
     throw e;
   }
 }
+
+TEST(Queue, MemoryTracking) {
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    oclalgo::MemoryTracker* tracker = queue.memory_tracker();
+    size_t live = tracker->live_bytes();
+    {
+      cl::Buffer a = queue.CreateBuffer<int>(1024, CL_MEM_READ_WRITE, "a");
+      cl::Buffer b = queue.CreateBuffer<int>(2048, CL_MEM_READ_WRITE, "b");
+      EXPECT_EQ(live + 3072 * sizeof(int), tracker->live_bytes());
+      EXPECT_EQ(1024 * sizeof(int), tracker->usage("a").live);
+      EXPECT_EQ(2048 * sizeof(int), tracker->usage("b").live);
+      EXPECT_LE(live + 3072 * sizeof(int), tracker->peak_bytes());
+    }
+    EXPECT_EQ(2048 * sizeof(int), tracker->usage("b").peak);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
+
+TEST(Queue, MemoryBudget) {
+  using oclalgo::BudgetPolicy;
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    oclalgo::MemoryTracker* tracker = queue.memory_tracker();
+    size_t size = 1024 * sizeof(int);
+    size_t base = tracker->live_bytes();
+    tracker->SetBudget(base + 2 * size, BudgetPolicy::FailFast);
+
+    cl::Buffer a = queue.CreateBuffer<int>(1024, CL_MEM_READ_WRITE);
+    cl::Buffer b = queue.CreateBuffer<int>(1024, CL_MEM_READ_WRITE);
+    ASSERT_THROW(queue.CreateBuffer<int>(1024, CL_MEM_READ_WRITE), cl::Error);
+
+    // recycled buffer is reused without new allocation
+    queue.RecycleBuffer(b);
+    EXPECT_EQ(size, tracker->cached_bytes());
+    cl::Buffer c = queue.CreateBuffer<int>(1024, CL_MEM_READ_WRITE);
+    EXPECT_EQ(b(), c());
+    EXPECT_EQ(0U, tracker->cached_bytes());
+
+    // cached buffer is evicted to satisfy the budget
+    queue.RecycleBuffer(c);
+    tracker->SetBudget(tracker->budget(), BudgetPolicy::EvictCache);
+    cl::Buffer d = queue.CreateBuffer<int>(1024, CL_MEM_READ_ONLY);
+    EXPECT_EQ(0U, tracker->cached_bytes());
+    // evicted buffer is still referenced by b and c, so it's accounted
+    EXPECT_EQ(base + 3 * size, tracker->live_bytes());
+
+    // buffer is placed in host memory when budget is exceeded
+    tracker->SetBudget(tracker->budget(), BudgetPolicy::SpillToHost);
+    cl::Buffer spilled = queue.CreateBuffer<int>(1024, CL_MEM_READ_WRITE);
+    EXPECT_EQ(size, tracker->spilled_bytes());
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
+
+TEST(Queue, ConcurrentBudget) {
+  using oclalgo::BudgetPolicy;
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    oclalgo::MemoryTracker* tracker = queue.memory_tracker();
+    size_t size = 1024 * sizeof(int);
+    tracker->SetBudget(tracker->live_bytes() + 4 * size,
+                       BudgetPolicy::FailFast);
+    // allocations in progress are counted against the budget
+    const int threads = 8;
+    std::vector<cl::Buffer> buffers(threads);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) {
+      workers.emplace_back([&queue, &buffers, i]() {
+        try {
+          buffers[i] = queue.CreateBuffer<int>(1024, CL_MEM_READ_WRITE);
+        } catch (const cl::Error&) {
+        }
+      });
+    }
+    for (std::thread& worker : workers)
+      worker.join();
+    int allocated = 0;
+    for (const cl::Buffer& buffer : buffers)
+      allocated += buffer() != nullptr;
+    EXPECT_EQ(4, allocated);
+    EXPECT_LE(tracker->live_bytes(), tracker->budget());
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
+
+TEST(Queue, SvmVectorAdd) {
+  using oclalgo::ArgType;
+  using oclalgo::SvmArg;
+  using oclalgo::SvmMode;
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    int size = 1024;
+    oclalgo::shared_array<int> a = queue.CreateSvmArray<int>(size);
+    oclalgo::shared_array<int> b = queue.CreateSvmArray<int>(size);
+    oclalgo::shared_array<int> c = queue.CreateSvmArray<int>(size);
+    queue.MapSvm(a, CL_MAP_WRITE);
+    queue.MapSvm(b, CL_MAP_WRITE);
+    for (int i = 0; i < size; ++i) {
+      a[i] = i;
+      b[i] = size - i;
+    }
+    queue.UnmapSvm(a);
+    queue.UnmapSvm(b);
+
+    // on OpenCL 1.x devices arguments are passed through buffers
+    SvmArg a_arg = queue.CreateSvmArg(a, ArgType::IN);
+    SvmArg b_arg = queue.CreateSvmArg(b, ArgType::IN);
+    SvmArg c_arg = queue.CreateSvmArg(c, ArgType::OUT);
+    oclalgo::Task task = queue.CreateTask("vector.cl", "vector_add", "",
+                                          a_arg, b_arg, c_arg);
+    auto future = queue.EnqueueTask(task, oclalgo::Grid(cl::NDRange(size)));
+    oclalgo::TaskResult output = future.get();
+    if (queue.svm_mode() == SvmMode::None)
+      queue.memcpy(c, output[0]);
+    else
+      ASSERT_TRUE(output.empty());
+
+    queue.MapSvm(c, CL_MAP_READ);
+    for (int i = 0; i < size; ++i)
+      ASSERT_EQ(size, c[i]);
+    queue.UnmapSvm(c);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
+
+TEST(Queue, CompressedTransfer) {
+  using oclalgo::CodecScheme;
+  try {
+    oclalgo::Queue queue(platform_name, device_name);
+    oclalgo::CompressedTransfer transfer(&queue);
+    int size = 100000;
+    oclalgo::shared_array<int> sparse(size), small(size);
+    for (int i = 0; i < size; ++i) {
+      sparse[i] = i % 16 == 0 ? i : 0;
+      small[i] = i % 1000 - 500;
+    }
+
+    cl::Buffer buffer = queue.CreateBuffer<int>(size, CL_MEM_READ_WRITE);
+    transfer.Upload(cl::Buffer(buffer), sparse).wait();
+    EXPECT_EQ(CodecScheme::ZeroBitmap, transfer.last_scheme());
+    EXPECT_GT(sparse.memsize(), transfer.last_bytes());
+    oclalgo::shared_array<int> result(size);
+    queue.memcpy(result, buffer);
+    ASSERT_TRUE(sparse == result);
+
+    transfer.Upload(cl::Buffer(buffer), small).wait();
+    EXPECT_EQ(CodecScheme::BitPack, transfer.last_scheme());
+    transfer.Download(result, buffer);
+    EXPECT_EQ(CodecScheme::BitPack, transfer.last_scheme());
+    EXPECT_GT(small.memsize(), transfer.last_bytes());
+    ASSERT_TRUE(small == result);
+  } catch (const cl::Error& e) {
+    std::cerr << e.what() << " (err_code = "
+              << oclalgo::Queue::StatusStr(e.err()) << ")" << std::endl;
+    throw e;
+  }
+}
@@ -0,0 +1,93 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file shared_array.cc
+ *  @brief Unit tests for oclalgo::shared_array class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+#include "inc/oclalgo/shared_array.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::RefCount;
+using oclalgo::shared_array;
+
+TEST(SharedArray, InlineStorage) {
+  for (RefCount mode : { RefCount::Atomic, RefCount::NonAtomic }) {
+    shared_array<double> a(1000, mode);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(a.data()) % 64);
+    EXPECT_EQ(1000u, a.size());
+    EXPECT_EQ(a.data() + a.size(), a.end());
+    std::iota(a.begin(), a.end(), 0.0);
+    {
+      shared_array<double> b = a;
+      shared_array<const double> c = b;
+      EXPECT_EQ(3, a.use_count());
+      std::shared_ptr<double> sp = a.get();
+      EXPECT_EQ(4, a.use_count());
+      EXPECT_EQ(a.data(), sp.get());
+      EXPECT_EQ(999.0, c[999]);
+    }
+    EXPECT_TRUE(a.unique());
+    shared_array<double> moved = std::move(a);
+    EXPECT_FALSE(a);
+    EXPECT_EQ(0, a.use_count());
+    EXPECT_EQ(1, moved.use_count());
+  }
+}
+
+TEST(SharedArray, Ownership) {
+  std::shared_ptr<int> sp(new int[4], std::default_delete<int[]>());
+  {
+    shared_array<int> a(sp, 4);
+    EXPECT_EQ(2, sp.use_count());
+    a.reset(new int[8], 8);
+    EXPECT_EQ(8u, a.size());
+  }
+  EXPECT_TRUE(sp.unique());
+
+  // elements of non-trivial types are constructed and destroyed
+  shared_array<std::string> s(3);
+  s[2] = std::string(100, 'x');
+  shared_array<std::string> copy = s;
+  s.reset();
+  EXPECT_EQ(100u, copy[2].size());
+  EXPECT_TRUE(copy[0].empty());
+}
@@ -0,0 +1,198 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file solvers.cc
+ *  @brief Unit tests for Krylov solvers.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/solvers.h"
+#include "src/gtest_main.cc"
+
+namespace {
+
+struct Csr {
+  std::vector<int> row_ptr;
+  std::vector<int> col_idx;
+  std::vector<double> values;
+
+  void Add(int col, double value) {
+    col_idx.push_back(col);
+    values.push_back(value);
+  }
+};
+
+// 5-point Laplacian of n x n grid plus <shift> * (forward difference along
+// x), symmetric positive definite for zero shift
+Csr Poisson2D(int n, double shift) {
+  Csr a;
+  a.row_ptr.push_back(0);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      int row = i * n + j;
+      if (i > 0) a.Add(row - n, -1.0);
+      if (j > 0) a.Add(row - 1, -1.0 - shift);
+      a.Add(row, 4.0 + shift);
+      if (j < n - 1) a.Add(row + 1, -1.0);
+      if (i < n - 1) a.Add(row + n, -1.0);
+      a.row_ptr.push_back(static_cast<int>(a.values.size()));
+    }
+  }
+  return a;
+}
+
+oclalgo::Matrix<double> Dense(const Csr& a) {
+  int n = static_cast<int>(a.row_ptr.size()) - 1;
+  oclalgo::Matrix<double> m(n, n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j)
+      m(i, j) = 0.0;
+    for (int e = a.row_ptr[i]; e < a.row_ptr[i + 1]; ++e)
+      m(i, a.col_idx[e]) = a.values[e];
+  }
+  return m;
+}
+
+oclalgo::Matrix<double> Zeros(int n) {
+  oclalgo::Matrix<double> m(n, 1);
+  for (int i = 0; i < n; ++i)
+    m(i, 0) = 0.0;
+  return m;
+}
+
+oclalgo::Matrix<double> RightSide(int n) {
+  oclalgo::Matrix<double> b(n, 1);
+  for (int i = 0; i < n; ++i)
+    b(i, 0) = 1.0 + (i % 7) * 0.25;
+  return b;
+}
+
+// relative residual |b - A x| / |b| computed on host
+double Residual(const Csr& a, const oclalgo::Matrix<double>& b,
+                const oclalgo::Matrix<double>& x) {
+  double rr = 0.0, bb = 0.0;
+  for (size_t i = 0; i + 1 < a.row_ptr.size(); ++i) {
+    double ax = 0.0;
+    for (int e = a.row_ptr[i]; e < a.row_ptr[i + 1]; ++e)
+      ax += a.values[e] * x(a.col_idx[e], 0);
+    int row = static_cast<int>(i);
+    rr += (b(row, 0) - ax) * (b(row, 0) - ax);
+    bb += b(row, 0) * b(row, 0);
+  }
+  return std::sqrt(rr / bb);
+}
+
+}  // namespace
+
+TEST(Solvers, ConjugateGradientCsr) {
+  int n = 32;
+  Csr a = Poisson2D(n, 0.0);
+  auto op = oclalgo::CsrOperator<double>::FromHost(a.row_ptr, a.col_idx,
+                                                   a.values);
+  oclalgo::Matrix<double> b = RightSide(n * n);
+  // device matrices use data of host ones, which must outlive them
+  oclalgo::Matrix<double> x0 = Zeros(n * n);
+  oclalgo::DMatrix<double> x(x0);
+  oclalgo::SolverOptions options;
+  options.tolerance = 1e-10;
+  oclalgo::SolverResult result = oclalgo::ConjugateGradient(
+      op, oclalgo::DMatrix<double>(b), &x, options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_LE(result.residual, options.tolerance);
+  // CG converges in at most n iterations, checks add up to check_every
+  EXPECT_LE(result.iterations, n * n + 2 * options.check_every);
+  EXPECT_LT(Residual(a, b, x.ToHost()), 1e-8);
+}
+
+TEST(Solvers, ConjugateGradientDense) {
+  int n = 12;
+  Csr a = Poisson2D(n, 0.0);
+  oclalgo::Matrix<double> dense = Dense(a), x0 = Zeros(n * n);
+  oclalgo::DMatrix<double> m(dense);
+  oclalgo::DenseOperator<double> op(m);
+  oclalgo::Matrix<double> b = RightSide(n * n);
+  oclalgo::DMatrix<double> x(x0);
+  oclalgo::SolverOptions options;
+  options.tolerance = 1e-10;
+  options.check_every = 1;
+  oclalgo::SolverResult result = oclalgo::ConjugateGradient(
+      op, oclalgo::DMatrix<double>(b), &x, options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_LT(Residual(a, b, x.ToHost()), 1e-8);
+}
+
+TEST(Solvers, BiCgStab) {
+  int n = 24;
+  Csr a = Poisson2D(n, 0.5);
+  oclalgo::Matrix<double> b = RightSide(n * n);
+  oclalgo::SolverOptions options;
+  options.tolerance = 1e-9;
+
+  auto csr = oclalgo::CsrOperator<double>::FromHost(a.row_ptr, a.col_idx,
+                                                    a.values);
+  oclalgo::Matrix<double> x0 = Zeros(n * n), y0 = Zeros(n * n);
+  oclalgo::DMatrix<double> x(x0);
+  oclalgo::SolverResult result = oclalgo::BiCgStab(
+      csr, oclalgo::DMatrix<double>(b), &x, options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_LT(Residual(a, b, x.ToHost()), 1e-7);
+
+  oclalgo::Matrix<double> host_dense = Dense(a);
+  oclalgo::DMatrix<double> m(host_dense);
+  oclalgo::DenseOperator<double> dense(m);
+  oclalgo::DMatrix<double> y(y0);
+  result = oclalgo::BiCgStab(dense, oclalgo::DMatrix<double>(b), &y, options);
+  EXPECT_TRUE(result.converged);
+  EXPECT_LT(Residual(a, b, y.ToHost()), 1e-7);
+}
+
+TEST(Solvers, ExactInitialGuess) {
+  int n = 8;
+  Csr a = Poisson2D(n, 0.0);
+  auto op = oclalgo::CsrOperator<double>::FromHost(a.row_ptr, a.col_idx,
+                                                   a.values);
+  oclalgo::Matrix<double> b0 = Zeros(n * n), x0 = Zeros(n * n);
+  oclalgo::DMatrix<double> b(b0);
+  oclalgo::DMatrix<double> x(x0);
+  oclalgo::SolverResult result = oclalgo::ConjugateGradient(op, b, &x);
+  EXPECT_TRUE(result.converged);
+  EXPECT_EQ(0, result.iterations);
+}
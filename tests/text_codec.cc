@@ -0,0 +1,202 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file text_codec.cc
+ *  @brief Unit tests for CSV/TSV matrix parsing and formatting.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/text_codec.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::Matrix;
+using oclalgo::TextFormat;
+
+TEST(TextCodec, Parse) {
+  Matrix<double> m = oclalgo::ParseText<double>(
+      "1, 2.5, -3e2\r\n\n0.1,1e-5,+7\n");
+  ASSERT_EQ(2, m.rows());
+  ASSERT_EQ(3, m.cols());
+  EXPECT_EQ(1.0, m(0, 0));
+  EXPECT_EQ(2.5, m(0, 1));
+  EXPECT_EQ(-300.0, m(0, 2));
+  EXPECT_EQ(0.1, m(1, 0));
+  EXPECT_EQ(1e-5, m(1, 1));
+  EXPECT_EQ(7.0, m(1, 2));
+
+  // slow path: long mantissas, large exponents, special values
+  Matrix<double> slow = oclalgo::ParseText<double>(
+      "3.14159265358979323846,1e300,-inf\n");
+  EXPECT_EQ(3.14159265358979323846, slow(0, 0));
+  EXPECT_EQ(1e300, slow(0, 1));
+  EXPECT_TRUE(std::isinf(slow(0, 2)));
+
+  // exponents out of exact range (overflow, underflow, subnormals)
+  Matrix<double> range = oclalgo::ParseText<double>(
+      "1e100000,-1e-99999,1e30,1e-40\n");
+  EXPECT_TRUE(std::isinf(range(0, 0)));
+  EXPECT_EQ(0.0, range(0, 1));
+  EXPECT_TRUE(std::signbit(range(0, 1)));
+  EXPECT_EQ(1e30, range(0, 2));
+  EXPECT_EQ(1e-40, range(0, 3));
+  Matrix<float> float_range = oclalgo::ParseText<float>("1e30,1e-40\n");
+  EXPECT_EQ(1e30F, float_range(0, 0));
+  EXPECT_EQ(1e-40F, float_range(0, 1));
+
+  TextFormat tsv;
+  tsv.delimiter = '\t';
+  Matrix<int> ints = oclalgo::ParseText<int>("1\t-2\n-2147483648\t4", tsv);
+  EXPECT_EQ(-2, ints(0, 1));
+  EXPECT_EQ(std::numeric_limits<int>::min(), ints(1, 0));
+  EXPECT_EQ(4, ints(1, 1));
+}
+
+TEST(TextCodec, Errors) {
+  EXPECT_THROW(oclalgo::ParseText<float>("1,2\n3\n"), std::runtime_error);
+  EXPECT_THROW(oclalgo::ParseText<float>("1,x\n"), std::runtime_error);
+  EXPECT_THROW(oclalgo::ParseText<float>("1;2\n"), std::runtime_error);
+  EXPECT_THROW(oclalgo::ParseText<int>("2147483648\n"), std::runtime_error);
+  EXPECT_THROW(oclalgo::ParseText<unsigned>("-1\n"), std::runtime_error);
+  try {
+    oclalgo::ParseText<int>("1,2\n\n3,4\n5\n");
+    FAIL();
+  } catch(const std::runtime_error& e) {
+    EXPECT_NE(std::string::npos, std::string(e.what()).find("line 4"));
+  }
+}
+
+TEST(TextCodec, RoundTrip) {
+  Matrix<float> m(3, 4);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+      m(i, j) = std::ldexp(1.0F / (i + j + 3), i - j) * (j % 2 ? -1 : 1);
+  m(0, 0) = 42.0F;
+  m(2, 3) = std::numeric_limits<float>::max();
+  std::string text = oclalgo::FormatText(m);
+  Matrix<float> parsed = oclalgo::ParseText<float>(text);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+      EXPECT_EQ(m(i, j), parsed(i, j));
+  EXPECT_EQ("42,", text.substr(0, 3));
+
+  // precision beyond max_digits10 is limited
+  Matrix<double> d(1, 2);
+  d(0, 0) = -std::numeric_limits<double>::denorm_min();
+  d(0, 1) = 1.0 / 3;
+  TextFormat format;
+  format.precision = 60;
+  Matrix<double> reparsed = oclalgo::ParseText<double>(
+      oclalgo::FormatText(d, format));
+  EXPECT_EQ(d(0, 0), reparsed(0, 0));
+  EXPECT_EQ(d(0, 1), reparsed(0, 1));
+}
+
+TEST(TextCodec, Locale) {
+  // slow paths don't depend on decimal separator of process locale (if
+  // such locale is installed)
+  std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+  bool changed = false;
+  for (const char* name : { "de_DE.UTF-8", "ru_RU.UTF-8", "fr_FR.UTF-8" }) {
+    if (std::setlocale(LC_NUMERIC, name) != nullptr) {
+      changed = true;
+      break;
+    }
+  }
+  if (!changed) return;
+  Matrix<double> m = oclalgo::ParseText<double>(
+      "1.5e300,0.1234567890123456789\n");
+  Matrix<double> third(1, 1);
+  third(0, 0) = 1.0 / 3;
+  TextFormat format;
+  format.precision = 5;
+  std::string text = oclalgo::FormatText(third, format);
+  std::setlocale(LC_NUMERIC, previous.c_str());
+  EXPECT_EQ(1.5e300, m(0, 0));
+  EXPECT_EQ(0.1234567890123456789, m(0, 1));
+  EXPECT_EQ("0.33333\n", text);
+}
+
+TEST(TextCodec, Stream) {
+  // enough rows to be parsed by several blocks and threads
+  const int rows = 200000;
+  Matrix<double> m(rows, 3);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < 3; ++j)
+      m(i, j) = i * 0.25 - j;
+  std::string path = "/tmp/oclalgo_test_text.csv";
+  int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  ASSERT_LE(0, fd);
+  oclalgo::WriteText(fd, m);
+  ::close(fd);
+
+  fd = ::open(path.c_str(), O_RDONLY);
+  ASSERT_LE(0, fd);
+  Matrix<double> read = oclalgo::ReadText<double>(fd);
+  ::close(fd);
+  ASSERT_EQ(rows, read.rows());
+  ASSERT_EQ(3, read.cols());
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < 3; ++j)
+      ASSERT_EQ(m(i, j), read(i, j));
+  std::remove(path.c_str());
+
+  // pipe returns partial blocks which split lines
+  int fds[2];
+  ASSERT_EQ(0, ::pipe(fds));
+  std::thread writer([&m, fds]() {
+    oclalgo::WriteText(fds[1], m);
+    ::close(fds[1]);
+  });
+  Matrix<double> piped = oclalgo::ReadText<double>(fds[0]);
+  writer.join();
+  ::close(fds[0]);
+  ASSERT_EQ(rows, piped.rows());
+  for (int i = 0; i < rows; ++i)
+    ASSERT_EQ(m(i, 2), piped(i, 2));
+}
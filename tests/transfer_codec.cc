@@ -0,0 +1,109 @@
+/*!
+ * Copyright (c) 2014, Samsung Electronics Co.,Ltd.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation are those
+ * of the authors and should not be interpreted as representing official policies,
+ * either expressed or implied, of Samsung Electronics Co.,Ltd..
+ *
+ * OCLAlgo - Framework based on C++11 and OpenCL API to provide simple access
+ *           to OpenCL devices for asynchronous calculations.
+ * URL:      https://github.com/seninds/OCLAlgo
+ */
+
+/*! @file transfer_codec.cc
+ *  @brief Unit tests for oclalgo::TransferCodec class.
+ *  @author Senin Dmitry <d.senin@samsung.com>
+ *  @version 1.0
+ *
+ *  @section Copyright
+ *  Copyright 2013 Samsung R&D Institute Russia
+ */
+
+#include <gtest/gtest.h>
+#include "inc/oclalgo/transfer_codec.h"
+#include "src/gtest_main.cc"
+
+using oclalgo::CodecScheme;
+using oclalgo::TransferCodec;
+using oclalgo::shared_array;
+
+template <typename T>
+void CheckRoundTrip(const shared_array<T>& data, CodecScheme scheme) {
+  shared_array<uint32_t> encoded = TransferCodec<T>::Encode(data.get_raw(),
+                                                            data.size(),
+                                                            scheme);
+  shared_array<T> decoded(data.size());
+  TransferCodec<T>::Decode(encoded.get_raw(), data.size(), scheme,
+                           decoded.get_raw());
+  for (size_t i = 0; i < data.size(); ++i)
+    ASSERT_EQ(data[i], decoded[i]);
+}
+
+TEST(TransferCodec, ZeroBitmap) {
+  int size = 1000;
+  shared_array<float> data(size);
+  for (int i = 0; i < size; ++i)
+    data[i] = i % 7 == 0 ? 0.5f * i : 0.0f;
+  CheckRoundTrip(data, CodecScheme::ZeroBitmap);
+
+  shared_array<uint32_t> encoded = TransferCodec<float>::Encode(
+      data.get_raw(), size, CodecScheme::ZeroBitmap);
+  // 32 groups: bitmap, offsets, 142 non-zero values and padding
+  EXPECT_EQ(2 * 32 + 142 + 1, static_cast<int>(encoded.size()));
+  EXPECT_EQ(CodecScheme::ZeroBitmap,
+            TransferCodec<float>::Choose(data.get_raw(), size));
+}
+
+TEST(TransferCodec, BitPack) {
+  int size = 1003;
+  shared_array<int> data(size);
+  for (int i = 0; i < size; ++i)
+    data[i] = i % 100 - 50;
+  CheckRoundTrip(data, CodecScheme::BitPack);
+
+  shared_array<uint32_t> encoded = TransferCodec<int>::Encode(
+      data.get_raw(), size, CodecScheme::BitPack);
+  EXPECT_EQ(static_cast<uint32_t>(-50), encoded[0]);
+  EXPECT_EQ(7u, encoded[1]);
+  EXPECT_EQ(CodecScheme::BitPack,
+            TransferCodec<int>::Choose(data.get_raw(), size));
+
+  // full range and constant data
+  data[0] = std::numeric_limits<int>::min();
+  data[1] = std::numeric_limits<int>::max();
+  CheckRoundTrip(data, CodecScheme::BitPack);
+  for (int i = 0; i < size; ++i)
+    data[i] = 42;
+  CheckRoundTrip(data, CodecScheme::BitPack);
+}
+
+TEST(TransferCodec, Raw) {
+  int size = 4096;
+  shared_array<unsigned> data(size);
+  for (int i = 0; i < size; ++i)
+    data[i] = 2654435761u * (i + 1);
+  EXPECT_EQ(CodecScheme::Raw,
+            TransferCodec<unsigned>::Choose(data.get_raw(), size));
+  CheckRoundTrip(data, CodecScheme::BitPack);
+}